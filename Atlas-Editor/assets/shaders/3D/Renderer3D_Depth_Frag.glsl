@@ -0,0 +1,12 @@
+//--------------------------
+// - Atlas 3D -
+// Renderer Depth Pre-Pass Fragment Shader
+// --------------------------
+
+#version 450 core
+
+// Depth only: color writes are masked during the pre-pass
+
+void main()
+{
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+//--------------------------
+// - Atlas 3D -
+// Renderer Depth Pre-Pass Vertex Shader
+// --------------------------
+
+#version 450 core
+
+/* ------------------------------ */
+/* ----------- INPUTS ----------- */
+/* ------------------------------ */
+
+layout (location = 0) in uint a_ObjectIndex; // Per instance
+layout (location = 1) in vec4 a_Position;    // Position stream only
+
+layout (std140, binding = 1) uniform Camera
+{
+	mat4 u_ViewProjection;
+	mat4 u_Projection;
+	mat4 u_View;
+	vec3 u_CameraPosition;
+};
+
+struct ObjectData
+{
+	mat4 Model;
+	mat4 NormalMatrix;
+	vec4 PositionOffset;
+	vec4 PositionScale;
+	int  MaterialIndex;
+	int  EntityID;
+};
+
+layout (std430, binding = 1) readonly buffer Objects
+{
+	ObjectData u_Objects[];
+};
+
+/* ------------------------------ */
+/* ----------- OUTPUTS ---------- */
+/* ------------------------------ */
+
+// The G-Buffer pass tests its depth for equality against this one: both compute it with the same operations
+invariant gl_Position;
+
+void main()
+{
+	ObjectData object = u_Objects[a_ObjectIndex];
+
+	vec3 position      = object.PositionOffset.xyz + object.PositionScale.xyz * a_Position.xyz;
+	vec4 worldPosition = object.Model * vec4(position, 1.0);
+
+	gl_Position = u_ViewProjection * worldPosition;
+}
\ No newline at end of file
@@ -13,14 +13,14 @@ layout (location = 0)   in flat int   v_EntityID;
 layout (location = 1)   in      vec3  v_Position;
 layout (location = 2)   in      vec3  v_Normal;
 layout (location = 3)   in      vec2  v_TexCoord;
-layout (location = 4)   in      vec3  v_Color;
+layout (location = 4)   in      vec4  v_Color;
 layout (location = 5)   in      float v_Metallic;
 layout (location = 6)   in      float v_Roughness;
 layout (location = 7)   in      mat3  v_TBN;
-layout (location = 10)  in flat vec3  v_Albedo_Normal_Metallic_TexIndex;    // X: Albedo,    Y: Normal, Z: Metallic
-layout (location = 11)  in flat vec3  v_Roughness_AO_Displacement_TexIndex; // X: Roughness, Y: AO,     Z: Displacement
+layout (location = 10)  in flat ivec3 v_Albedo_Normal_Metallic_TexIndex;    // X: Albedo,    Y: Normal, Z: Metallic
+layout (location = 11)  in flat ivec3 v_Roughness_AO_Displacement_TexIndex; // X: Roughness, Y: AO,     Z: Displacement
 
-layout (binding = 0) uniform sampler2D u_Textures[32];
+layout (binding = 0) uniform sampler2DArray u_TextureArrays[32];
 
 layout (std140, binding = 0) uniform Settings
 {
@@ -51,6 +51,7 @@ layout (location = 5) out vec4 o_Metallic_Roughness_AO; // R: Metallic, G: Rough
 /* ----- METHOD DEFINITIONS ----- */
 /* ------------------------------ */
 
+vec4  SampleTexture(int texIndex, vec2 texCoord);
 vec2  GetFinalTexCoords();
 vec4  GetAlbedoOutput(vec2 texCoord);
 vec3  GetNormalOutput(vec2 texCoord);
@@ -81,7 +82,13 @@ void main()
 /* --- METHOD IMPLEMENTATIONS --- */
 /* ------------------------------ */
 
-vec2 ParallaxMapping(uint displacementTexIndex, vec2 texCoord, vec3 viewDirection)
+vec4 SampleTexture(int texIndex, vec2 texCoord)
+{
+	// Texture index: (array slot << 16) | layer
+	return texture(u_TextureArrays[texIndex >> 16], vec3(texCoord, float(texIndex & 0xFFFF)));
+}
+
+vec2 ParallaxMapping(int displacementTexIndex, vec2 texCoord, vec3 viewDirection)
 {
     const float minLayers = 8.0;
 	const float maxLayers = 32.0;
@@ -94,19 +101,19 @@ vec2 ParallaxMapping(uint displacementTexIndex, vec2 texCoord, vec3 viewDirectio
     vec2 deltaTexCoord = P / numLayers;
 
 	vec2  currentTexCoord      = texCoord;
-	float currentDepthMapValue = 1.0 - texture(u_Textures[displacementTexIndex], currentTexCoord).r;
+	float currentDepthMapValue = 1.0 - SampleTexture(displacementTexIndex, currentTexCoord).r;
   
 	while(currentLayerDepth < currentDepthMapValue)
 	{
 		currentTexCoord -= deltaTexCoord;
-		currentDepthMapValue = 1.0 - texture(u_Textures[displacementTexIndex], currentTexCoord).r;
+		currentDepthMapValue = 1.0 - SampleTexture(displacementTexIndex, currentTexCoord).r;
 		currentLayerDepth += layerDepth;
 	}
 
 	vec2 prevTexCoord = currentTexCoord + deltaTexCoord;
 
 	float afterDepth  = currentDepthMapValue - currentLayerDepth;
-	float beforeDepth = 1.0 - texture(u_Textures[displacementTexIndex], prevTexCoord).r - currentLayerDepth + layerDepth;
+	float beforeDepth = 1.0 - SampleTexture(displacementTexIndex, prevTexCoord).r - currentLayerDepth + layerDepth;
 
 	float weight = afterDepth / (afterDepth - beforeDepth);
 	vec2 finalTexCoord = prevTexCoord * weight + currentTexCoord * (1.0 - weight);
@@ -118,7 +125,7 @@ vec2 GetFinalTexCoords()
 {
 	vec2 texCoord = v_TexCoord;
 
-	uint displacementTexIndex = uint(v_Roughness_AO_Displacement_TexIndex.z);
+	int displacementTexIndex = v_Roughness_AO_Displacement_TexIndex.z;
 
 	if(displacementTexIndex != 0)
 	{
@@ -136,7 +143,7 @@ vec2 GetFinalTexCoords()
 
 vec4 GetAlbedoOutput(vec2 texCoord)
 {
-	vec4 diffuseColor = texture(u_Textures[int(v_Albedo_Normal_Metallic_TexIndex.x)], texCoord);
+	vec4 diffuseColor = SampleTexture(v_Albedo_Normal_Metallic_TexIndex.x, texCoord);
 
 	if (diffuseColor.a == 0.0)
 	{
@@ -152,11 +159,11 @@ vec3 GetNormalOutput(vec2 texCoord)
 {
 	vec3 vertexNormal = normalize(v_Normal);
 
-	int normalTexIndex = int(v_Albedo_Normal_Metallic_TexIndex.y);
+	int normalTexIndex = v_Albedo_Normal_Metallic_TexIndex.y;
 
 	if(normalTexIndex != 0)
 	{
-		vec3 normalMap = texture(u_Textures[normalTexIndex], texCoord).rgb;
+		vec3 normalMap = SampleTexture(normalTexIndex, texCoord).rgb;
 		vertexNormal = normalMap * 2.0 - 1.0;
 		vertexNormal = normalize(v_TBN * vertexNormal);
 	}
@@ -168,11 +175,11 @@ float GetMetallicOutput(vec2 texCoord)
 {
 	float metallic = v_Metallic;
 
-	int metallicTexIndex = int(v_Albedo_Normal_Metallic_TexIndex.z);
+	int metallicTexIndex = v_Albedo_Normal_Metallic_TexIndex.z;
 
 	if(metallicTexIndex != 0)
 	{
-		metallic = texture(u_Textures[metallicTexIndex], texCoord).r;
+		metallic = SampleTexture(metallicTexIndex, texCoord).r;
 	}
 
 	return metallic;
@@ -182,11 +189,11 @@ float GetRoughnessOutput(vec2 texCoord)
 {
 	float roughness = v_Roughness;
 
-	int roughnessTexIndex = int(v_Roughness_AO_Displacement_TexIndex.x);
+	int roughnessTexIndex = v_Roughness_AO_Displacement_TexIndex.x;
 
 	if(roughnessTexIndex != 0)
 	{
-		roughness = texture(u_Textures[roughnessTexIndex], texCoord).r;
+		roughness = SampleTexture(roughnessTexIndex, texCoord).r;
 	}
 
 	return roughness;
@@ -196,11 +203,11 @@ float GetAOOutput(vec2 texCoord)
 {
 	float ao = 1.0;
 
-	int aoTexIndex = int(v_Roughness_AO_Displacement_TexIndex.y);
+	int aoTexIndex = v_Roughness_AO_Displacement_TexIndex.y;
 
 	if(aoTexIndex != 0)
 	{
-		ao = texture(u_Textures[aoTexIndex], texCoord).r;
+		ao = SampleTexture(aoTexIndex, texCoord).r;
 	}
 
 	return ao;
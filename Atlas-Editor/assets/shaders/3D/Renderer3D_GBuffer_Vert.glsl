@@ -9,21 +9,14 @@
 /* ----------- INPUTS ----------- */
 /* ------------------------------ */
 
-layout(location = 0)  in vec4 a_Position_ID;                        // XYZ: Position, W: EntityID (editor-only)
-layout(location = 1)  in vec3 a_Normal;
-layout(location = 2)  in vec2 a_TexCoord;
-layout(location = 3)  in vec3 a_Tangent;
-layout(location = 4)  in vec3 a_Bitangent;
+layout (location = 0) in uint a_ObjectIndex; // Per instance
+layout (location = 1) in vec4 a_Position;    // Compressed: w is the bitangent sign (0 = negative)
+layout (location = 2) in vec3 a_Normal;      // Compressed: octahedral (xy)
+layout (location = 3) in vec2 a_TexCoord;
+layout (location = 4) in vec3 a_Tangent;     // Compressed: octahedral (xy)
+layout (location = 5) in vec3 a_Bitangent;   // Compressed: not provided
 
-layout(location = 5)  in mat4 a_Model;
-
-layout(location = 9)  in vec3 a_Color;
-layout(location = 10) in vec2 a_Metallic_Roughness;                 // X: Metallic,  Y: Roughness
-
-layout(location = 11) in vec3 a_Albedo_Normal_Metallic_TexIndex;    // X: Albedo,    Y: Normal, Z: Metallic
-layout(location = 12) in vec3 a_Roughness_AO_Displacement_TexIndex; // X: Roughness, Y: AO,     Z: Displacement
-
-layout (binding = 0) uniform sampler2D u_Textures[32];
+layout (binding = 0) uniform sampler2DArray u_TextureArrays[32];
 
 layout (std140, binding = 1) uniform Camera
 {
@@ -33,6 +26,39 @@ layout (std140, binding = 1) uniform Camera
 	vec3 u_CameraPosition;
 };
 
+struct ObjectData
+{
+	mat4 Model;
+	mat4 NormalMatrix;
+	vec4 PositionOffset; // w: 1 if normals and tangents are octahedral-encoded
+	vec4 PositionScale;
+	int  MaterialIndex;
+	int  EntityID;
+};
+
+struct MaterialData
+{
+	vec4  Color;
+	float Metallic;
+	float Roughness;
+	int   AlbedoTexIndex; // Texture indices: (array slot << 16) | layer, 0 = none
+	int   NormalTexIndex;
+	int   MetallicTexIndex;
+	int   RoughnessTexIndex;
+	int   AOTexIndex;
+	int   DisplacementTexIndex;
+};
+
+layout (std430, binding = 1) readonly buffer Objects
+{
+	ObjectData u_Objects[];
+};
+
+layout (std430, binding = 2) readonly buffer Materials
+{
+	MaterialData u_Materials[];
+};
+
 /* ------------------------------ */
 /* ----------- OUTPUTS ---------- */
 /* ------------------------------ */
@@ -41,12 +67,21 @@ layout (location = 0)   out flat int   v_EntityID;
 layout (location = 1)   out      vec3  v_Position;
 layout (location = 2)   out      vec3  v_Normal;
 layout (location = 3)   out      vec2  v_TexCoord;
-layout (location = 4)   out      vec3  v_Color;
+layout (location = 4)   out      vec4  v_Color; // a: opacity
 layout (location = 5)   out      float v_Metallic;
 layout (location = 6)   out      float v_Roughness;
 layout (location = 7)   out      mat3  v_TBN;
-layout (location = 10)  out flat vec3  v_Albedo_Normal_Metallic_TexIndex;
-layout (location = 11)  out flat vec3  v_Roughness_AO_Displacement_TexIndex;
+layout (location = 10)  out flat ivec3 v_Albedo_Normal_Metallic_TexIndex;
+layout (location = 11)  out flat ivec3 v_Roughness_AO_Displacement_TexIndex;
+
+// Must match the depth pre-pass exactly, its depth is tested for equality
+invariant gl_Position;
+
+/* ------------------------------ */
+/* ----- METHOD DEFINITIONS ----- */
+/* ------------------------------ */
+
+vec3 OctahedralDecode(vec2 encoded);
 
 /* ------------------------------ */
 /* ------------ MAIN ------------ */
@@ -54,22 +89,33 @@ layout (location = 11)  out flat vec3  v_Roughness_AO_Displacement_TexIndex;
 
 void main()
 {
-	v_EntityID                           = int(a_Position_ID.w);
+	ObjectData   object                  = u_Objects[a_ObjectIndex];
+	MaterialData material                = u_Materials[object.MaterialIndex];
+
+	bool compressed                      = object.PositionOffset.w != 0.0;
+	vec3 position                        = object.PositionOffset.xyz + object.PositionScale.xyz * a_Position.xyz;
+	vec3 normal                          = compressed ? OctahedralDecode(a_Normal.xy)  : a_Normal;
+	vec3 tangent                         = compressed ? OctahedralDecode(a_Tangent.xy) : a_Tangent;
+	vec3 bitangent                       = compressed ? cross(normal, tangent) * (a_Position.w * 2.0 - 1.0) : a_Bitangent;
+
+	vec4 worldPosition                   = object.Model * vec4(position, 1.0);
+
+	v_EntityID                           = object.EntityID;
 
-	v_Position                           = a_Position_ID.xyz;
-	v_Normal                             = a_Normal;
+	v_Position                           = worldPosition.xyz;
+	v_Normal                             = mat3(object.NormalMatrix) * normal;
 	v_TexCoord                           = a_TexCoord;
 
-	v_Color                              = a_Color;
-	v_Metallic                           = a_Metallic_Roughness.x;
-	v_Roughness                          = a_Metallic_Roughness.y;
+	v_Color                              = material.Color;
+	v_Metallic                           = material.Metallic;
+	v_Roughness                          = material.Roughness;
 
-	v_Albedo_Normal_Metallic_TexIndex    = a_Albedo_Normal_Metallic_TexIndex;
-	v_Roughness_AO_Displacement_TexIndex = a_Roughness_AO_Displacement_TexIndex;
+	v_Albedo_Normal_Metallic_TexIndex    = ivec3(material.AlbedoTexIndex,    material.NormalTexIndex, material.MetallicTexIndex);
+	v_Roughness_AO_Displacement_TexIndex = ivec3(material.RoughnessTexIndex, material.AOTexIndex,     material.DisplacementTexIndex);
 
-	vec3 T = normalize(a_Tangent);
-	vec3 B = normalize(a_Bitangent);
-	vec3 N = normalize(a_Normal);
+	vec3 T = normalize(mat3(object.Model) * tangent);
+	vec3 B = normalize(mat3(object.Model) * bitangent);
+	vec3 N = normalize(v_Normal);
 	// Re-orthogonalize T with respect to N (Gram-Schmidt)
 	T = normalize(T - dot(T, N) * N);
 	// Re-orthogonalize B with respect to N (Gram-Schmidt)
@@ -81,5 +127,23 @@ void main()
 
 	v_TBN = mat3(T, B, N);
 
-	gl_Position = u_ViewProjection * vec4(a_Position_ID.xyz, 1.0);
+	gl_Position = u_ViewProjection * worldPosition;
+}
+
+/* ------------------------------ */
+/* --- METHOD IMPLEMENTATIONS --- */
+/* ------------------------------ */
+
+vec3 OctahedralDecode(vec2 encoded)
+{
+	vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+	// Unfold the lower hemisphere
+	if (direction.z < 0.0)
+	{
+		vec2 signs    = vec2(direction.x >= 0.0 ? 1.0 : -1.0, direction.y >= 0.0 ? 1.0 : -1.0);
+		direction.xy = (1.0 - abs(direction.yx)) * signs;
+	}
+
+	return normalize(direction);
 }
\ No newline at end of file
@@ -9,9 +9,8 @@
 /* ----------- INPUTS ----------- */
 /* ------------------------------ */
 
-layout (location = 0) in vec3 a_Position;
-layout (location = 1) in vec4 a_Color;
-layout (location = 2) in int  a_EntityID;
+layout (location = 0) in uint a_ObjectIndex; // Per instance
+layout (location = 1) in vec4 a_Position;
 
 layout (std140, binding = 1) uniform Camera
 {
@@ -21,6 +20,39 @@ layout (std140, binding = 1) uniform Camera
 	vec3 u_CameraPosition;
 };
 
+struct ObjectData
+{
+	mat4 Model;
+	mat4 NormalMatrix;
+	vec4 PositionOffset;
+	vec4 PositionScale;
+	int  MaterialIndex;
+	int  EntityID;
+};
+
+struct MaterialData
+{
+	vec4  Color;
+	float Metallic;
+	float Roughness;
+	int   AlbedoTexIndex;
+	int   NormalTexIndex;
+	int   MetallicTexIndex;
+	int   RoughnessTexIndex;
+	int   AOTexIndex;
+	int   DisplacementTexIndex;
+};
+
+layout (std430, binding = 1) readonly buffer Objects
+{
+	ObjectData u_Objects[];
+};
+
+layout (std430, binding = 2) readonly buffer Materials
+{
+	MaterialData u_Materials[];
+};
+
 /* ------------------------------ */
 /* ----------- OUTPUTS ---------- */
 /* ------------------------------ */
@@ -30,8 +62,12 @@ layout (location = 1) out flat int  v_EntityID;
 
 void main()
 {
-	v_Color    = a_Color;
-	v_EntityID = a_EntityID;
+	ObjectData object = u_Objects[a_ObjectIndex];
+
+	v_Color    = u_Materials[object.MaterialIndex].Color;
+	v_EntityID = object.EntityID;
+
+	vec3 position = object.PositionOffset.xyz + object.PositionScale.xyz * a_Position.xyz;
 
-	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	gl_Position = u_ViewProjection * object.Model * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,356 @@
+//--------------------------
+// - Atlas 3D -
+// Renderer Transparent Fragment Shader (forward lit, blended over the shaded scene)
+// --------------------------
+
+#version 450 core
+
+/* ------------------------------ */
+/* ----------- STRUCTS ---------- */
+/* ------------------------------ */
+
+struct LightData
+{
+	vec4 Position;
+	vec4 Color;
+	vec4 Direction; // w is a flag to indicate if light direction is spot direction
+
+	float Intensity;
+	vec2 CutOffs; // (inner, outer); negative value means cutoff is disabled
+};
+
+/* ------------------------------ */
+/* ----------- INPUTS ----------- */
+/* ------------------------------ */
+
+layout (location = 0)   in flat int   v_EntityID;
+layout (location = 1)   in      vec3  v_Position;
+layout (location = 2)   in      vec3  v_Normal;
+layout (location = 3)   in      vec2  v_TexCoord;
+layout (location = 4)   in      vec4  v_Color;
+layout (location = 5)   in      float v_Metallic;
+layout (location = 6)   in      float v_Roughness;
+layout (location = 7)   in      mat3  v_TBN;
+layout (location = 10)  in flat ivec3 v_Albedo_Normal_Metallic_TexIndex;    // X: Albedo,    Y: Normal, Z: Metallic
+layout (location = 11)  in flat ivec3 v_Roughness_AO_Displacement_TexIndex; // X: Roughness, Y: AO,     Z: Displacement
+
+layout (binding = 0) uniform sampler2DArray u_TextureArrays[32];
+
+layout (std140, binding = 0) uniform Settings
+{
+	float u_Gamma;
+	float u_ParallaxScale;
+	float u_BloomThreshold;
+};
+
+layout (std140, binding = 1) uniform Camera
+{
+	mat4 u_ViewProjection;
+	mat4 u_Projection;
+	mat4 u_View;
+	vec3 u_CameraPosition;
+};
+
+layout (std140, binding = 2) uniform LightCount
+{
+	uint u_LightCount;
+};
+
+layout (std430, binding = 0) buffer Lights
+{
+	LightData u_Lights[];
+};
+
+/* ------------------------------ */
+/* ----------- OUTPUTS ---------- */
+/* ------------------------------ */
+
+layout (location = 0) out vec4 o_Color;
+layout (location = 1) out int  o_EntityID;
+
+/* ------------------------------ */
+/* ----- METHOD DEFINITIONS ----- */
+/* ------------------------------ */
+
+vec4  SampleTexture(int texIndex, vec2 texCoord);
+vec2  GetFinalTexCoords();
+vec4  GetAlbedoOutput(vec2 texCoord);
+vec3  GetNormalOutput(vec2 texCoord);
+float GetMetallicOutput(vec2 texCoord);
+float GetRoughnessOutput(vec2 texCoord);
+float GetAOOutput(vec2 texCoord);
+vec3  CalculateColor(vec3 vertexPosition, vec3 vertexNormal, vec3 albedo, float metallic, float roughness, float ambientOcclusion);
+
+/* ------------------------------ */
+/* ------------ MAIN ------------ */
+/* ------------------------------ */
+
+const float PI = 3.14159265359;
+const float AMBIENT_STRENGTH = 0.03; // No image based lighting here: the environment maps are bound by the deferred pass only
+
+void main()
+{
+	vec2 texCoord = GetFinalTexCoords();
+
+	vec4  albedo    = GetAlbedoOutput(texCoord);
+	vec3  normal    = GetNormalOutput(texCoord);
+	float metallic  = GetMetallicOutput(texCoord);
+	float roughness = GetRoughnessOutput(texCoord);
+	float ao        = GetAOOutput(texCoord);
+
+	vec3 fragmentColor = CalculateColor(v_Position, normal, albedo.rgb, metallic, roughness, ao);
+
+	o_Color    = vec4(fragmentColor, albedo.a * v_Color.a);
+	o_EntityID = v_EntityID;
+}
+
+/* ------------------------------ */
+/* --- METHOD IMPLEMENTATIONS --- */
+/* ------------------------------ */
+
+vec4 SampleTexture(int texIndex, vec2 texCoord)
+{
+	// Texture index: (array slot << 16) | layer
+	return texture(u_TextureArrays[texIndex >> 16], vec3(texCoord, float(texIndex & 0xFFFF)));
+}
+
+vec2 ParallaxMapping(int displacementTexIndex, vec2 texCoord, vec3 viewDirection)
+{
+    const float minLayers = 8.0;
+	const float maxLayers = 32.0;
+	float numLayers = mix(maxLayers, minLayers, max(dot(vec3(0.0, 0.0, 1.0), viewDirection), 0.0));
+
+    float layerDepth = 1.0 / numLayers;
+    float currentLayerDepth = 0.0;
+
+	vec2 P = viewDirection.xy * u_ParallaxScale; 
+    vec2 deltaTexCoord = P / numLayers;
+
+	vec2  currentTexCoord      = texCoord;
+	float currentDepthMapValue = 1.0 - SampleTexture(displacementTexIndex, currentTexCoord).r;
+  
+	while(currentLayerDepth < currentDepthMapValue)
+	{
+		currentTexCoord -= deltaTexCoord;
+		currentDepthMapValue = 1.0 - SampleTexture(displacementTexIndex, currentTexCoord).r;
+		currentLayerDepth += layerDepth;
+	}
+
+	vec2 prevTexCoord = currentTexCoord + deltaTexCoord;
+
+	float afterDepth  = currentDepthMapValue - currentLayerDepth;
+	float beforeDepth = 1.0 - SampleTexture(displacementTexIndex, prevTexCoord).r - currentLayerDepth + layerDepth;
+
+	float weight = afterDepth / (afterDepth - beforeDepth);
+	vec2 finalTexCoord = prevTexCoord * weight + currentTexCoord * (1.0 - weight);
+
+	return finalTexCoord;
+}
+
+vec2 GetFinalTexCoords()
+{
+	vec2 texCoord = v_TexCoord;
+
+	int displacementTexIndex = v_Roughness_AO_Displacement_TexIndex.z;
+
+	if(displacementTexIndex != 0)
+	{
+		vec3 viewDirection = normalize(transpose(v_TBN) * (u_CameraPosition - v_Position));
+		texCoord = ParallaxMapping(displacementTexIndex, v_TexCoord, viewDirection);
+	}
+
+	if(texCoord.x > 1.0 || texCoord.y > 1.0 || texCoord.x < 0.0 || texCoord.y < 0.0)
+	{
+		discard;
+	}
+
+	return texCoord;
+}
+
+vec4 GetAlbedoOutput(vec2 texCoord)
+{
+	vec4 diffuseColor = SampleTexture(v_Albedo_Normal_Metallic_TexIndex.x, texCoord);
+
+	if (diffuseColor.a == 0.0)
+	{
+		discard;
+	}
+
+	diffuseColor = vec4(pow(diffuseColor.rgb, vec3(u_Gamma)) * pow(v_Color.rgb, vec3(u_Gamma)), diffuseColor.a);
+
+	return diffuseColor;
+}
+
+vec3 GetNormalOutput(vec2 texCoord)
+{
+	vec3 vertexNormal = normalize(v_Normal);
+
+	int normalTexIndex = v_Albedo_Normal_Metallic_TexIndex.y;
+
+	if(normalTexIndex != 0)
+	{
+		vec3 normalMap = SampleTexture(normalTexIndex, texCoord).rgb;
+		vertexNormal = normalMap * 2.0 - 1.0;
+		vertexNormal = normalize(v_TBN * vertexNormal);
+	}
+
+	return vertexNormal;
+}
+
+float GetMetallicOutput(vec2 texCoord)
+{
+	float metallic = v_Metallic;
+
+	int metallicTexIndex = v_Albedo_Normal_Metallic_TexIndex.z;
+
+	if(metallicTexIndex != 0)
+	{
+		metallic = SampleTexture(metallicTexIndex, texCoord).r;
+	}
+
+	return metallic;
+}
+
+float GetRoughnessOutput(vec2 texCoord)
+{
+	float roughness = v_Roughness;
+
+	int roughnessTexIndex = v_Roughness_AO_Displacement_TexIndex.x;
+
+	if(roughnessTexIndex != 0)
+	{
+		roughness = SampleTexture(roughnessTexIndex, texCoord).r;
+	}
+
+	return roughness;
+}
+
+float GetAOOutput(vec2 texCoord)
+{
+	float ao = 1.0;
+
+	int aoTexIndex = v_Roughness_AO_Displacement_TexIndex.y;
+
+	if(aoTexIndex != 0)
+	{
+		ao = SampleTexture(aoTexIndex, texCoord).r;
+	}
+
+	return ao;
+}
+
+vec3 fresnelSchlick(float cosTheta, vec3 F0)
+{
+    return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+    float a      = roughness*roughness;
+    float a2     = a*a;
+    float NdotH  = max(dot(N, H), 0.0);
+    float NdotH2 = NdotH*NdotH;
+	
+    float num   = a2;
+    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+    denom = PI * denom * denom;
+	
+    return num / denom;
+}
+
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+    float r = (roughness + 1.0);
+    float k = (r*r) / 8.0;
+
+    float num   = NdotV;
+    float denom = NdotV * (1.0 - k) + k;
+	
+    return num / denom;
+}
+
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+    float NdotV = max(dot(N, V), 0.0);
+    float NdotL = max(dot(N, L), 0.0);
+    float ggx2  = GeometrySchlickGGX(NdotV, roughness);
+    float ggx1  = GeometrySchlickGGX(NdotL, roughness);
+	
+    return ggx1 * ggx2;
+}
+
+float CalculateLightAttenuation(vec3 vertexPosition, vec3 lightPosition, vec4 lightDirection)
+{
+	float attenuation = 1.0;
+
+	// Directional lights have no attenuation
+	if(lightDirection.w == 0)
+	{
+		float dist  = length(lightPosition - vertexPosition);
+		attenuation = 1.0 / (dist * dist);
+	}
+
+	return attenuation;
+}
+
+float CalculateLightCutOff(vec2 lightCutOff, vec3 lightDirection, vec3 spotDirection)
+{
+	float cutOff = 1.0;
+
+	// Only spotlights have cut-offs
+	if(lightCutOff.x >= 0 && lightCutOff.y >= 0)
+	{
+		float theta   = dot(lightDirection, normalize(-spotDirection));
+		float epsilon = lightCutOff.x - lightCutOff.y;
+		cutOff        = clamp((theta - lightCutOff.y) / epsilon, 0.0, 1.0);
+	}
+
+	return cutOff;
+}
+
+vec3 CalculateColor(vec3 vertexPosition, vec3 vertexNormal, vec3 albedo, float metallic, float roughness, float ambientOcclusion)
+{
+	vec3 Lo = vec3(0.0);
+
+	vec3 viewDirection = normalize(u_CameraPosition - vertexPosition);
+
+	vec3 F0 = vec3(0.04);
+		 F0 = mix(F0, albedo, metallic);
+
+	for (uint lightIndex = 0; lightIndex < u_LightCount; lightIndex++)
+	{
+		LightData light = u_Lights[lightIndex];
+		vec3 radiance = pow(light.Color.rgb, vec3(u_Gamma)) * light.Intensity
+			* CalculateLightAttenuation(vertexPosition, light.Position.xyz, light.Direction)
+			* CalculateLightCutOff(light.CutOffs, normalize(light.Position.xyz - vertexPosition), light.Direction.xyz);
+
+		vec3 lightDirection = normalize(light.Position.xyz - vertexPosition);
+		if(light.Direction.w != 0)
+		{
+			lightDirection = normalize(-light.Direction.xyz); // Directional lights have no position
+		}
+
+		vec3 H = normalize(viewDirection + lightDirection);
+
+		vec3 F  = fresnelSchlick(max(dot(H, viewDirection), 0.0), F0);
+
+		float NDF = DistributionGGX(vertexNormal, H, roughness);
+		float G   = GeometrySmith(vertexNormal, viewDirection, lightDirection, roughness);
+
+		vec3 numerator    = NDF * G * F;
+		float denominator = 4.0 * max(dot(vertexNormal, viewDirection), 0.0) * max(dot(vertexNormal, lightDirection), 0.0) + 0.0001;
+		vec3 specular     = numerator / denominator;
+
+		vec3 kS = F;
+		vec3 kD = vec3(1.0) - kS;
+
+		kD *= 1.0 - metallic;
+
+		float NdotL = max(dot(vertexNormal, lightDirection), 0.0);
+		Lo += (kD * albedo / PI + specular) * radiance * NdotL;
+	}
+
+	vec3 ambient = AMBIENT_STRENGTH * albedo * ambientOcclusion;
+
+	return ambient + Lo;
+}
@@ -3,6 +3,8 @@
 
 #include "Atlas/Utils/PlatformUtils.h"
 
+#include "Atlas/Debug/Benchmark.h"
+
 #include "Atlas/Renderer/Model.h"
 
 #include <imgui/imgui.h>
@@ -106,7 +108,7 @@ namespace Atlas
 		if (m_ViewportHovered)
 		{
 			int pixelData = Renderer::GetEntityIDFromPixel(mouseX, mouseY);
-			m_HoveredEntity = pixelData == -1 ? nullptr : m_ActiveScene->GetEntity((entt::entity)pixelData);
+			m_HoveredEntity = pixelData == -1 ? Entity() : m_ActiveScene->GetEntity((entt::entity)pixelData);
 		}
 
 		Renderer::EndRenderingPass();
@@ -228,6 +230,36 @@ namespace Atlas
 				ImGui::EndMenu();
 			}
 
+			if (ImGui::BeginMenu("Benchmark"))
+			{
+				if (ImGui::MenuItem("Transform Composition"))
+				{
+					Benchmark::TransformComposition();
+				}
+
+				if (ImGui::MenuItem("Entity Lifecycle"))
+				{
+					Benchmark::EntityLifecycle();
+				}
+
+				if (ImGui::MenuItem("Play Start"))
+				{
+					Benchmark::PlayStart();
+				}
+
+				if (ImGui::MenuItem("Job System Stress"))
+				{
+					Benchmark::JobSystemStress();
+				}
+
+				if (ImGui::MenuItem("Job System Scaling"))
+				{
+					Benchmark::JobSystemScaling();
+				}
+
+				ImGui::EndMenu();
+			}
+
 			ImGui::EndMenuBar();
 		}
 
@@ -240,19 +272,41 @@ namespace Atlas
 		ImGui::Text("API: %s", RendererAPI::GetAPI() == RendererAPI::API::OpenGL ? "OpenGL" : "None");
 
 		std::string name = "None";
-		if (m_HoveredEntity && m_HoveredEntity->HasComponent<TagComponent>())
-			name = m_HoveredEntity->GetComponent<TagComponent>().Tag;
+		if (m_HoveredEntity && m_HoveredEntity.HasComponent<TagComponent>())
+			name = m_HoveredEntity.GetComponent<TagComponent>().Tag;
 		ImGui::Text("Hovered Entity: %s", name.c_str());
 
 		auto stats = Renderer::GetStats();
 		ImGui::Text("\nDraw Calls: %d", stats.DrawCalls);
+		ImGui::Text("Flushes: %d", stats.FlushCount);
+		ImGui::Text("Shader Binds: %d", stats.ShaderBindCount);
+		ImGui::Text("Texture Binds: %d", stats.TextureBindCount);
+		ImGui::Text("Queued Draws: %d", stats.QueuedDrawCount);
 		ImGui::Text("Quad Count: %d", stats.QuadCount);
+		ImGui::Text("Sprites Culled: %d", stats.CulledSpriteCount);
 		ImGui::Text("Circle Count: %d", stats.CircleCount);
 		ImGui::Text("Line Count: %d", stats.LineCount);
 		ImGui::Text("Mesh Count: %d", stats.MeshCount);
+		ImGui::Text("Mesh LODs: %d / %d / %d / %d", stats.LODMeshCounts[0], stats.LODMeshCounts[1], stats.LODMeshCounts[2], stats.LODMeshCounts[3]);
+		ImGui::Text("Meshes Culled: %d", stats.CulledMeshCount);
+		ImGui::Text("Meshes Occluded: %d", stats.OccludedMeshCount);
+		ImGui::Text("Occluders: %d (%d triangles)", stats.OccluderCount, stats.OccluderTriangleCount);
+		ImGui::Text("Clusters: %d (%d outside, %d back facing)", stats.ClusterCount, stats.ClusterFrustumCulled, stats.ClusterBackfaceCulled);
 		ImGui::Text("Vertices: %d", stats.TotalVertexCount);
 		ImGui::Text("Indices: %d", stats.TotalIndexCount);
 		ImGui::Text("Selection Count: %d", stats.SelectionCount);
+		ImGui::Text("\nMesh Uploads: %.2f MB", stats.MeshUploadBytes / (1024.0f * 1024.0f));
+		ImGui::Text("Mesh Uploads Saved: %.2f MB", stats.MeshUploadBytesSaved / (1024.0f * 1024.0f));
+		ImGui::Text("\nMesh Arena Vertices: %d / %d", stats.ArenaVertexCount, stats.ArenaVertexCapacity);
+		ImGui::Text("Mesh Arena Vertex Memory: %.2f MB", stats.ArenaVertexBytes / (1024.0f * 1024.0f));
+		ImGui::Text("Mesh Arena Indices: %d / %d", stats.ArenaIndexCount, stats.ArenaIndexCapacity);
+		ImGui::Text("Mesh Arena Index Memory: %.2f MB", stats.ArenaIndexBytes / (1024.0f * 1024.0f));
+		ImGui::Text("Mesh Arena Free Blocks: %d", stats.ArenaFreeBlockCount);
+		ImGui::Text("Mesh Arena Fragmentation: %.1f%%", stats.ArenaFragmentation * 100.0f);
+		ImGui::Text("\nTexture Batch Breaks: %d", stats.TextureBatchBreaks);
+		ImGui::Text("Pooled Textures: %d", stats.PooledTextureCount);
+		ImGui::Text("Texture Arrays: %d", stats.TextureArrayCount);
+		ImGui::Text("Texture Array Memory: %.2f MB", stats.TextureArrayBytes / (1024.0f * 1024.0f));
 
 		ImGui::End();
 
@@ -291,7 +345,7 @@ namespace Atlas
 		}
 
 		// Gizmos
-		Entity* selectedEntity = m_SceneHierarchyPanel.GetSelectedEntity();
+		Entity selectedEntity = m_SceneHierarchyPanel.GetSelectedEntity();
 		if (selectedEntity && m_GizmoType != -1)
 		{
 			ImGuizmo::SetOrthographic((int)m_EditorCamera.GetProjectionType());
@@ -304,7 +358,7 @@ namespace Atlas
 			glm::mat4 cameraView = m_EditorCamera.GetViewMatrix();
 
 			// Entity transform
-			auto& transformComponent = selectedEntity->GetComponent<TransformComponent>();
+			auto& transformComponent = selectedEntity.GetComponent<TransformComponent>();
 			glm::mat4 transform = m_ActiveScene->GetEntityTransform(selectedEntity);
 
 			// Snapping
@@ -367,10 +421,22 @@ namespace Atlas
 
 		EventDispatcher dispatcher(e);
 		dispatcher.Dispatch<WindowMovedEvent>(ATLAS_BIND_EVENT_FN(EditorLayer::OnWindowMoved));
+		dispatcher.Dispatch<WindowResizeEvent>(ATLAS_BIND_EVENT_FN(EditorLayer::OnWindowResized));
 		dispatcher.Dispatch<KeyPressedEvent>(ATLAS_BIND_EVENT_FN(EditorLayer::OnKeyPressed));
 		dispatcher.Dispatch<MouseButtonPressedEvent>(ATLAS_BIND_EVENT_FN(EditorLayer::OnMouseButtonPressed));
 	}
 
+	bool EditorLayer::OnWindowResized(WindowResizeEvent& e)
+	{
+		// Minimizing stops the updates, the packets built before it are out of date once the window is back
+		if (m_ActiveScene != nullptr)
+		{
+			m_ActiveScene->InvalidateRenderPackets();
+		}
+
+		return false;
+	}
+
 	bool EditorLayer::OnKeyPressed(KeyPressedEvent& e)
 	{
 		// Editor-only shortcuts
@@ -565,12 +631,12 @@ namespace Atlas
 		Ref<Scene> newScene = CreateRef<Scene>("Starter Scene");
 		SetEditorScene(newScene);
 
-		Entity* squareEntity = newScene->CreateEntity("White Square");
-		squareEntity->AddComponent<SpriteRendererComponent>();
+		Entity squareEntity = newScene->CreateEntity("White Square");
+		squareEntity.AddComponent<SpriteRendererComponent>();
 
-		Entity* cameraEntity = newScene->CreateEntity("Camera");
-		cameraEntity->AddComponent<CameraComponent>();
-		CameraComponent* cameraComponent = &cameraEntity->GetComponent<CameraComponent>();
+		Entity cameraEntity = newScene->CreateEntity("Camera");
+		cameraEntity.AddComponent<CameraComponent>();
+		CameraComponent* cameraComponent = &cameraEntity.GetComponent<CameraComponent>();
 		cameraComponent->Camera.SetProjectionType(Camera::ProjectionType::Orthographic);
 		cameraComponent->Camera.SetOrthographicFarClip(2.0f);
 
@@ -582,31 +648,31 @@ namespace Atlas
 		Ref<Scene> newScene = CreateRef<Scene>("Starter Scene");
 		SetEditorScene(newScene);
 
-		Entity* squareEntity = newScene->CreateEntity("White Cube");
-		squareEntity->AddComponent<MeshComponent>();
-		squareEntity->AddComponent<MaterialComponent>();
-		squareEntity->GetComponent<MaterialComponent>().Material->SetMaterialPreset(Material::MaterialPresets::Gold);
+		Entity squareEntity = newScene->CreateEntity("White Cube");
+		squareEntity.AddComponent<MeshComponent>();
+		squareEntity.AddComponent<MaterialComponent>();
+		squareEntity.GetComponent<MaterialComponent>().Material->SetMaterialPreset(Material::MaterialPresets::Gold);
 
-		Entity* planeEntity = newScene->CreateEntity("Plane");
-		TransformComponent* planeTransform = &planeEntity->GetComponent<TransformComponent>();
+		Entity planeEntity = newScene->CreateEntity("Plane");
+		TransformComponent* planeTransform = &planeEntity.GetComponent<TransformComponent>();
 		planeTransform->Translation = glm::vec3(0.0f, -1.0f, 0.0f);
 		planeTransform->Scale = glm::vec3(10.0f, 0.1f, 10.0f);
-		planeEntity->AddComponent<MeshComponent>();
-		planeEntity->AddComponent<MaterialComponent>();
-		planeEntity->GetComponent<MaterialComponent>().Material->SetMaterialPreset(Material::MaterialPresets::Default);
-
-		Entity* cameraEntity = newScene->CreateEntity("Camera");
-		cameraEntity->AddComponent<CameraComponent>();
-		cameraEntity->GetComponent<CameraComponent>().Camera.SetProjectionType(Camera::ProjectionType::Perspective);
-		TransformComponent* cameraTransform = &cameraEntity->GetComponent<TransformComponent>();
+		planeEntity.AddComponent<MeshComponent>();
+		planeEntity.AddComponent<MaterialComponent>();
+		planeEntity.GetComponent<MaterialComponent>().Material->SetMaterialPreset(Material::MaterialPresets::Default);
+
+		Entity cameraEntity = newScene->CreateEntity("Camera");
+		cameraEntity.AddComponent<CameraComponent>();
+		cameraEntity.GetComponent<CameraComponent>().Camera.SetProjectionType(Camera::ProjectionType::Perspective);
+		TransformComponent* cameraTransform = &cameraEntity.GetComponent<TransformComponent>();
 		cameraTransform->Translation = glm::vec3(3.5f, 2.1f, 3.5f);
 		cameraTransform->Rotation = glm::radians(glm::vec3(-25.0f, 45.0f, 0.0f));
 
-		Entity* lightEntity = newScene->CreateEntity("Light");
-		lightEntity->GetComponent<TransformComponent>().Translation = glm::vec3(3.0f, 2.0f, 1.5f);
-		lightEntity->GetComponent<TransformComponent>().Rotation = glm::vec3(glm::radians(-69.0f), 0.0f, glm::radians(-45.0f));
-		lightEntity->AddComponent<LightSourceComponent>();
-		lightEntity->GetComponent<LightSourceComponent>().Light->SetCastType(Light::CastType::PointLight);
+		Entity lightEntity = newScene->CreateEntity("Light");
+		lightEntity.GetComponent<TransformComponent>().Translation = glm::vec3(3.0f, 2.0f, 1.5f);
+		lightEntity.GetComponent<TransformComponent>().Rotation = glm::vec3(glm::radians(-69.0f), 0.0f, glm::radians(-45.0f));
+		lightEntity.AddComponent<LightSourceComponent>();
+		lightEntity.GetComponent<LightSourceComponent>().Light->SetCastType(Light::CastType::PointLight);
 
 		return newScene;
 	}
@@ -655,7 +721,7 @@ namespace Atlas
 
 		m_ActiveScene = m_EditorScene;
 		m_EditorScenePath = path;
-		m_HoveredEntity = nullptr;
+		m_HoveredEntity = {};
 	}
 
 	void EditorLayer::SaveScene()
@@ -712,6 +778,7 @@ namespace Atlas
 
 		m_ActiveScene->OnRuntimeStop();
 		m_ActiveScene = m_EditorScene;
+		m_ActiveScene->InvalidateRenderPackets(); // Built before Play started
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
 		m_SceneSettingsPanel.SetContext(m_ActiveScene);
@@ -726,7 +793,7 @@ namespace Atlas
 	{
 		if (m_SceneHierarchyPanel.GetSelectedEntity() == m_HoveredEntity)
 		{
-			m_HoveredEntity = nullptr;
+			m_HoveredEntity = {};
 		}
 
 		m_SceneHierarchyPanel.DestroySelectedEntity();
@@ -50,6 +50,7 @@ namespace Atlas
 
 		// Events
 		bool OnWindowMoved(WindowMovedEvent& e) { m_ViewportInvalidated = true; return false; }
+		bool OnWindowResized(WindowResizeEvent& e);
 
 		// Toolbar Buttons
 		void OnScenePlay();
@@ -67,7 +68,7 @@ namespace Atlas
 		bool m_ViewportFocused = false, m_ViewportHovered = false;
 		EditorCamera m_EditorCamera;
 		int m_GizmoType = -1;
-		Entity* m_HoveredEntity = nullptr;
+		Entity m_HoveredEntity;
 		bool m_ViewportInvalidated = false;
 
 		enum class SceneState
@@ -17,10 +17,10 @@ namespace Atlas
 	void SceneHierarchyPanel::SetContext(const Ref<Scene>& context)
 	{
 		m_Context = context;
-		m_SelectedEntity = nullptr;
+		m_SelectedEntity = {};
 	}
 
-	void SceneHierarchyPanel::SelectEntity(Entity* entity)
+	void SceneHierarchyPanel::SelectEntity(Entity entity)
 	{
 		m_SelectedEntity = entity;
 	}
@@ -29,7 +29,7 @@ namespace Atlas
 	{
 		if (m_SelectedEntity)
 		{
-			Entity* newEntity = m_Context->DuplicateEntity(m_SelectedEntity);
+			Entity newEntity = m_Context->DuplicateEntity(m_SelectedEntity);
 			m_SelectedEntity = newEntity;
 		}
 	}
@@ -39,7 +39,7 @@ namespace Atlas
 		if (m_SelectedEntity)
 		{
 			m_Context->DestroyEntity(m_SelectedEntity);
-			m_SelectedEntity = nullptr;
+			m_SelectedEntity = {};
 		}
 	}
 
@@ -58,17 +58,18 @@ namespace Atlas
 				name = std::string(buffer);
 			}
 
-			for (auto& [handle, entity] : m_Context->m_EntityHandleMap)
+			auto view = m_Context->m_Registry.view<RelationshipComponent>();
+			for (entt::entity entityHandle : view)
 			{
-				if (entity->GetParent() == nullptr)
+				if (view.get<RelationshipComponent>(entityHandle).Parent == entt::null)
 				{
-					DrawEntityNode(entity);
+					DrawEntityNode(m_Context->GetEntity(entityHandle));
 				}
 			}
 
 			if ((ImGui::IsMouseDown(0) || ImGui::IsMouseDown(1)) && ImGui::IsWindowHovered())
 			{
-				m_SelectedEntity = nullptr;
+				m_SelectedEntity = {};
 			}
 
 			// Right-click on blank space
@@ -88,8 +89,8 @@ namespace Atlas
 			{
 				if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("SCENE_HIERARCHY_ENTITY", ImGuiDragDropFlags_AcceptNoDrawDefaultRect))
 				{
-					Entity* droppedEntity = (Entity*)payload->Data;
-					m_Context->GetEntity(droppedEntity->GetHandle())->SetParent(nullptr);
+					Entity droppedEntity = *(const Entity*)payload->Data;
+					droppedEntity.SetParent({});
 				}
 				ImGui::EndDragDropTarget();
 			}
@@ -106,14 +107,14 @@ namespace Atlas
 		ImGui::End();
 	}
 
-	void SceneHierarchyPanel::DrawEntityNode(Entity* entity)
+	void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 	{
-		auto& tag = entity->GetComponent<TagComponent>().Tag;
+		auto& tag = entity.GetComponent<TagComponent>().Tag;
 
 		ImGuiTreeNodeFlags flags = ((m_SelectedEntity == entity) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
 		flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
 		
-		bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity->GetHandle(), flags, tag.c_str());
+		bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity.GetHandle(), flags, tag.c_str());
 		if (ImGui::IsItemClicked())
 		{
 			m_SelectedEntity = entity;
@@ -144,13 +145,13 @@ namespace Atlas
 
 		if (ImGui::BeginDragDropSource())
 		{
-			ImGui::SetDragDropPayload("SCENE_HIERARCHY_ENTITY", entity, sizeof(Entity));
+			ImGui::SetDragDropPayload("SCENE_HIERARCHY_ENTITY", &entity, sizeof(Entity));
 			ImGui::EndDragDropSource();
 		}
 
 		if (opened)
 		{
-			for (Entity* child : entity->GetDirectChildren())
+			for (Entity child : entity.GetDirectChildren())
 			{
 				DrawEntityNode(child);
 			}
@@ -162,23 +163,23 @@ namespace Atlas
 		{
 			if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("SCENE_HIERARCHY_ENTITY", ImGuiDragDropFlags_AcceptNoDrawDefaultRect))
 			{
-				Entity* droppedEntity = (Entity*)payload->Data;
-				m_Context->GetEntity(droppedEntity->GetHandle())->SetParent(entity);
+				Entity droppedEntity = *(const Entity*)payload->Data;
+				droppedEntity.SetParent(entity);
 			}
 			ImGui::EndDragDropTarget();
 		}
 
 		if (entityDeleted)
 		{
-			if (m_SelectedEntity == entity)
+			if (m_SelectedEntity && (m_SelectedEntity == entity || m_SelectedEntity.IsDescendantOf(entity)))
 			{
-				m_SelectedEntity = nullptr;
+				m_SelectedEntity = {};
 			}
 			m_Context->DestroyEntity(entity);
 		}
 	}
 
-	void SceneHierarchyPanel::DrawComponents(Entity* entity)
+	void SceneHierarchyPanel::DrawComponents(Entity entity)
 	{
 		ImVec2 padding = ImGui::GetStyle().FramePadding;
 		ImVec2 buttonLabelSize = ImGui::CalcTextSize("Add Component", NULL, true);
@@ -186,9 +187,9 @@ namespace Atlas
 
 		ImGui::PushItemWidth(ImGui::GetColumnWidth() - buttonSize.x - padding.x);
 
-		if (entity->HasComponent<TagComponent>())
+		if (entity.HasComponent<TagComponent>())
 		{
-			auto& tag = entity->GetComponent<TagComponent>().Tag;
+			auto& tag = entity.GetComponent<TagComponent>().Tag;
 
 			char buffer[256];
 			memset(buffer, 0, sizeof(buffer));
@@ -587,6 +588,12 @@ namespace Atlas
 				material->SetColor(color);
 			}
 
+			float opacity = material->GetOpacity();
+			if (ImGuiUtils::DragFloat("Opacity", opacity, 1.0f, 0.01f, 0.0f, 1.0f))
+			{
+				material->SetOpacity(opacity);
+			}
+
 			ImGui::Separator();
 
 			// Normal component
@@ -788,12 +795,12 @@ namespace Atlas
 	}
 
 	template<typename T, typename UIFunction>
-	void SceneHierarchyPanel::DrawComponent(const std::string& name, Entity* entity, UIFunction uiFunction)
+	void SceneHierarchyPanel::DrawComponent(const std::string& name, Entity entity, UIFunction uiFunction)
 	{
 		const ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_FramePadding;
-		if (entity->HasComponent<T>())
+		if (entity.HasComponent<T>())
 		{
-			auto& component = entity->GetComponent<T>();
+			auto& component = entity.GetComponent<T>();
 			ImVec2 contentRegionAvailable = ImGui::GetContentRegionAvail();
 
 			ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2{ 4, 4 });
@@ -826,7 +833,7 @@ namespace Atlas
 
 			if (removeComponent)
 			{
-				entity->RemoveComponent<T>();
+				entity.RemoveComponent<T>();
 			}
 		}
 	}
@@ -834,11 +841,11 @@ namespace Atlas
 	template<typename T>
 	void SceneHierarchyPanel::DisplayAddComponentEntry(const std::string& entryName)
 	{
-		if (!m_SelectedEntity->HasComponent<T>())
+		if (!m_SelectedEntity.HasComponent<T>())
 		{
 			if (ImGui::MenuItem(entryName.c_str()))
 			{
-				m_SelectedEntity->AddComponent<T>();
+				m_SelectedEntity.AddComponent<T>();
 				ImGui::CloseCurrentPopup();
 			}
 		}
@@ -847,7 +854,7 @@ namespace Atlas
 	template<typename T, typename T2>
 	void SceneHierarchyPanel::DisplayAddComponentEntryIfOther(const std::string& entryName)
 	{
-		if (m_SelectedEntity->HasComponent<T2>())
+		if (m_SelectedEntity.HasComponent<T2>())
 		{
 			DisplayAddComponentEntry<T>(entryName);
 		}
@@ -856,7 +863,7 @@ namespace Atlas
 	template<typename T, typename T2>
 	void SceneHierarchyPanel::DisplayAddComponentEntryIfNoOther(const std::string& entryName)
 	{
-		if (!m_SelectedEntity->HasComponent<T2>())
+		if (!m_SelectedEntity.HasComponent<T2>())
 		{
 			DisplayAddComponentEntry<T>(entryName);
 		}
@@ -16,8 +16,8 @@ namespace Atlas
 
 		void SetContext(const Ref<Scene>& context);
 
-		Entity* GetSelectedEntity() const { return m_SelectedEntity; }
-		void SelectEntity(Entity* entity);
+		Entity GetSelectedEntity() const { return m_SelectedEntity; }
+		void SelectEntity(Entity entity);
 		void DuplicateSelectedEntity();
 		void DestroySelectedEntity();
 
@@ -32,13 +32,13 @@ namespace Atlas
 		template<typename T, typename T2>
 		void DisplayAddComponentEntryIfNoOther(const std::string& entryName);
 
-		void DrawEntityNode(Entity* entity);
-		void DrawComponents(Entity* entity);
+		void DrawEntityNode(Entity entity);
+		void DrawComponents(Entity entity);
 
 		template<typename T, typename UIFunction>
-		static void DrawComponent(const std::string& name, Entity* entity, UIFunction uiFunction);
+		static void DrawComponent(const std::string& name, Entity entity, UIFunction uiFunction);
 
 		Ref<Scene> m_Context;
-		Entity* m_SelectedEntity;
+		Entity m_SelectedEntity;
 	};
 }
\ No newline at end of file
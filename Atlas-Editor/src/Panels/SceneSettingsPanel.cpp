@@ -62,7 +62,7 @@ namespace Atlas
 
 	void SceneSettingsPanel::DrawPrimaryCamera()
 	{
-		std::vector<Entity*> cameras = m_Context->GetCameras();
+		std::vector<Entity> cameras = m_Context->GetCameras();
 
 		std::vector<const char*> cameraTagStrings;
 		cameraTagStrings.reserve(cameras.size() + 1);
@@ -71,9 +71,9 @@ namespace Atlas
 
 		for (int i = 0; i < cameras.size(); i++)
 		{
-			Entity* camera = cameras[i];
+			Entity camera = cameras[i];
 
-			cameraTagStrings.push_back(camera->GetComponent<TagComponent>().Tag.c_str());
+			cameraTagStrings.push_back(camera.GetComponent<TagComponent>().Tag.c_str());
 			if (camera == m_Context->GetPrimaryCamera())
 			{
 				currentCameraTagString = cameraTagStrings[i + 1];
@@ -88,7 +88,7 @@ namespace Atlas
 				if (ImGui::Selectable(cameraTagStrings[i], isSelected))
 				{
 					currentCameraTagString = cameraTagStrings[i];
-					m_Context->SetPrimaryCamera(i == 0 ? nullptr : cameras[i - 1]);
+					m_Context->SetPrimaryCamera(i == 0 ? Entity() : cameras[i - 1]);
 				}
 
 				if (isSelected)
@@ -158,11 +158,11 @@ namespace Atlas
 
 	void SceneSettingsPanel::DrawGraphicsSettings()
 	{
-		const char* bufferTypeStrings[] = { "Final", "EntityID", "Position", "Normal", "Albedo", "Material", "BrightColors", "SSAO" };
+		const char* bufferTypeStrings[] = { "Final", "EntityID", "Position", "Normal", "Albedo", "Material", "BrightColors", "SSAO", "Occlusion" };
 		const char* currentBufferTypeString = bufferTypeStrings[(int)Renderer::GetDisplayedBuffer()];
 		if (ImGuiUtils::BeginCombo("Render Buffer", *currentBufferTypeString))
 		{
-			for (int i = 0; i < 8; i++)
+			for (int i = 0; i < 9; i++)
 			{
 				bool isSelected = currentBufferTypeString == bufferTypeStrings[i];
 				if (ImGui::Selectable(bufferTypeStrings[i], isSelected))
@@ -200,6 +200,36 @@ namespace Atlas
 			Renderer::ToggleSSAO();
 		}
 
+		bool isOcclusionCullingEnabled = Renderer::IsOcclusionCullingEnabled();
+		if (ImGuiUtils::Checkbox("Occlusion Culling", isOcclusionCullingEnabled))
+		{
+			Renderer::ToggleOcclusionCulling();
+		}
+
+		bool isClusterCullingEnabled = Renderer::IsClusterCullingEnabled();
+		if (ImGuiUtils::Checkbox("Cluster Culling", isClusterCullingEnabled))
+		{
+			Renderer::ToggleClusterCulling();
+		}
+
+		bool isDepthPrepassEnabled = Renderer::IsDepthPrepassEnabled();
+		if (ImGuiUtils::Checkbox("Depth Pre-Pass", isDepthPrepassEnabled))
+		{
+			Renderer::ToggleDepthPrepass();
+		}
+
+		bool isRenderQueueSortingEnabled = Renderer::IsRenderQueueSortingEnabled();
+		if (ImGuiUtils::Checkbox("Sort Render Queue", isRenderQueueSortingEnabled))
+		{
+			Renderer::ToggleRenderQueueSorting();
+		}
+
+		bool isFramePipeliningEnabled = Renderer::IsFramePipeliningEnabled();
+		if (ImGuiUtils::Checkbox("Pipelined Frames", isFramePipeliningEnabled))
+		{
+			Renderer::ToggleFramePipelining();
+		}
+
 		ImGui::Separator();
 
 		if (ImGuiUtils::Checkbox("Gamma Correction", m_GammaCorrection))
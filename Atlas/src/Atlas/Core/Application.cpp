@@ -6,6 +6,7 @@
 #include "Atlas/Renderer/ScreenSpaceRenderer.h"
 
 #include "Atlas/Core/Input.h"
+#include "Atlas/Core/JobSystem.h"
 
 #include "Atlas/Utils/PlatformUtils.h"
 
@@ -27,6 +28,8 @@ namespace Atlas
 			std::filesystem::current_path(m_Specification.WorkingDirectory);
 		}
 
+		JobSystem::Init();
+
 		m_Window = Window::Create(WindowProps(m_Specification.Name));
 		m_Window->SetEventCallback(ATLAS_BIND_EVENT_FN(Application::OnEvent));
 
@@ -46,6 +49,7 @@ namespace Atlas
 	{
 		ATLAS_PROFILE_FUNCTION();
 
+		JobSystem::Shutdown();
 		Renderer::Shutdown();
 	}
 
@@ -77,6 +81,11 @@ namespace Atlas
 			Timestep timestep = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
+			{
+				ATLAS_PROFILE_SCOPE("Main Thread Jobs");
+				JobSystem::ExecuteMainThreadJobs();
+			}
+
 			if (!m_Minimized)
 			{
 				{
@@ -0,0 +1,512 @@
+#include "atlaspch.h"
+#include "Atlas/Core/JobSystem.h"
+
+#include <condition_variable>
+#include <thread>
+
+namespace Atlas
+{
+	struct JobSystem::Job
+	{
+		JobFunction Function;
+		JobCounter* Counter = nullptr;
+		bool IsMainThreadOnly = false;
+	};
+
+	// Chase-Lev deque (after Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models", with sequentially
+	// consistent operations in place of their fences): the owner pushes and pops at the bottom, thieves take from the top.
+	// Fixed size, Push fails when full.
+	class WorkStealingQueue
+	{
+	public:
+		bool Push(JobSystem::Job* job)
+		{
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+			int64_t top    = m_Top.load(std::memory_order_acquire);
+			if (bottom - top >= Capacity)
+			{
+				return false;
+			}
+
+			m_Jobs[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+			m_Bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		JobSystem::Job* Pop()
+		{
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+			m_Bottom.store(bottom, std::memory_order_seq_cst);
+			int64_t top = m_Top.load(std::memory_order_seq_cst);
+
+			if (top > bottom)
+			{
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			JobSystem::Job* job = m_Jobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// Last job: races with the thieves
+				if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					job = nullptr;
+				}
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return job;
+		}
+
+		JobSystem::Job* Steal()
+		{
+			int64_t top    = m_Top.load(std::memory_order_seq_cst);
+			int64_t bottom = m_Bottom.load(std::memory_order_seq_cst);
+
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			JobSystem::Job* job = m_Jobs[top & (Capacity - 1)].load(std::memory_order_relaxed);
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return nullptr; // Taken by another thief or the owner
+			}
+
+			return job;
+		}
+
+	private:
+		static const int64_t Capacity = 4096; // Power of two
+
+		alignas(64) std::atomic<int64_t> m_Top    = { 0 };
+		alignas(64) std::atomic<int64_t> m_Bottom = { 0 };
+		alignas(64) std::atomic<JobSystem::Job*> m_Jobs[Capacity] = {};
+	};
+
+	struct JobSystemData
+	{
+		uint32_t WorkerCount = 0;
+		std::vector<std::thread> Workers;
+		std::vector<Scope<WorkStealingQueue>> Queues; // Index 0 is the main thread's, then one per worker
+		std::atomic<bool> IsRunning = { false };
+
+		// Jobs submitted by threads without a queue, or while theirs was full
+		std::mutex SharedJobMutex;
+		std::vector<JobSystem::Job*> SharedJobs;
+		std::atomic<uint32_t> SharedJobCount = { 0 };
+
+		std::mutex MainThreadJobMutex;
+		std::vector<JobSystem::Job*> MainThreadJobs;
+		std::atomic<uint32_t> MainThreadJobCount = { 0 };
+
+		// Idle workers sleep until the version changes, bumped on every submission
+		std::mutex SleepMutex;
+		std::condition_variable WakeCondition;
+		std::atomic<uint64_t> WorkVersion = { 0 };
+		std::atomic<uint32_t> SleepingWorkerCount = { 0 };
+	};
+
+	static JobSystemData s_Data;
+
+	static thread_local int32_t t_QueueIndex = -1; // -1 for threads the job system doesn't own
+	static thread_local uint32_t t_RandomState = 0;
+
+	// Xorshift, only picks which queue to steal from first
+	static uint32_t NextRandom()
+	{
+		if (t_RandomState == 0)
+		{
+			t_RandomState = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+		}
+
+		t_RandomState ^= t_RandomState << 13;
+		t_RandomState ^= t_RandomState >> 17;
+		t_RandomState ^= t_RandomState << 5;
+		return t_RandomState;
+	}
+
+	static JobSystem::Job* PopSharedJob()
+	{
+		if (s_Data.SharedJobCount.load(std::memory_order_acquire) == 0)
+		{
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(s_Data.SharedJobMutex);
+		if (s_Data.SharedJobs.empty())
+		{
+			return nullptr;
+		}
+
+		JobSystem::Job* job = s_Data.SharedJobs.back();
+		s_Data.SharedJobs.pop_back();
+		s_Data.SharedJobCount.fetch_sub(1, std::memory_order_release);
+		return job;
+	}
+
+	static JobSystem::Job* StealJob(int32_t thiefIndex)
+	{
+		uint32_t queueCount = (uint32_t)s_Data.Queues.size();
+		uint32_t start = NextRandom() % queueCount;
+		for (uint32_t i = 0; i < queueCount; i++)
+		{
+			uint32_t index = (start + i) % queueCount;
+			if ((int32_t)index == thiefIndex)
+			{
+				continue;
+			}
+
+			if (JobSystem::Job* job = s_Data.Queues[index]->Steal())
+			{
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	static void WakeWorker()
+	{
+		s_Data.WorkVersion.fetch_add(1);
+		if (s_Data.SleepingWorkerCount.load() > 0)
+		{
+			// Taking the mutex makes sure the sleeper is waiting, and not about to, when it is notified
+			{
+				std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+			}
+			s_Data.WakeCondition.notify_one();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// JobCounter //////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	void JobCounter::Decrement()
+	{
+		// Under the mutex so JobSystem::Wait can't return, and the counter be destroyed, while this is still using it
+		std::vector<JobSystem::Job*> continuations;
+		{
+			std::lock_guard<std::mutex> lock(m_ContinuationMutex);
+			if (m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				continuations.swap(m_Continuations);
+			}
+		}
+
+		for (JobSystem::Job* job : continuations)
+		{
+			JobSystem::Submit(job);
+		}
+	}
+
+	void JobCounter::AddContinuation(JobSystem::Job* job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_ContinuationMutex);
+			if (m_Count.load(std::memory_order_acquire) != 0)
+			{
+				m_Continuations.push_back(job);
+				return;
+			}
+		}
+
+		JobSystem::Submit(job);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// JobSystem ///////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	void JobSystem::Init()
+	{
+		uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+		Init(hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0);
+	}
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		ATLAS_CORE_ASSERT(!s_Data.IsRunning, "Job system already initialized!");
+
+		t_QueueIndex = 0;
+		s_Data.WorkerCount = workerCount;
+		s_Data.IsRunning   = true;
+
+		for (uint32_t i = 0; i <= workerCount; i++)
+		{
+			s_Data.Queues.push_back(CreateScope<WorkStealingQueue>());
+		}
+
+		for (uint32_t i = 1; i <= workerCount; i++)
+		{
+			s_Data.Workers.emplace_back(&JobSystem::WorkerLoop, i);
+		}
+
+		ATLAS_CORE_INFO("Job system: {0} worker threads", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+			s_Data.IsRunning = false;
+		}
+		s_Data.WakeCondition.notify_all();
+
+		for (std::thread& worker : s_Data.Workers)
+		{
+			worker.join();
+		}
+
+		for (Scope<WorkStealingQueue>& queue : s_Data.Queues)
+		{
+			while (Job* job = queue->Pop())
+			{
+				delete job;
+			}
+		}
+
+		for (Job* job : s_Data.SharedJobs)
+		{
+			delete job;
+		}
+
+		for (Job* job : s_Data.MainThreadJobs)
+		{
+			delete job;
+		}
+
+		s_Data.Workers.clear();
+		s_Data.Queues.clear();
+		s_Data.SharedJobs.clear();
+		s_Data.SharedJobCount = 0;
+		s_Data.MainThreadJobs.clear();
+		s_Data.MainThreadJobCount = 0;
+		s_Data.WorkerCount = 0;
+	}
+
+	void JobSystem::Execute(JobFunction function, JobCounter* counter)
+	{
+		if (counter != nullptr)
+		{
+			counter->Add(1);
+		}
+
+		Submit(new Job{ std::move(function), counter, false });
+	}
+
+	void JobSystem::ExecuteAfter(JobCounter& dependency, JobFunction function, JobCounter* counter)
+	{
+		if (counter != nullptr)
+		{
+			counter->Add(1);
+		}
+
+		dependency.AddContinuation(new Job{ std::move(function), counter, false });
+	}
+
+	void JobSystem::ExecuteOnMainThread(JobFunction function, JobCounter* counter)
+	{
+		if (counter != nullptr)
+		{
+			counter->Add(1);
+		}
+
+		Submit(new Job{ std::move(function), counter, true });
+	}
+
+	void JobSystem::ExecuteMainThreadJobs()
+	{
+		ATLAS_CORE_ASSERT(IsMainThread(), "Main thread jobs can only run on the main thread!");
+
+		if (s_Data.MainThreadJobCount.load(std::memory_order_acquire) == 0)
+		{
+			return;
+		}
+
+		// Jobs queued by these ones wait for the next call
+		std::vector<Job*> jobs;
+		{
+			std::lock_guard<std::mutex> lock(s_Data.MainThreadJobMutex);
+			jobs.swap(s_Data.MainThreadJobs);
+			s_Data.MainThreadJobCount.store(0, std::memory_order_release);
+		}
+
+		for (Job* job : jobs)
+		{
+			RunJob(job);
+		}
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const RangeFunction& function)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		batchSize = std::max(batchSize, 1u);
+		uint32_t batchCount  = (count - 1) / batchSize + 1;
+		uint32_t helperCount = std::min(batchCount, s_Data.WorkerCount + 1) - 1;
+		if (helperCount == 0)
+		{
+			function(0, count);
+			return;
+		}
+
+		// Batches are handed out from a shared cursor rather than as one job each: few jobs to queue, and threads that
+		// start late (or get slow batches) simply take fewer
+		std::atomic<uint64_t> nextBegin = { 0 };
+		auto runBatches = [&]()
+		{
+			for (uint64_t begin = nextBegin.fetch_add(batchSize, std::memory_order_relaxed); begin < count;
+				begin = nextBegin.fetch_add(batchSize, std::memory_order_relaxed))
+			{
+				function((uint32_t)begin, (uint32_t)std::min<uint64_t>(begin + batchSize, count));
+			}
+		};
+
+		JobCounter counter;
+		for (uint32_t i = 0; i < helperCount; i++)
+		{
+			Execute(runBatches, &counter);
+		}
+
+		runBatches();
+		Wait(counter);
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		bool isMainThread = IsMainThread();
+		while (!counter.IsDone())
+		{
+			if (isMainThread && s_Data.MainThreadJobCount.load(std::memory_order_acquire) != 0)
+			{
+				ExecuteMainThreadJobs();
+			}
+			else if (!RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// The last job may still be releasing the counter
+		std::lock_guard<std::mutex> lock(counter.m_ContinuationMutex);
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return s_Data.WorkerCount;
+	}
+
+	bool JobSystem::IsMainThread()
+	{
+		return t_QueueIndex == 0;
+	}
+
+	void JobSystem::Submit(Job* job)
+	{
+		ATLAS_CORE_ASSERT(s_Data.IsRunning, "Job system not initialized!");
+
+		if (job->IsMainThreadOnly)
+		{
+			std::lock_guard<std::mutex> lock(s_Data.MainThreadJobMutex);
+			s_Data.MainThreadJobs.push_back(job);
+			s_Data.MainThreadJobCount.fetch_add(1, std::memory_order_release);
+			return;
+		}
+
+		// Single threaded: nobody else would run it
+		if (s_Data.WorkerCount == 0)
+		{
+			RunJob(job);
+			return;
+		}
+
+		if (t_QueueIndex < 0 || !s_Data.Queues[t_QueueIndex]->Push(job))
+		{
+			std::lock_guard<std::mutex> lock(s_Data.SharedJobMutex);
+			s_Data.SharedJobs.push_back(job);
+			s_Data.SharedJobCount.fetch_add(1, std::memory_order_release);
+		}
+
+		WakeWorker();
+	}
+
+	bool JobSystem::RunPendingJob()
+	{
+		Job* job = t_QueueIndex >= 0 ? s_Data.Queues[t_QueueIndex]->Pop() : nullptr;
+
+		if (job == nullptr)
+		{
+			job = PopSharedJob();
+		}
+
+		if (job == nullptr)
+		{
+			job = StealJob(t_QueueIndex);
+		}
+
+		if (job == nullptr)
+		{
+			return false;
+		}
+
+		RunJob(job);
+		return true;
+	}
+
+	void JobSystem::RunJob(Job* job)
+	{
+		job->Function();
+
+		JobCounter* counter = job->Counter;
+		delete job;
+
+		if (counter != nullptr)
+		{
+			counter->Decrement();
+		}
+	}
+
+	void JobSystem::WorkerLoop(uint32_t workerIndex)
+	{
+		t_QueueIndex = (int32_t)workerIndex;
+
+		static const uint32_t s_SpinCount = 64;
+
+		while (s_Data.IsRunning.load(std::memory_order_acquire))
+		{
+			// Read before looking for work: anything submitted after it bumps the version, so is not slept through
+			uint64_t version = s_Data.WorkVersion.load();
+
+			bool hasRunJob = false;
+			for (uint32_t spin = 0; spin < s_SpinCount && !hasRunJob; spin++)
+			{
+				hasRunJob = RunPendingJob();
+				if (!hasRunJob)
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			if (hasRunJob)
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(s_Data.SleepMutex);
+			s_Data.SleepingWorkerCount.fetch_add(1);
+			s_Data.WakeCondition.wait(lock, [version]() { return s_Data.WorkVersion.load() != version || !s_Data.IsRunning.load(); });
+			s_Data.SleepingWorkerCount.fetch_sub(1);
+		}
+	}
+}
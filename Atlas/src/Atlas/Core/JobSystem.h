@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Atlas
+{
+	class JobCounter;
+
+	// Worker threads, one per hardware thread besides the main one, each with its own job deque: jobs are pushed and
+	// popped at the back by the thread that owns the deque, idle workers steal from the front of the others.
+	// Threads that wait on a counter run jobs in the meantime, so waiting from inside a job does not deadlock.
+	class JobSystem
+	{
+	public:
+		using JobFunction   = std::function<void()>;
+		using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+		struct Job;
+
+		// One worker per hardware thread minus the main one by default. With no workers, jobs run as they are submitted.
+		static void Init();
+		static void Init(uint32_t workerCount);
+		static void Shutdown(); // Jobs still queued are dropped
+
+		// The counter, if any, counts the job until it has run
+		static void Execute(JobFunction function, JobCounter* counter = nullptr);
+		// Queued once the dependency is done, right away if it already is
+		static void ExecuteAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+		// For what has to run on the main thread (OpenGL calls): run at the start of the next frame, or while the main
+		// thread waits on a counter
+		static void ExecuteOnMainThread(JobFunction function, JobCounter* counter = nullptr);
+		static void ExecuteMainThreadJobs();
+
+		// Splits [0, count) into ranges of at most batchSize, run by the workers and the calling thread. Returns once they
+		// are all done.
+		static void ParallelFor(uint32_t count, uint32_t batchSize, const RangeFunction& function);
+
+		static void Wait(JobCounter& counter);
+
+		static uint32_t GetWorkerCount();
+		static bool IsMainThread();
+
+	private:
+		static void Submit(Job* job);
+		static bool RunPendingJob();
+		static void RunJob(Job* job);
+		static void WorkerLoop(uint32_t workerIndex);
+
+		friend class JobCounter;
+	};
+
+	// Jobs of a group still to run, to wait on them or make other jobs depend on them. Must outlive its jobs (wait on it
+	// with JobSystem::Wait before it goes out of scope), and can only be reused once done.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+		uint32_t GetCount() const { return m_Count.load(std::memory_order_acquire); }
+
+	private:
+		void Add(uint32_t count) { m_Count.fetch_add(count, std::memory_order_relaxed); }
+		void Decrement();
+		void AddContinuation(JobSystem::Job* job);
+
+		std::atomic<uint32_t> m_Count = { 0 };
+		std::mutex m_ContinuationMutex;
+		std::vector<JobSystem::Job*> m_Continuations; // Submitted when the count gets to zero
+
+		friend class JobSystem;
+	};
+}
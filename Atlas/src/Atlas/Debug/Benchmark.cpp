@@ -0,0 +1,371 @@
+#include "atlaspch.h"
+#include "Atlas/Debug/Benchmark.h"
+
+#include "Atlas/Core/JobSystem.h"
+#include "Atlas/Core/Timer.h"
+#include "Atlas/Math/TransformBatch.h"
+#include "Atlas/Scene/Components.h"
+#include "Atlas/Scene/Entity.h"
+#include "Atlas/Scene/Scene.h"
+
+#include <random>
+
+namespace Atlas::Benchmark
+{
+	static void LogThroughput(const char* name, uint64_t itemCount, float seconds)
+	{
+		ATLAS_CORE_INFO("  {0}: {1:.3f} ms, {2:.1f} M/s", name, seconds * 1000.0f, itemCount / seconds * 1e-6f);
+	}
+
+	static void LogDuration(const char* name, uint64_t itemCount, float seconds)
+	{
+		ATLAS_CORE_INFO("  {0}: {1:.3f} ms, {2:.1f} ns each", name, seconds * 1000.0f, seconds * 1e9f / itemCount);
+	}
+
+	void TransformComposition(uint32_t matrixCount, uint32_t iterations)
+	{
+		static const char* s_InstructionSetNames[] = { "Batch (scalar)", "Batch (SSE4.1)", "Batch (AVX2)" };
+
+		// Fixed seed: same transforms every run
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> translation(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> rotation(-glm::pi<float>(), glm::pi<float>());
+		std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+
+		std::vector<TransformComponent> transforms(matrixCount);
+		Math::TransformBatch batch;
+		batch.Reserve(matrixCount);
+		for (TransformComponent& transform : transforms)
+		{
+			transform.Translation = { translation(random), translation(random), translation(random) };
+			transform.Rotation    = { rotation(random), rotation(random), rotation(random) };
+			transform.Scale       = { scale(random), scale(random), scale(random) };
+			batch.Add(transform.Translation, transform.Rotation, transform.Scale);
+		}
+
+		ATLAS_CORE_INFO("Transform composition: {0} matrices, best of {1} runs", matrixCount, iterations);
+
+		std::vector<glm::mat4> expected(matrixCount);
+		float bestSeconds = FLT_MAX;
+		for (uint32_t iteration = 0; iteration < iterations; iteration++)
+		{
+			Timer timer;
+			for (uint32_t i = 0; i < matrixCount; i++)
+			{
+				expected[i] = transforms[i].GetTransform();
+			}
+			bestSeconds = glm::min(bestSeconds, timer.Elapsed());
+		}
+		LogThroughput("glm", matrixCount, bestSeconds);
+
+		std::vector<glm::mat4> matrices(matrixCount);
+		for (int set = 0; set <= (int)Math::TransformBatch::GetSupportedInstructionSet(); set++)
+		{
+			bestSeconds = FLT_MAX;
+			for (uint32_t iteration = 0; iteration < iterations; iteration++)
+			{
+				Timer timer;
+				batch.Compose(matrices.data(), (Math::TransformBatch::InstructionSet)set);
+				bestSeconds = glm::min(bestSeconds, timer.Elapsed());
+			}
+			LogThroughput(s_InstructionSetNames[set], matrixCount, bestSeconds);
+
+			// Also keeps the results alive, so the timed loops are not optimized out
+			float maxError = 0.0f;
+			for (uint32_t i = 0; i < matrixCount; i++)
+			{
+				for (int column = 0; column < 4; column++)
+				{
+					glm::vec4 difference = glm::abs(matrices[i][column] - expected[i][column]);
+					maxError = glm::max(maxError, glm::max(glm::max(difference.x, difference.y), glm::max(difference.z, difference.w)));
+				}
+			}
+			ATLAS_CORE_TRACE("    Max difference with glm: {0}", maxError);
+		}
+	}
+
+	void EntityLifecycle(uint32_t entityCount)
+	{
+		static const uint32_t s_GroupSize = 8;
+
+		ATLAS_CORE_INFO("Entity lifecycle: {0} entities", entityCount);
+
+		Scene scene("Benchmark");
+		std::vector<Entity> roots;
+		roots.reserve(entityCount / s_GroupSize + 1);
+
+		Timer timer;
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			if (i % s_GroupSize == 0)
+			{
+				roots.push_back(scene.CreateEntity());
+			}
+			else
+			{
+				scene.CreateEntity(std::string(), roots.back());
+			}
+		}
+		LogDuration("Create", entityCount, timer.Elapsed());
+
+		// Moves every entity through its handle, then reads back the world transforms (rebuilt parents first)
+		timer.Reset();
+		uint32_t visitedCount = 0;
+		for (Entity root : roots)
+		{
+			root.GetComponent<TransformComponent>().Translation.x += 1.0f;
+			visitedCount++;
+
+			for (Entity child = root.GetFirstChild(); child; child = child.GetNextSibling())
+			{
+				child.GetComponent<TransformComponent>().Translation.y += 1.0f;
+				visitedCount++;
+			}
+		}
+		LogDuration("Iterate", visitedCount, timer.Elapsed());
+
+		timer.Reset();
+		float checksum = 0.0f;
+		for (Entity root : roots)
+		{
+			scene.MarkTransformDirty(root);
+			for (Entity child = root.GetFirstChild(); child; child = child.GetNextSibling())
+			{
+				checksum += scene.GetEntityTransform(child)[3].x;
+			}
+		}
+		LogDuration("Update transforms", entityCount, timer.Elapsed());
+
+		timer.Reset();
+		for (Entity root : roots)
+		{
+			scene.DestroyEntity(root);
+		}
+		LogDuration("Destroy", entityCount, timer.Elapsed());
+
+		ATLAS_CORE_TRACE("    Checksum: {0}, entities left: {1}", checksum, scene.GetEntityCount());
+	}
+
+	void PlayStart(uint32_t iterations)
+	{
+		static const uint32_t s_GroupSize = 8;
+		static const uint32_t s_EntityCounts[] = { 1000, 10000, 50000, 100000 };
+
+		ATLAS_CORE_INFO("Play start: scene copy, best of {0} runs", iterations);
+
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> translation(-100.0f, 100.0f);
+
+		for (uint32_t entityCount : s_EntityCounts)
+		{
+			Ref<Scene> scene = CreateRef<Scene>("Benchmark");
+			Entity root;
+			for (uint32_t i = 0; i < entityCount; i++)
+			{
+				Entity entity = i % s_GroupSize == 0 ? scene->CreateEntity() : scene->CreateEntity(std::string(), root);
+				entity.GetComponent<TransformComponent>().Translation = { translation(random), translation(random), translation(random) };
+				entity.AddComponent<SpriteRendererComponent>();
+				scene->MarkTransformDirty(entity);
+
+				if (i % s_GroupSize == 0)
+				{
+					root = entity;
+				}
+			}
+
+			float bestSeconds = FLT_MAX;
+			uint32_t copiedCount = 0;
+			for (uint32_t iteration = 0; iteration < iterations; iteration++)
+			{
+				Timer timer;
+				Ref<Scene> copy = Scene::Copy(scene);
+				bestSeconds = glm::min(bestSeconds, timer.Elapsed());
+
+				// Destroyed once timed
+				copiedCount = copy->GetEntityCount();
+			}
+
+			ATLAS_CORE_INFO("  {0} entities: {1:.3f} ms, {2:.1f} ns each", copiedCount, bestSeconds * 1000.0f, bestSeconds * 1e9f / entityCount);
+		}
+	}
+
+	static void LogCheck(const char* name, bool isPassed)
+	{
+		if (isPassed)
+		{
+			ATLAS_CORE_INFO("  {0}: passed", name);
+		}
+		else
+		{
+			ATLAS_CORE_ERROR("  {0}: FAILED", name);
+		}
+	}
+
+	// Spawns four jobs per level and waits on them from inside a job
+	static void SpawnNestedJobs(uint32_t depth, std::atomic<uint32_t>& leafCount)
+	{
+		if (depth == 0)
+		{
+			leafCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		JobCounter counter;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			JobSystem::Execute([depth, &leafCount]() { SpawnNestedJobs(depth - 1, leafCount); }, &counter);
+		}
+		JobSystem::Wait(counter);
+	}
+
+	void JobSystemStress(uint32_t rounds)
+	{
+		static const uint32_t s_SmallJobCount  = 20000;
+		static const uint32_t s_NestedDepth    = 6;
+		static const uint32_t s_ChainLength    = 1000;
+		static const uint32_t s_MainThreadJobs = 100;
+		static const uint32_t s_RangeCount     = 1000003; // Not a multiple of the batch size
+
+		ATLAS_CORE_INFO("Job system stress: {0} workers, {1} rounds", JobSystem::GetWorkerCount(), rounds);
+
+		Timer timer;
+		bool isSmallJobsPassed = true, isNestedPassed = true, isChainPassed = true, isMainThreadPassed = true, isParallelForPassed = true;
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			{
+				std::atomic<uint64_t> sum = { 0 };
+				JobCounter counter;
+				for (uint32_t i = 0; i < s_SmallJobCount; i++)
+				{
+					JobSystem::Execute([i, &sum]() { sum.fetch_add(i, std::memory_order_relaxed); }, &counter);
+				}
+				JobSystem::Wait(counter);
+				isSmallJobsPassed &= sum == (uint64_t)s_SmallJobCount * (s_SmallJobCount - 1) / 2;
+			}
+
+			{
+				std::atomic<uint32_t> leafCount = { 0 };
+				JobCounter counter;
+				JobSystem::Execute([&leafCount]() { SpawnNestedJobs(s_NestedDepth, leafCount); }, &counter);
+				JobSystem::Wait(counter);
+				isNestedPassed &= leafCount == 1u << (2 * s_NestedDepth);
+			}
+
+			{
+				// Each job only starts once the previous one is done, so they record their index in order
+				std::vector<Scope<JobCounter>> counters;
+				std::vector<uint32_t> order;
+				for (uint32_t i = 0; i < s_ChainLength; i++)
+				{
+					counters.push_back(CreateScope<JobCounter>());
+				}
+
+				JobSystem::Execute([&order]() { order.push_back(0); }, counters[0].get());
+				for (uint32_t i = 1; i < s_ChainLength; i++)
+				{
+					JobSystem::ExecuteAfter(*counters[i - 1], [i, &order]() { order.push_back(i); }, counters[i].get());
+				}
+				JobSystem::Wait(*counters.back());
+
+				for (uint32_t i = 0; i < s_ChainLength; i++)
+				{
+					isChainPassed &= i < order.size() && order[i] == i;
+				}
+			}
+
+			{
+				std::atomic<uint32_t> mainThreadCount = { 0 };
+				JobCounter counter;
+				for (uint32_t i = 0; i < s_MainThreadJobs; i++)
+				{
+					JobSystem::Execute([&mainThreadCount, &counter]()
+					{
+						JobSystem::ExecuteOnMainThread([&mainThreadCount]() { mainThreadCount += JobSystem::IsMainThread() ? 1 : 0; }, &counter);
+					}, &counter);
+				}
+				JobSystem::Wait(counter);
+				isMainThreadPassed &= mainThreadCount == s_MainThreadJobs;
+			}
+
+			{
+				std::vector<uint8_t> visitCounts(s_RangeCount, 0);
+				JobSystem::ParallelFor(s_RangeCount, 4096, [&visitCounts](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; i++)
+					{
+						visitCounts[i]++;
+					}
+				});
+				isParallelForPassed &= std::all_of(visitCounts.begin(), visitCounts.end(), [](uint8_t visitCount) { return visitCount == 1; });
+			}
+		}
+
+		LogCheck("Small jobs", isSmallJobsPassed);
+		LogCheck("Nested waits", isNestedPassed);
+		LogCheck("Dependency chain", isChainPassed);
+		LogCheck("Main thread jobs", isMainThreadPassed);
+		LogCheck("Parallel for", isParallelForPassed);
+		ATLAS_CORE_TRACE("    Total: {0:.3f} ms", timer.ElapsedMillis());
+	}
+
+	void JobSystemScaling(uint32_t transformCount, uint32_t iterations)
+	{
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> translation(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> rotation(-glm::pi<float>(), glm::pi<float>());
+
+		std::vector<TransformComponent> transforms(transformCount);
+		for (TransformComponent& transform : transforms)
+		{
+			transform.Translation = { translation(random), translation(random), translation(random) };
+			transform.Rotation    = { rotation(random), rotation(random), rotation(random) };
+		}
+		std::vector<glm::mat4> matrices(transformCount);
+
+		uint32_t defaultWorkerCount = JobSystem::GetWorkerCount();
+		ATLAS_CORE_INFO("Job system scaling: {0} transforms, best of {1} runs", transformCount, iterations);
+
+		std::vector<uint32_t> workerCounts = { 0 };
+		for (uint32_t workerCount = 1; workerCount < defaultWorkerCount; workerCount *= 2)
+		{
+			workerCounts.push_back(workerCount);
+		}
+		if (defaultWorkerCount > 0)
+		{
+			workerCounts.push_back(defaultWorkerCount);
+		}
+
+		float singleThreadSeconds = 0.0f;
+		for (uint32_t workerCount : workerCounts)
+		{
+			JobSystem::Shutdown();
+			JobSystem::Init(workerCount);
+
+			float bestSeconds = FLT_MAX;
+			for (uint32_t iteration = 0; iteration < iterations; iteration++)
+			{
+				Timer timer;
+				JobSystem::ParallelFor(transformCount, 4096, [&transforms, &matrices](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; i++)
+					{
+						matrices[i] = transforms[i].GetTransform();
+					}
+				});
+				bestSeconds = glm::min(bestSeconds, timer.Elapsed());
+			}
+
+			if (workerCount == 0)
+			{
+				singleThreadSeconds = bestSeconds;
+			}
+
+			ATLAS_CORE_INFO("  {0} workers: {1:.3f} ms, {2:.2f}x", workerCount, bestSeconds * 1000.0f, singleThreadSeconds / bestSeconds);
+		}
+
+		JobSystem::Shutdown();
+		JobSystem::Init(defaultWorkerCount);
+
+		ATLAS_CORE_TRACE("    Checksum: {0}", matrices[transformCount / 2][3].x);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+namespace Atlas::Benchmark
+{
+	// Micro-benchmarks run on demand (editor Benchmark menu), results go to the core log
+
+	// Matrices per second of the TransformComponent::GetTransform glm path and of every supported TransformBatch path
+	void TransformComposition(uint32_t matrixCount = 100000, uint32_t iterations = 20);
+
+	// Creates entities in a fresh scene (groups of one parent and seven children), walks and updates them through their
+	// handles and hierarchy links, then destroys them
+	void EntityLifecycle(uint32_t entityCount = 1000000);
+
+	// Scene::Copy (what pressing Play does) on scenes of growing size: sprites in groups of one parent and seven children
+	void PlayStart(uint32_t iterations = 10);
+
+	// Job system correctness under load: many small jobs, nested waits, dependency chains, main thread jobs and
+	// parallel-for coverage, each checked against the expected result
+	void JobSystemStress(uint32_t rounds = 20);
+
+	// Parallel-for over transform compositions with 0, 1, 2, 4... workers, up to the default count. Restarts the job
+	// system for each count, so must not run while jobs are in flight.
+	void JobSystemScaling(uint32_t transformCount = 1000000, uint32_t iterations = 10);
+}
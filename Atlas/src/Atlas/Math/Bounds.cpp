@@ -0,0 +1,155 @@
+#include "atlaspch.h"
+#include "Atlas/Math/Bounds.h"
+
+namespace Atlas
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// AABB ////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	AABB AABB::Transform(const glm::mat4& transform) const
+	{
+		// Arvo: the transformed extents are the extents projected on the absolute basis vectors
+		glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+		glm::vec3 extents = GetExtents();
+
+		glm::vec3 transformedExtents =
+			glm::abs(glm::vec3(transform[0])) * extents.x +
+			glm::abs(glm::vec3(transform[1])) * extents.y +
+			glm::abs(glm::vec3(transform[2])) * extents.z;
+
+		return AABB(center - transformedExtents, center + transformedExtents);
+	}
+
+	float AABB::GetSurfaceArea() const
+	{
+		glm::vec3 size = Max - Min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	bool AABB::Contains(const AABB& other) const
+	{
+		return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::greaterThanEqual(Max, other.Max));
+	}
+
+	bool AABB::Intersects(const AABB& other) const
+	{
+		return glm::all(glm::lessThanEqual(Min, other.Max)) && glm::all(glm::greaterThanEqual(Max, other.Min));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// BoundingSphere //////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	BoundingSphere BoundingSphere::Transform(const glm::mat4& transform) const
+	{
+		float scale = glm::sqrt(glm::max(glm::max(
+			glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+			glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1]))),
+			glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))));
+
+		return BoundingSphere(glm::vec3(transform * glm::vec4(Center, 1.0f)), Radius * scale);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Ray /////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	bool Ray::Intersects(const AABB& box, float& distance) const
+	{
+		// Slab test, a zero direction component divides to infinity and the comparisons still hold
+		glm::vec3 inverseDirection = 1.0f / Direction;
+		glm::vec3 t0 = (box.Min - Origin) * inverseDirection;
+		glm::vec3 t1 = (box.Max - Origin) * inverseDirection;
+
+		glm::vec3 tMin = glm::min(t0, t1);
+		glm::vec3 tMax = glm::max(t0, t1);
+
+		float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+		float exit  = glm::min(glm::min(tMax.x, tMax.y), tMax.z);
+
+		if (enter > exit)
+		{
+			return false;
+		}
+
+		distance = enter;
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Frustum /////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		// Gribb & Hartmann: combinations of the rows of the view projection (glm is column major)
+		glm::vec4 row0 = glm::vec4(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+		glm::vec4 row1 = glm::vec4(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+		glm::vec4 row2 = glm::vec4(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+		glm::vec4 row3 = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+		m_Planes[0] = row3 + row0; // Left
+		m_Planes[1] = row3 - row0; // Right
+		m_Planes[2] = row3 + row1; // Bottom
+		m_Planes[3] = row3 - row1; // Top
+		m_Planes[4] = row3 + row2; // Near
+		m_Planes[5] = row3 - row2; // Far
+
+		for (glm::vec4& plane : m_Planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+	}
+
+	bool Frustum::Intersects(const AABB& box) const
+	{
+		glm::vec3 center  = box.GetCenter();
+		glm::vec3 extents = box.GetExtents();
+
+		for (const glm::vec4& plane : m_Planes)
+		{
+			glm::vec3 normal = glm::vec3(plane);
+
+			// Outside if even the corner furthest along the normal is behind the plane
+			if (glm::dot(normal, center) + glm::dot(glm::abs(normal), extents) + plane.w < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Frustum::Contains(const AABB& box) const
+	{
+		glm::vec3 center  = box.GetCenter();
+		glm::vec3 extents = box.GetExtents();
+
+		for (const glm::vec4& plane : m_Planes)
+		{
+			glm::vec3 normal = glm::vec3(plane);
+
+			// Inside only if even the corner furthest against the normal is in front of the plane
+			if (glm::dot(normal, center) - glm::dot(glm::abs(normal), extents) + plane.w < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Frustum::Intersects(const BoundingSphere& sphere) const
+	{
+		for (const glm::vec4& plane : m_Planes)
+		{
+			if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
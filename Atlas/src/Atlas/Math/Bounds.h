@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Atlas
+{
+	struct AABB
+	{
+		glm::vec3 Min = glm::vec3(0.0f);
+		glm::vec3 Max = glm::vec3(0.0f);
+
+		AABB() = default;
+		AABB(const glm::vec3& min, const glm::vec3& max)
+			: Min(min), Max(max) {}
+
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+		float GetSurfaceArea() const;
+
+		bool Contains(const AABB& other) const;
+		bool Intersects(const AABB& other) const;
+
+		AABB Expand(float margin) const { return AABB(Min - glm::vec3(margin), Max + glm::vec3(margin)); }
+		static AABB Union(const AABB& a, const AABB& b) { return AABB(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max)); }
+
+		// Smallest box containing this one once transformed (keeps boxes tight under rotation, unlike the sphere)
+		AABB Transform(const glm::mat4& transform) const;
+	};
+
+	struct BoundingSphere
+	{
+		glm::vec3 Center = glm::vec3(0.0f);
+		float Radius = 0.0f;
+
+		BoundingSphere() = default;
+		BoundingSphere(const glm::vec3& center, float radius)
+			: Center(center), Radius(radius) {}
+
+		// Scales the radius by the largest axis scale
+		BoundingSphere Transform(const glm::mat4& transform) const;
+	};
+
+	struct Ray
+	{
+		glm::vec3 Origin = glm::vec3(0.0f);
+		glm::vec3 Direction = glm::vec3(0.0f, 0.0f, -1.0f);
+
+		Ray() = default;
+		Ray(const glm::vec3& origin, const glm::vec3& direction)
+			: Origin(origin), Direction(direction) {}
+
+		// Distance is along the direction, in multiples of its length (0 when the origin is inside the box)
+		bool Intersects(const AABB& box, float& distance) const;
+	};
+
+	// The six clip planes of a view projection, pointing inwards
+	class Frustum
+	{
+	public:
+		Frustum() = default;
+		Frustum(const glm::mat4& viewProjection);
+
+		// Conservative: may report boxes near the frustum corners as intersecting
+		bool Intersects(const AABB& box) const;
+		bool Intersects(const BoundingSphere& sphere) const;
+		// True when the box is entirely inside, so anything it holds needs no further test
+		bool Contains(const AABB& box) const;
+
+		// Distance in front of the near plane, along the view direction
+		float GetDepth(const glm::vec3& point) const { return glm::dot(glm::vec3(m_Planes[4]), point) + m_Planes[4].w; }
+
+	private:
+		glm::vec4 m_Planes[6]; // xyz: normal, w: distance
+	};
+}
@@ -0,0 +1,278 @@
+#include "atlaspch.h"
+#include "Atlas/Math/DynamicAABBTree.h"
+
+namespace Atlas
+{
+	DynamicAABBTree::DynamicAABBTree(float margin)
+		: m_Margin(margin)
+	{
+	}
+
+	int32_t DynamicAABBTree::CreateProxy(const AABB& box, uint32_t userData)
+	{
+		int32_t proxyID = AllocateNode();
+
+		Node& node = m_Nodes[proxyID];
+		node.Box      = box.Expand(m_Margin);
+		node.UserData = userData;
+		node.Height   = 0;
+
+		InsertLeaf(proxyID);
+		m_ProxyCount++;
+
+		return proxyID;
+	}
+
+	void DynamicAABBTree::DestroyProxy(int32_t proxyID)
+	{
+		ATLAS_CORE_ASSERT(proxyID >= 0 && proxyID < (int32_t)m_Nodes.size() && m_Nodes[proxyID].IsLeaf(), "Invalid proxy!");
+
+		RemoveLeaf(proxyID);
+		FreeNode(proxyID);
+		m_ProxyCount--;
+	}
+
+	bool DynamicAABBTree::MoveProxy(int32_t proxyID, const AABB& box)
+	{
+		ATLAS_CORE_ASSERT(proxyID >= 0 && proxyID < (int32_t)m_Nodes.size() && m_Nodes[proxyID].IsLeaf(), "Invalid proxy!");
+
+		const AABB& treeBox = m_Nodes[proxyID].Box;
+		AABB fatBox = box.Expand(m_Margin);
+
+		// Still inside its enlarged box, unless that box became much larger than the proxy (it shrank)
+		if (treeBox.Contains(box) && fatBox.Expand(4.0f * m_Margin).Contains(treeBox))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxyID);
+		m_Nodes[proxyID].Box = fatBox;
+		InsertLeaf(proxyID);
+
+		return true;
+	}
+
+	void DynamicAABBTree::Clear()
+	{
+		m_Nodes.clear();
+		m_Root       = NullNode;
+		m_FreeList   = NullNode;
+		m_ProxyCount = 0;
+	}
+
+	int32_t DynamicAABBTree::AllocateNode()
+	{
+		if (m_FreeList == NullNode)
+		{
+			m_Nodes.emplace_back();
+			return (int32_t)m_Nodes.size() - 1;
+		}
+
+		int32_t node = m_FreeList;
+		m_FreeList = m_Nodes[node].Parent;
+		m_Nodes[node] = Node();
+
+		return node;
+	}
+
+	void DynamicAABBTree::FreeNode(int32_t node)
+	{
+		m_Nodes[node].Parent = m_FreeList;
+		m_Nodes[node].Height = -1;
+		m_FreeList = node;
+	}
+
+	void DynamicAABBTree::InsertLeaf(int32_t leaf)
+	{
+		if (m_Root == NullNode)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].Parent = NullNode;
+			return;
+		}
+
+		// Find the best sibling: descend while it is cheaper (in surface area) than pairing with the current node
+		AABB leafBox = m_Nodes[leaf].Box;
+		int32_t index = m_Root;
+
+		while (!m_Nodes[index].IsLeaf())
+		{
+			const Node& node = m_Nodes[index];
+
+			float area         = node.Box.GetSurfaceArea();
+			float combinedArea = AABB::Union(node.Box, leafBox).GetSurfaceArea();
+
+			// Cost of a new parent for this node and the leaf, and the minimum cost of going further down
+			float cost            = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float childCosts[2];
+			int32_t children[2] = { node.Child1, node.Child2 };
+			for (int i = 0; i < 2; i++)
+			{
+				const Node& child = m_Nodes[children[i]];
+				float unionArea = AABB::Union(child.Box, leafBox).GetSurfaceArea();
+				childCosts[i] = (child.IsLeaf() ? unionArea : unionArea - child.Box.GetSurfaceArea()) + inheritanceCost;
+			}
+
+			if (cost < childCosts[0] && cost < childCosts[1])
+			{
+				break;
+			}
+
+			index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+		}
+
+		int32_t sibling   = index;
+		int32_t oldParent = m_Nodes[sibling].Parent;
+		int32_t newParent = AllocateNode(); // May reallocate the nodes, no references are held across it
+
+		m_Nodes[newParent].Parent = oldParent;
+		m_Nodes[newParent].Box    = AABB::Union(leafBox, m_Nodes[sibling].Box);
+		m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+		m_Nodes[newParent].Child1 = sibling;
+		m_Nodes[newParent].Child2 = leaf;
+		m_Nodes[sibling].Parent   = newParent;
+		m_Nodes[leaf].Parent      = newParent;
+
+		if (oldParent == NullNode)
+		{
+			m_Root = newParent;
+		}
+		else if (m_Nodes[oldParent].Child1 == sibling)
+		{
+			m_Nodes[oldParent].Child1 = newParent;
+		}
+		else
+		{
+			m_Nodes[oldParent].Child2 = newParent;
+		}
+
+		RefitAncestors(m_Nodes[leaf].Parent);
+	}
+
+	void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		int32_t parent      = m_Nodes[leaf].Parent;
+		int32_t grandParent = m_Nodes[parent].Parent;
+		int32_t sibling     = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+		// The sibling takes the parent's place
+		m_Nodes[sibling].Parent = grandParent;
+		FreeNode(parent);
+
+		if (grandParent == NullNode)
+		{
+			m_Root = sibling;
+			return;
+		}
+
+		if (m_Nodes[grandParent].Child1 == parent)
+		{
+			m_Nodes[grandParent].Child1 = sibling;
+		}
+		else
+		{
+			m_Nodes[grandParent].Child2 = sibling;
+		}
+
+		RefitAncestors(grandParent);
+	}
+
+	void DynamicAABBTree::RefitAncestors(int32_t node)
+	{
+		while (node != NullNode)
+		{
+			node = Balance(node);
+
+			Node& current = m_Nodes[node];
+			const Node& child1 = m_Nodes[current.Child1];
+			const Node& child2 = m_Nodes[current.Child2];
+
+			current.Box    = AABB::Union(child1.Box, child2.Box);
+			current.Height = 1 + std::max(child1.Height, child2.Height);
+
+			node = current.Parent;
+		}
+	}
+
+	int32_t DynamicAABBTree::Balance(int32_t indexA)
+	{
+		// Rotates the taller child up when the heights differ by more than one, returns the new subtree root
+		Node& a = m_Nodes[indexA];
+		if (a.IsLeaf() || a.Height < 2)
+		{
+			return indexA;
+		}
+
+		int32_t indexB = a.Child1;
+		int32_t indexC = a.Child2;
+		Node& b = m_Nodes[indexB];
+		Node& c = m_Nodes[indexC];
+
+		int32_t balance = c.Height - b.Height;
+		if (balance >= -1 && balance <= 1)
+		{
+			return indexA;
+		}
+
+		// Up is the taller child, Other its sibling; Up's shorter child moves under A
+		int32_t indexUp    = balance > 1 ? indexC : indexB;
+		int32_t indexOther = balance > 1 ? indexB : indexC;
+		Node& up    = m_Nodes[indexUp];
+		Node& other = m_Nodes[indexOther];
+
+		int32_t indexF = up.Child1;
+		int32_t indexG = up.Child2;
+		Node& f = m_Nodes[indexF];
+		Node& g = m_Nodes[indexG];
+
+		// Swap A and Up
+		up.Child1 = indexA;
+		up.Parent = a.Parent;
+		a.Parent  = indexUp;
+
+		if (up.Parent == NullNode)
+		{
+			m_Root = indexUp;
+		}
+		else if (m_Nodes[up.Parent].Child1 == indexA)
+		{
+			m_Nodes[up.Parent].Child1 = indexUp;
+		}
+		else
+		{
+			m_Nodes[up.Parent].Child2 = indexUp;
+		}
+
+		int32_t indexKept  = f.Height > g.Height ? indexF : indexG;
+		int32_t indexMoved = f.Height > g.Height ? indexG : indexF;
+		Node& kept  = m_Nodes[indexKept];
+		Node& moved = m_Nodes[indexMoved];
+
+		up.Child2    = indexKept;
+		moved.Parent = indexA;
+
+		if (balance > 1)
+		{
+			a.Child2 = indexMoved;
+		}
+		else
+		{
+			a.Child1 = indexMoved;
+		}
+
+		a.Box     = AABB::Union(other.Box, moved.Box);
+		a.Height  = 1 + std::max(other.Height, moved.Height);
+		up.Box    = AABB::Union(a.Box, kept.Box);
+		up.Height = 1 + std::max(a.Height, kept.Height);
+
+		return indexUp;
+	}
+}
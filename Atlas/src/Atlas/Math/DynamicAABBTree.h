@@ -0,0 +1,236 @@
+#pragma once
+
+#include "Atlas/Math/Bounds.h"
+
+#include <cfloat>
+
+namespace Atlas
+{
+	// Bounding volume hierarchy over moving boxes. Leaves store a box enlarged by a margin, so small moves don't touch
+	// the tree, and larger ones are a remove and reinsert (O(log n), the tree is kept balanced by rotations).
+	class DynamicAABBTree
+	{
+	public:
+		static const int32_t NullNode = -1;
+
+		DynamicAABBTree(float margin = 0.1f);
+
+		// Returns the proxy ID, stable until the proxy is destroyed
+		int32_t CreateProxy(const AABB& box, uint32_t userData);
+		void DestroyProxy(int32_t proxyID);
+		// Returns true if the proxy had to be reinserted
+		bool MoveProxy(int32_t proxyID, const AABB& box);
+		void Clear();
+
+		uint32_t GetUserData(int32_t proxyID) const { return m_Nodes[proxyID].UserData; }
+		const AABB& GetFatAABB(int32_t proxyID) const { return m_Nodes[proxyID].Box; }
+		uint32_t GetProxyCount() const { return m_ProxyCount; }
+		int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+
+		// Callbacks return false to stop the query early.
+		// Leaves are tested with their enlarged box, so results may include boxes slightly outside the volume.
+		template<typename Callback>
+		void Query(const Frustum& frustum, Callback&& callback) const;
+		template<typename Callback>
+		void Query(const AABB& box, Callback&& callback) const;
+
+		// The callback receives the user data and hit distance of every leaf box the ray enters, nearest subtrees first,
+		// and returns the new maximum distance: the hit distance to only look for closer hits, 0 to stop.
+		template<typename Callback>
+		void RayCast(const Ray& ray, float maxDistance, Callback&& callback) const;
+
+	private:
+		struct Node
+		{
+			AABB Box;
+			int32_t Parent = NullNode; // Next free node while the node is unused
+			int32_t Child1 = NullNode;
+			int32_t Child2 = NullNode;
+			int32_t Height = -1;       // 0 for leaves, -1 for free nodes
+			uint32_t UserData = 0;
+
+			bool IsLeaf() const { return Child1 == NullNode; }
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t node);
+
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		void RefitAncestors(int32_t node);
+		int32_t Balance(int32_t node);
+
+		template<typename Callback>
+		bool ReportSubtree(int32_t node, Callback& callback, std::vector<int32_t>& stack) const;
+
+		float m_Margin;
+		int32_t m_Root = NullNode;
+		int32_t m_FreeList = NullNode;
+		uint32_t m_ProxyCount = 0;
+		std::vector<Node> m_Nodes;
+	};
+
+	template<typename Callback>
+	void DynamicAABBTree::Query(const Frustum& frustum, Callback&& callback) const
+	{
+		if (m_Root == NullNode)
+		{
+			return;
+		}
+
+		std::vector<int32_t> stack;
+		stack.reserve(64);
+		stack.push_back(m_Root);
+
+		while (!stack.empty())
+		{
+			int32_t index = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_Nodes[index];
+			if (!frustum.Intersects(node.Box))
+			{
+				continue;
+			}
+
+			// Whole subtree is visible, skip the plane tests below it
+			if (node.IsLeaf() || frustum.Contains(node.Box))
+			{
+				if (!ReportSubtree(index, callback, stack))
+				{
+					return;
+				}
+
+				continue;
+			}
+
+			stack.push_back(node.Child1);
+			stack.push_back(node.Child2);
+		}
+	}
+
+	template<typename Callback>
+	void DynamicAABBTree::Query(const AABB& box, Callback&& callback) const
+	{
+		if (m_Root == NullNode)
+		{
+			return;
+		}
+
+		std::vector<int32_t> stack;
+		stack.reserve(64);
+		stack.push_back(m_Root);
+
+		while (!stack.empty())
+		{
+			int32_t index = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_Nodes[index];
+			if (!node.Box.Intersects(box))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				if (!callback(node.UserData))
+				{
+					return;
+				}
+
+				continue;
+			}
+
+			stack.push_back(node.Child1);
+			stack.push_back(node.Child2);
+		}
+	}
+
+	template<typename Callback>
+	void DynamicAABBTree::RayCast(const Ray& ray, float maxDistance, Callback&& callback) const
+	{
+		if (m_Root == NullNode)
+		{
+			return;
+		}
+
+		std::vector<int32_t> stack;
+		stack.reserve(64);
+		stack.push_back(m_Root);
+
+		while (!stack.empty())
+		{
+			int32_t index = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_Nodes[index];
+			float distance;
+			if (!ray.Intersects(node.Box, distance) || distance > maxDistance)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				maxDistance = callback(node.UserData, distance);
+				if (maxDistance <= 0.0f)
+				{
+					return;
+				}
+
+				continue;
+			}
+
+			// Visit the nearer child first so the maximum distance shrinks sooner
+			float distance1 = FLT_MAX;
+			float distance2 = FLT_MAX;
+			bool hit1 = ray.Intersects(m_Nodes[node.Child1].Box, distance1);
+			bool hit2 = ray.Intersects(m_Nodes[node.Child2].Box, distance2);
+
+			if (hit1 && hit2)
+			{
+				stack.push_back(distance1 <= distance2 ? node.Child2 : node.Child1);
+				stack.push_back(distance1 <= distance2 ? node.Child1 : node.Child2);
+			}
+			else if (hit1)
+			{
+				stack.push_back(node.Child1);
+			}
+			else if (hit2)
+			{
+				stack.push_back(node.Child2);
+			}
+		}
+	}
+
+	template<typename Callback>
+	bool DynamicAABBTree::ReportSubtree(int32_t node, Callback& callback, std::vector<int32_t>& stack) const
+	{
+		// Shares the query stack: everything pushed here is popped before returning
+		size_t base = stack.size();
+		stack.push_back(node);
+
+		while (stack.size() > base)
+		{
+			int32_t index = stack.back();
+			stack.pop_back();
+
+			const Node& current = m_Nodes[index];
+			if (current.IsLeaf())
+			{
+				if (!callback(current.UserData))
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			stack.push_back(current.Child1);
+			stack.push_back(current.Child2);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+namespace Atlas
+{
+	// Maps a float to an unsigned key with the same ordering (negative values included)
+	inline uint32_t GetSortableFloatKey(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(float));
+
+		// Positive: set the sign bit so they come after negatives. Negative: flip everything so larger magnitudes come first
+		return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+	}
+
+	// Stable LSD radix sort on an unsigned integer key, one pass per key byte. Passes where every key has the same byte
+	// are skipped, so keys that only use a few bits cost fewer passes. The scratch buffer is kept to avoid reallocations.
+	template<typename T, typename GetKey>
+	void RadixSort(std::vector<T>& items, std::vector<T>& scratch, GetKey&& getKey)
+	{
+		using Key = std::invoke_result_t<GetKey, const T&>;
+		static_assert(std::is_unsigned_v<Key>, "Radix sort keys must be unsigned integers");
+		constexpr uint32_t keyByteCount = sizeof(Key);
+
+		size_t count = items.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		// One histogram per key byte, all filled in a single pass
+		std::array<std::array<uint32_t, 256>, keyByteCount> histograms = {};
+		for (const T& item : items)
+		{
+			Key key = getKey(item);
+			for (uint32_t byte = 0; byte < keyByteCount; byte++)
+			{
+				histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+			}
+		}
+
+		scratch.resize(count);
+		T* source      = items.data();
+		T* destination = scratch.data();
+
+		for (uint32_t byte = 0; byte < keyByteCount; byte++)
+		{
+			std::array<uint32_t, 256>& histogram = histograms[byte];
+
+			// Every key has the same value for this byte: the pass would not move anything
+			if (histogram[(getKey(source[0]) >> (byte * 8)) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram)
+			{
+				uint32_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				destination[histogram[(getKey(source[i]) >> (byte * 8)) & 0xFF]++] = source[i];
+			}
+
+			std::swap(source, destination);
+		}
+
+		if (source != items.data())
+		{
+			items.swap(scratch);
+		}
+	}
+}
@@ -0,0 +1,296 @@
+#include "atlaspch.h"
+#include "Atlas/Math/TransformBatch.h"
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+	// MSVC accepts any intrinsic without /arch, the CPU check is done at runtime
+	#define ATLAS_TARGET_SSE41
+	#define ATLAS_TARGET_AVX2
+#else
+	#define ATLAS_TARGET_SSE41 __attribute__((target("sse4.1")))
+	#define ATLAS_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+namespace Atlas::Math
+{
+	// Cephes sinf/cosf: reduction to [-pi/4, pi/4] in three steps (Cody-Waite), then a minimax polynomial per quadrant
+	static constexpr float s_TwoOverPi = 0.636619772367581343f;
+	static constexpr float s_PiOverTwo[3] = { 1.5703125f, 4.837512969970703125e-4f, 7.54978995489188216e-8f };
+	static constexpr float s_SinCoefficients[3] = { -1.6666654611e-1f, 8.3321608736e-3f, -1.9515295891e-4f };
+	static constexpr float s_CosCoefficients[3] = { 4.166664568298827e-2f, -1.388731625493765e-3f, 2.443315711809948e-5f };
+
+	void TransformBatch::Clear()
+	{
+		for (std::vector<float>& component : m_Components)
+		{
+			component.clear();
+		}
+
+		m_Count = 0;
+	}
+
+	void TransformBatch::Reserve(uint32_t count)
+	{
+		for (std::vector<float>& component : m_Components)
+		{
+			component.reserve(count);
+		}
+	}
+
+	void TransformBatch::Add(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			m_Components[TranslationX + axis].push_back(translation[axis]);
+			m_Components[RotationX + axis].push_back(rotation[axis]);
+			m_Components[ScaleX + axis].push_back(scale[axis]);
+		}
+
+		m_Count++;
+	}
+
+	// Components are indexed in TransformBatch::Component order: translation, rotation then scale, x y z each.
+	// The rotation is glm::toMat4(glm::quat(euler)), that is Rz * Ry * Rx, expanded from the full angles.
+	static void ComposeScalar(const std::vector<float>* components, glm::mat4* matrices, uint32_t first, uint32_t count)
+	{
+		for (uint32_t i = first; i < count; i++)
+		{
+			float sx = std::sin(components[3][i]), cx = std::cos(components[3][i]);
+			float sy = std::sin(components[4][i]), cy = std::cos(components[4][i]);
+			float sz = std::sin(components[5][i]), cz = std::cos(components[5][i]);
+			float scaleX = components[6][i], scaleY = components[7][i], scaleZ = components[8][i];
+
+			glm::mat4& matrix = matrices[i];
+			matrix[0] = glm::vec4(cy * cz, cy * sz, -sy, 0.0f) * scaleX;
+			matrix[1] = glm::vec4(sx * sy * cz - cx * sz, sx * sy * sz + cx * cz, sx * cy, 0.0f) * scaleY;
+			matrix[2] = glm::vec4(cx * sy * cz + sx * sz, cx * sy * sz - sx * cz, cx * cy, 0.0f) * scaleZ;
+			matrix[3] = glm::vec4(components[0][i], components[1][i], components[2][i], 1.0f);
+		}
+	}
+
+	ATLAS_TARGET_SSE41 static void SinCos(__m128 x, __m128& sine, __m128& cosine)
+	{
+		__m128 quadrant = _mm_round_ps(_mm_mul_ps(x, _mm_set1_ps(s_TwoOverPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		__m128 r = _mm_sub_ps(x, _mm_mul_ps(quadrant, _mm_set1_ps(s_PiOverTwo[0])));
+		r = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(s_PiOverTwo[1])));
+		r = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(s_PiOverTwo[2])));
+
+		__m128 r2 = _mm_mul_ps(r, r);
+		__m128 s = _mm_add_ps(_mm_set1_ps(s_SinCoefficients[1]), _mm_mul_ps(r2, _mm_set1_ps(s_SinCoefficients[2])));
+		s = _mm_add_ps(_mm_set1_ps(s_SinCoefficients[0]), _mm_mul_ps(r2, s));
+		s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), s));
+		__m128 c = _mm_add_ps(_mm_set1_ps(s_CosCoefficients[1]), _mm_mul_ps(r2, _mm_set1_ps(s_CosCoefficients[2])));
+		c = _mm_add_ps(_mm_set1_ps(s_CosCoefficients[0]), _mm_mul_ps(r2, c));
+		c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_mul_ps(_mm_mul_ps(r2, r2), c));
+
+		// Odd quadrants swap sine and cosine, bit 1 of the quadrant flips the sine sign, bit 1 of the next one the cosine's
+		__m128i q = _mm_cvtps_epi32(quadrant);
+		__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		__m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+		__m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+		sine = _mm_xor_ps(_mm_blendv_ps(s, c, swap), sineSign);
+		cosine = _mm_xor_ps(_mm_blendv_ps(c, s, swap), cosineSign);
+	}
+
+	// Turns 4 lanes of one matrix column (x, y, z, w registers) into one column per matrix
+	ATLAS_TARGET_SSE41 static void StoreColumn(glm::mat4* matrices, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&matrices[0][column][0], x);
+		_mm_storeu_ps(&matrices[1][column][0], y);
+		_mm_storeu_ps(&matrices[2][column][0], z);
+		_mm_storeu_ps(&matrices[3][column][0], w);
+	}
+
+	ATLAS_TARGET_SSE41 static uint32_t ComposeSSE41(const std::vector<float>* components, glm::mat4* matrices, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 sx, cx, sy, cy, sz, cz;
+			SinCos(_mm_loadu_ps(&components[3][i]), sx, cx);
+			SinCos(_mm_loadu_ps(&components[4][i]), sy, cy);
+			SinCos(_mm_loadu_ps(&components[5][i]), sz, cz);
+			__m128 scaleX = _mm_loadu_ps(&components[6][i]);
+			__m128 scaleY = _mm_loadu_ps(&components[7][i]);
+			__m128 scaleZ = _mm_loadu_ps(&components[8][i]);
+
+			__m128 zero = _mm_setzero_ps();
+			__m128 sxsy = _mm_mul_ps(sx, sy);
+			__m128 cxsy = _mm_mul_ps(cx, sy);
+
+			StoreColumn(matrices + i, 0,
+				_mm_mul_ps(_mm_mul_ps(cy, cz), scaleX),
+				_mm_mul_ps(_mm_mul_ps(cy, sz), scaleX),
+				_mm_mul_ps(_mm_sub_ps(zero, sy), scaleX),
+				zero);
+			StoreColumn(matrices + i, 1,
+				_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sxsy, cz), _mm_mul_ps(cx, sz)), scaleY),
+				_mm_mul_ps(_mm_add_ps(_mm_mul_ps(sxsy, sz), _mm_mul_ps(cx, cz)), scaleY),
+				_mm_mul_ps(_mm_mul_ps(sx, cy), scaleY),
+				zero);
+			StoreColumn(matrices + i, 2,
+				_mm_mul_ps(_mm_add_ps(_mm_mul_ps(cxsy, cz), _mm_mul_ps(sx, sz)), scaleZ),
+				_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(cxsy, sz), _mm_mul_ps(sx, cz)), scaleZ),
+				_mm_mul_ps(_mm_mul_ps(cx, cy), scaleZ),
+				zero);
+			StoreColumn(matrices + i, 3,
+				_mm_loadu_ps(&components[0][i]),
+				_mm_loadu_ps(&components[1][i]),
+				_mm_loadu_ps(&components[2][i]),
+				_mm_set1_ps(1.0f));
+		}
+
+		return i;
+	}
+
+	ATLAS_TARGET_AVX2 static void SinCos(__m256 x, __m256& sine, __m256& cosine)
+	{
+		__m256 quadrant = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(s_TwoOverPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		__m256 r = _mm256_sub_ps(x, _mm256_mul_ps(quadrant, _mm256_set1_ps(s_PiOverTwo[0])));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(quadrant, _mm256_set1_ps(s_PiOverTwo[1])));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(quadrant, _mm256_set1_ps(s_PiOverTwo[2])));
+
+		__m256 r2 = _mm256_mul_ps(r, r);
+		__m256 s = _mm256_add_ps(_mm256_set1_ps(s_SinCoefficients[1]), _mm256_mul_ps(r2, _mm256_set1_ps(s_SinCoefficients[2])));
+		s = _mm256_add_ps(_mm256_set1_ps(s_SinCoefficients[0]), _mm256_mul_ps(r2, s));
+		s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), s));
+		__m256 c = _mm256_add_ps(_mm256_set1_ps(s_CosCoefficients[1]), _mm256_mul_ps(r2, _mm256_set1_ps(s_CosCoefficients[2])));
+		c = _mm256_add_ps(_mm256_set1_ps(s_CosCoefficients[0]), _mm256_mul_ps(r2, c));
+		c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))), _mm256_mul_ps(_mm256_mul_ps(r2, r2), c));
+
+		__m256i q = _mm256_cvtps_epi32(quadrant);
+		__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+		__m256 sineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+		__m256 cosineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+		sine = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sineSign);
+		cosine = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosineSign);
+	}
+
+	// Same as the SSE version, for 8 lanes: each 128 bit half is transposed on its own (matrices 0-3 and 4-7)
+	ATLAS_TARGET_AVX2 static void StoreColumn(glm::mat4* matrices, int column, __m256 x, __m256 y, __m256 z, __m256 w)
+	{
+		__m256 xy0 = _mm256_unpacklo_ps(x, y);
+		__m256 xy1 = _mm256_unpackhi_ps(x, y);
+		__m256 zw0 = _mm256_unpacklo_ps(z, w);
+		__m256 zw1 = _mm256_unpackhi_ps(z, w);
+
+		__m256 columns[4] = {
+			_mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2)),
+			_mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0)),
+			_mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2))
+		};
+
+		for (int i = 0; i < 4; i++)
+		{
+			_mm_storeu_ps(&matrices[i][column][0], _mm256_castps256_ps128(columns[i]));
+			_mm_storeu_ps(&matrices[i + 4][column][0], _mm256_extractf128_ps(columns[i], 1));
+		}
+	}
+
+	ATLAS_TARGET_AVX2 static uint32_t ComposeAVX2(const std::vector<float>* components, glm::mat4* matrices, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 sx, cx, sy, cy, sz, cz;
+			SinCos(_mm256_loadu_ps(&components[3][i]), sx, cx);
+			SinCos(_mm256_loadu_ps(&components[4][i]), sy, cy);
+			SinCos(_mm256_loadu_ps(&components[5][i]), sz, cz);
+			__m256 scaleX = _mm256_loadu_ps(&components[6][i]);
+			__m256 scaleY = _mm256_loadu_ps(&components[7][i]);
+			__m256 scaleZ = _mm256_loadu_ps(&components[8][i]);
+
+			__m256 zero = _mm256_setzero_ps();
+			__m256 sxsy = _mm256_mul_ps(sx, sy);
+			__m256 cxsy = _mm256_mul_ps(cx, sy);
+
+			StoreColumn(matrices + i, 0,
+				_mm256_mul_ps(_mm256_mul_ps(cy, cz), scaleX),
+				_mm256_mul_ps(_mm256_mul_ps(cy, sz), scaleX),
+				_mm256_mul_ps(_mm256_sub_ps(zero, sy), scaleX),
+				zero);
+			StoreColumn(matrices + i, 1,
+				_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(sxsy, cz), _mm256_mul_ps(cx, sz)), scaleY),
+				_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(sxsy, sz), _mm256_mul_ps(cx, cz)), scaleY),
+				_mm256_mul_ps(_mm256_mul_ps(sx, cy), scaleY),
+				zero);
+			StoreColumn(matrices + i, 2,
+				_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cxsy, cz), _mm256_mul_ps(sx, sz)), scaleZ),
+				_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(cxsy, sz), _mm256_mul_ps(sx, cz)), scaleZ),
+				_mm256_mul_ps(_mm256_mul_ps(cx, cy), scaleZ),
+				zero);
+			StoreColumn(matrices + i, 3,
+				_mm256_loadu_ps(&components[0][i]),
+				_mm256_loadu_ps(&components[1][i]),
+				_mm256_loadu_ps(&components[2][i]),
+				_mm256_set1_ps(1.0f));
+		}
+
+		// Avoids the AVX to SSE transition penalty in the code that follows
+		_mm256_zeroupper();
+
+		return i;
+	}
+
+	void TransformBatch::Compose(glm::mat4* matrices) const
+	{
+		Compose(matrices, GetSupportedInstructionSet());
+	}
+
+	void TransformBatch::Compose(glm::mat4* matrices, InstructionSet instructionSet) const
+	{
+		ATLAS_CORE_ASSERT(instructionSet <= GetSupportedInstructionSet(), "Instruction set not supported by this CPU!");
+
+		// SIMD paths stop at the last full register, the scalar path finishes the remaining triples
+		uint32_t first = 0;
+		switch (instructionSet)
+		{
+			case InstructionSet::AVX2:  first = ComposeAVX2(m_Components, matrices, m_Count);  break;
+			case InstructionSet::SSE41: first = ComposeSSE41(m_Components, matrices, m_Count); break;
+			case InstructionSet::Scalar: break;
+		}
+
+		ComposeScalar(m_Components, matrices, first, m_Count);
+	}
+
+	static TransformBatch::InstructionSet DetectInstructionSet()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool hasSSE41 = (info[2] & (1 << 19)) != 0;
+		// AVX also needs the OS to save the YMM registers (OSXSAVE, then XCR0 bits 1 and 2)
+		bool hasAVX = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+		bool hasAVX2 = false;
+		if (hasAVX && maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			hasAVX2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		bool hasSSE41 = __builtin_cpu_supports("sse4.1");
+		bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+
+		if (hasAVX2)
+		{
+			return TransformBatch::InstructionSet::AVX2;
+		}
+
+		return hasSSE41 ? TransformBatch::InstructionSet::SSE41 : TransformBatch::InstructionSet::Scalar;
+	}
+
+	TransformBatch::InstructionSet TransformBatch::GetSupportedInstructionSet()
+	{
+		static const InstructionSet s_InstructionSet = DetectInstructionSet();
+		return s_InstructionSet;
+	}
+}
\ No newline at end of file
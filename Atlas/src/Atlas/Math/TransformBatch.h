@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Atlas::Math
+{
+	// Translation / Euler rotation / scale triples stored as structure of arrays, so they are converted to matrices
+	// several at a time: 8 per step with AVX2, 4 with SSE4.1, one at a time otherwise (picked once, at runtime)
+	class TransformBatch
+	{
+	public:
+		enum class InstructionSet
+		{
+			Scalar = 0,
+			SSE41  = 1,
+			AVX2   = 2
+		};
+
+		void Clear();
+		void Reserve(uint32_t count);
+		void Add(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale);
+
+		uint32_t GetCount() const { return m_Count; }
+
+		// Writes translate(T) * toMat4(quat(R)) * scale(S) of every triple, in the order they were added. The matrices
+		// must hold GetCount() elements. SIMD paths use polynomial sine and cosine (within a few float ulps of std::sin).
+		void Compose(glm::mat4* matrices) const;
+		void Compose(glm::mat4* matrices, InstructionSet instructionSet) const;
+
+		// Best set both compiled in and supported by the CPU
+		static InstructionSet GetSupportedInstructionSet();
+
+	private:
+		enum Component
+		{
+			TranslationX = 0, TranslationY, TranslationZ,
+			RotationX, RotationY, RotationZ,
+			ScaleX, ScaleY, ScaleZ,
+			ComponentCount
+		};
+
+		std::vector<float> m_Components[ComponentCount];
+		uint32_t m_Count = 0;
+	};
+}
@@ -37,7 +37,22 @@ namespace Atlas
 		return nullptr;
 	}
 
-	Ref<IndexBuffer> IndexBuffer::Create(uint32_t size)
+	Ref<StreamingBuffer> StreamingBuffer::Create(uint32_t regionSize, uint32_t regionCount)
+	{
+		switch (RenderCommand::GetAPI())
+		{
+			case RendererAPI::API::None:
+				ATLAS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+				return nullptr;
+			case RendererAPI::API::OpenGL:
+				return CreateRef<OpenGLStreamingBuffer>(regionSize, regionCount);
+		}
+
+		ATLAS_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	Ref<IndexBuffer> IndexBuffer::Create(uint32_t size, IndexType type)
 	{
 		switch (RenderCommand::GetAPI())
 		{
@@ -45,7 +60,7 @@ namespace Atlas
 			ATLAS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
 			return nullptr;
 		case RendererAPI::API::OpenGL:
-			return CreateRef<OpenGLIndexBuffer>(size);
+			return CreateRef<OpenGLIndexBuffer>(size, type);
 		}
 
 		ATLAS_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -60,7 +75,37 @@ namespace Atlas
 				ATLAS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
 				return nullptr;
 			case RendererAPI::API::OpenGL:
-				return CreateRef<OpenGLIndexBuffer>(indices, size);
+				return CreateRef<OpenGLIndexBuffer>(indices, size, IndexType::UInt32);
+		}
+
+		ATLAS_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	Ref<IndexBuffer> IndexBuffer::Create(uint16_t* indices, uint32_t size)
+	{
+		switch (RenderCommand::GetAPI())
+		{
+			case RendererAPI::API::None:
+				ATLAS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+				return nullptr;
+			case RendererAPI::API::OpenGL:
+				return CreateRef<OpenGLIndexBuffer>(indices, size, IndexType::UInt16);
+		}
+
+		ATLAS_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	Ref<IndirectBuffer> IndirectBuffer::Create(uint32_t size)
+	{
+		switch (RenderCommand::GetAPI())
+		{
+		case RendererAPI::API::None:
+			ATLAS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+			return nullptr;
+		case RendererAPI::API::OpenGL:
+			return CreateRef<OpenGLIndirectBuffer>(size);
 		}
 
 		ATLAS_CORE_ASSERT(false, "Unknown RendererAPI!");
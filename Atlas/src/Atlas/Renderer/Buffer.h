@@ -16,7 +16,11 @@ namespace Atlas
 		Int2   = 9,
 		Int3   = 10,
 		Int4   = 11,
-		Bool   = 12
+		Bool   = 12,
+		// Compact vertex attributes, read as floats by shaders
+		UShort4 = 13,
+		Short2  = 14,
+		Half2   = 15
 	};
 
 	static uint32_t ShaderDataTypeSize(ShaderDataType type)
@@ -35,6 +39,9 @@ namespace Atlas
 			case ShaderDataType::Int3:     return 4 * 3;
 			case ShaderDataType::Int4:     return 4 * 4;
 			case ShaderDataType::Bool:     return 1;
+			case ShaderDataType::UShort4:  return 2 * 4;
+			case ShaderDataType::Short2:   return 2 * 2;
+			case ShaderDataType::Half2:    return 2 * 2;
 		}
 
 		ATLAS_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -72,6 +79,9 @@ namespace Atlas
 				case ShaderDataType::Int3:    return 3;
 				case ShaderDataType::Int4:    return 4;
 				case ShaderDataType::Bool:    return 1;
+				case ShaderDataType::UShort4: return 4;
+				case ShaderDataType::Short2:  return 2;
+				case ShaderDataType::Half2:   return 2;
 			}
 
 			ATLAS_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -90,6 +100,12 @@ namespace Atlas
 			CalculateOffsetAndStride();
 		}
 
+		BufferLayout(const std::vector<BufferElement>& elements)
+			: m_Elements(elements)
+		{
+			CalculateOffsetAndStride();
+		}
+
 		const std::vector<BufferElement>& GetElements() const { return m_Elements; }
 		uint32_t GetStride() const { return m_Stride; }
 
@@ -124,7 +140,7 @@ namespace Atlas
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
-		virtual void SetData(const void* data, uint32_t size) = 0;
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
 
 		virtual const BufferLayout& GetLayout() const = 0;
 		virtual void SetLayout(const BufferLayout& layout) = 0;
@@ -133,7 +149,41 @@ namespace Atlas
 		static Ref<VertexBuffer> Create(const void* data, uint32_t size);
 	};
 
-	// Currently only supports 32-bit index buffers
+	// Vertex buffer split into regions that stay mapped, so vertices are written straight into GPU-visible memory.
+	// Each batch takes the next region, only waiting if the GPU is still reading it from RegionCount batches ago.
+	class StreamingBuffer : public VertexBuffer
+	{
+	public:
+		// Mapped memory of the region to fill next, once the GPU is done with it
+		virtual void* MapRegion() = 0;
+		// Call once the draws reading the current region are submitted
+		virtual void FenceRegion() = 0;
+
+		// In bytes, draws reading the region start at GetRegionOffset() / stride
+		virtual uint32_t GetRegionOffset() const = 0;
+		virtual uint32_t GetRegionSize() const = 0;
+
+		static Ref<StreamingBuffer> Create(uint32_t regionSize, uint32_t regionCount = 3);
+	};
+
+	enum class IndexType
+	{
+		UInt16 = 0,
+		UInt32 = 1
+	};
+
+	static uint32_t IndexTypeSize(IndexType type)
+	{
+		switch (type)
+		{
+			case IndexType::UInt16: return 2;
+			case IndexType::UInt32: return 4;
+		}
+
+		ATLAS_CORE_ASSERT(false, "Unknown IndexType!");
+		return 0;
+	}
+
 	class IndexBuffer
 	{
 	public:
@@ -142,11 +192,38 @@ namespace Atlas
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
-		virtual void SetData(const void* data, uint32_t size) = 0;
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
 
 		virtual uint32_t GetMaxCount() const = 0;
+		virtual IndexType GetIndexType() const = 0;
 
-		static Ref<IndexBuffer> Create(uint32_t size);
+		static Ref<IndexBuffer> Create(uint32_t size, IndexType type = IndexType::UInt32);
 		static Ref<IndexBuffer> Create(uint32_t* indices, uint32_t size);
+		static Ref<IndexBuffer> Create(uint16_t* indices, uint32_t size);
+	};
+
+	// Matches the layout expected by glMultiDrawElementsIndirect
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t  BaseVertex;
+		uint32_t BaseInstance;
+	};
+
+	class IndirectBuffer
+	{
+	public:
+		virtual ~IndirectBuffer() = default;
+
+		virtual void Bind() const = 0;
+		virtual void Unbind() const = 0;
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+		virtual uint32_t GetMaxCount() const = 0;
+
+		static Ref<IndirectBuffer> Create(uint32_t size);
 	};
 }
\ No newline at end of file
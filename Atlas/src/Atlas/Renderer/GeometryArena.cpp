@@ -0,0 +1,232 @@
+#include "atlaspch.h"
+#include "Atlas/Renderer/GeometryArena.h"
+
+#include <cstring>
+
+namespace Atlas
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FreeListAllocator ///////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	FreeListAllocator::FreeListAllocator(uint32_t capacity)
+		: m_Capacity(capacity)
+	{
+		m_FreeBlocks[0] = capacity;
+	}
+
+	uint32_t FreeListAllocator::Allocate(uint32_t size)
+	{
+		if (size == 0)
+		{
+			return InvalidOffset;
+		}
+
+		// Best fit: smallest free block the range fits in
+		auto bestBlock = m_FreeBlocks.end();
+		for (auto it = m_FreeBlocks.begin(); it != m_FreeBlocks.end(); ++it)
+		{
+			if (it->second >= size && (bestBlock == m_FreeBlocks.end() || it->second < bestBlock->second))
+			{
+				bestBlock = it;
+
+				if (it->second == size)
+				{
+					break;
+				}
+			}
+		}
+
+		if (bestBlock == m_FreeBlocks.end())
+		{
+			return InvalidOffset;
+		}
+
+		uint32_t offset    = bestBlock->first;
+		uint32_t remaining = bestBlock->second - size;
+		m_FreeBlocks.erase(bestBlock);
+
+		if (remaining)
+		{
+			m_FreeBlocks[offset + size] = remaining;
+		}
+
+		m_Used += size;
+		return offset;
+	}
+
+	void FreeListAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		if (offset == InvalidOffset || size == 0)
+		{
+			return;
+		}
+
+		m_Used -= size;
+
+		auto next = m_FreeBlocks.lower_bound(offset);
+		ATLAS_CORE_ASSERT(next == m_FreeBlocks.end() || offset + size <= next->first, "Freed range overlaps a free block!");
+
+		// Merge with the following block
+		if (next != m_FreeBlocks.end() && offset + size == next->first)
+		{
+			size += next->second;
+			next = m_FreeBlocks.erase(next);
+		}
+
+		// Merge with the preceding block
+		if (next != m_FreeBlocks.begin())
+		{
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset)
+			{
+				previous->second += size;
+				return;
+			}
+		}
+
+		m_FreeBlocks[offset] = size;
+	}
+
+	uint32_t FreeListAllocator::GetLargestFreeBlock() const
+	{
+		uint32_t largest = 0;
+		for (const auto& [offset, size] : m_FreeBlocks)
+		{
+			largest = std::max(largest, size);
+		}
+
+		return largest;
+	}
+
+	float FreeListAllocator::GetFragmentation() const
+	{
+		uint32_t free = m_Capacity - m_Used;
+		if (free == 0)
+		{
+			return 0.0f;
+		}
+
+		return 1.0f - (float)GetLargestFreeBlock() / (float)free;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// GeometryArena ///////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	GeometryArena::GeometryArena(const BufferLayout& layout, uint32_t maxVertices, uint32_t maxIndices, IndexType indexType, const Ref<VertexBuffer>& instanceBuffer)
+		: m_VertexSize(layout.GetStride()), m_IndexType(indexType), m_VertexAllocator(maxVertices), m_IndexAllocator(maxIndices)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		const std::vector<BufferElement>& elements = layout.GetElements();
+		ATLAS_CORE_ASSERT(elements.size() > 1, "Geometry arena layouts need a position and at least one other attribute!");
+
+		BufferLayout positionLayout({ elements.front() });
+		BufferLayout attributeLayout(std::vector<BufferElement>(elements.begin() + 1, elements.end()));
+		m_PositionSize = positionLayout.GetStride();
+
+		// Bound first so creating the index buffer can't clobber another VAO's element binding
+		m_VertexArray = VertexArray::Create();
+		m_VertexArray->Bind();
+		m_PositionVertexArray = VertexArray::Create();
+
+		if (instanceBuffer)
+		{
+			m_VertexArray->AddVertexBuffer(instanceBuffer, true);
+			m_PositionVertexArray->AddVertexBuffer(instanceBuffer, true);
+		}
+
+		// VBOs (positions first, so attribute locations are the same as with a single interleaved buffer)
+		m_PositionBuffer = VertexBuffer::Create(maxVertices * m_PositionSize);
+		m_PositionBuffer->SetLayout(positionLayout);
+		m_VertexArray->AddVertexBuffer(m_PositionBuffer);
+		m_PositionVertexArray->AddVertexBuffer(m_PositionBuffer);
+
+		m_AttributeBuffer = VertexBuffer::Create(maxVertices * attributeLayout.GetStride());
+		m_AttributeBuffer->SetLayout(attributeLayout);
+		m_VertexArray->AddVertexBuffer(m_AttributeBuffer);
+
+		// IBO / EBO
+		m_IndexBuffer = IndexBuffer::Create(maxIndices * IndexTypeSize(m_IndexType), m_IndexType);
+		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+		m_PositionVertexArray->SetIndexBuffer(m_IndexBuffer);
+	}
+
+	GeometryArena::Allocation GeometryArena::Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		Allocation allocation;
+
+		uint32_t baseVertex = m_VertexAllocator.Allocate(vertexCount);
+		if (baseVertex == FreeListAllocator::InvalidOffset)
+		{
+			ATLAS_CORE_ERROR("Geometry arena is out of vertex space ({0} vertices requested)!", vertexCount);
+			return allocation;
+		}
+
+		uint32_t firstIndex = m_IndexAllocator.Allocate(indexCount);
+		if (firstIndex == FreeListAllocator::InvalidOffset)
+		{
+			ATLAS_CORE_ERROR("Geometry arena is out of index space ({0} indices requested)!", indexCount);
+			m_VertexAllocator.Free(baseVertex, vertexCount);
+			return allocation;
+		}
+
+		uint32_t attributeSize = m_VertexSize - m_PositionSize;
+		m_PositionScratch.resize((size_t)vertexCount * m_PositionSize);
+		m_AttributeScratch.resize((size_t)vertexCount * attributeSize);
+
+		const uint8_t* vertex = (const uint8_t*)vertices;
+		for (uint32_t i = 0; i < vertexCount; i++, vertex += m_VertexSize)
+		{
+			memcpy(&m_PositionScratch[(size_t)i * m_PositionSize], vertex, m_PositionSize);
+			memcpy(&m_AttributeScratch[(size_t)i * attributeSize], vertex + m_PositionSize, attributeSize);
+		}
+
+		m_PositionBuffer->SetData(m_PositionScratch.data(), vertexCount * m_PositionSize, baseVertex * m_PositionSize);
+		m_AttributeBuffer->SetData(m_AttributeScratch.data(), vertexCount * attributeSize, baseVertex * attributeSize);
+
+		uint32_t indexSize = IndexTypeSize(m_IndexType);
+		switch (m_IndexType)
+		{
+			case IndexType::UInt16:
+			{
+				ATLAS_CORE_ASSERT(vertexCount <= UINT16_MAX + 1, "Too many vertices for 16-bit indices!");
+
+				m_NarrowIndices.resize(indexCount);
+				for (uint32_t i = 0; i < indexCount; i++)
+				{
+					m_NarrowIndices[i] = (uint16_t)indices[i];
+				}
+
+				m_IndexBuffer->SetData(m_NarrowIndices.data(), indexCount * indexSize, firstIndex * indexSize);
+				break;
+			}
+			case IndexType::UInt32:
+			{
+				m_IndexBuffer->SetData(indices, indexCount * indexSize, firstIndex * indexSize);
+				break;
+			}
+		}
+
+		allocation.BaseVertex  = baseVertex;
+		allocation.VertexCount = vertexCount;
+		allocation.FirstIndex  = firstIndex;
+		allocation.IndexCount  = indexCount;
+		return allocation;
+	}
+
+	void GeometryArena::Free(Allocation& allocation)
+	{
+		if (!allocation.IsValid())
+		{
+			return;
+		}
+
+		m_VertexAllocator.Free(allocation.BaseVertex, allocation.VertexCount);
+		m_IndexAllocator.Free(allocation.FirstIndex, allocation.IndexCount);
+		allocation = Allocation();
+	}
+}
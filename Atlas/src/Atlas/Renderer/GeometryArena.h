@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Atlas/Renderer/VertexArray.h"
+
+#include <map>
+
+namespace Atlas
+{
+	// Sub-allocates ranges of a fixed capacity (in elements) using a best-fit free list.
+	// Adjacent free blocks are merged back together on release.
+	class FreeListAllocator
+	{
+	public:
+		static const uint32_t InvalidOffset = UINT32_MAX;
+
+		FreeListAllocator(uint32_t capacity);
+
+		uint32_t Allocate(uint32_t size);
+		void Free(uint32_t offset, uint32_t size);
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetUsed() const { return m_Used; }
+		uint32_t GetFreeBlockCount() const { return (uint32_t)m_FreeBlocks.size(); }
+		uint32_t GetLargestFreeBlock() const;
+		// 0 when all free space is contiguous, tends to 1 as it gets split into small blocks
+		float GetFragmentation() const;
+
+	private:
+		uint32_t m_Capacity;
+		uint32_t m_Used = 0;
+		std::map<uint32_t, uint32_t> m_FreeBlocks; // Offset -> size
+	};
+
+	// Vertex and index buffers shared by every mesh, so all meshes can be drawn from one VAO. Positions (the first element
+	// of the layout) are kept in their own stream, so depth-only passes can read them alone from a second VAO.
+	class GeometryArena
+	{
+	public:
+		struct Allocation
+		{
+			uint32_t BaseVertex  = 0;
+			uint32_t VertexCount = 0;
+			uint32_t FirstIndex  = 0;
+			uint32_t IndexCount  = 0;
+
+			bool IsValid() const { return IndexCount != 0; }
+		};
+
+		// Per-instance attributes are bound first so their locations don't depend on the vertex layout
+		GeometryArena(const BufferLayout& layout, uint32_t maxVertices, uint32_t maxIndices, IndexType indexType, const Ref<VertexBuffer>& instanceBuffer = nullptr);
+
+		// Vertices are interleaved as in the layout, they are split between the streams on upload. Indices are relative to
+		// the first vertex of the allocation (see Allocation::BaseVertex), and narrowed to the arena's index type.
+		Allocation Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+		void Free(Allocation& allocation);
+
+		const Ref<VertexArray>& GetVertexArray() const { return m_VertexArray; }
+		const Ref<VertexArray>& GetPositionVertexArray() const { return m_PositionVertexArray; } // Instances and positions only
+		uint32_t GetVertexSize() const { return m_VertexSize; }
+		IndexType GetIndexType() const { return m_IndexType; }
+
+		const FreeListAllocator& GetVertexAllocator() const { return m_VertexAllocator; }
+		const FreeListAllocator& GetIndexAllocator() const { return m_IndexAllocator; }
+
+	private:
+		uint32_t m_VertexSize;
+		uint32_t m_PositionSize;
+		IndexType m_IndexType;
+		std::vector<uint16_t> m_NarrowIndices;    // Conversion scratch for 16-bit arenas
+		std::vector<uint8_t> m_PositionScratch;  // Split scratch
+		std::vector<uint8_t> m_AttributeScratch;
+
+		Ref<VertexArray> m_VertexArray;
+		Ref<VertexArray> m_PositionVertexArray;
+		Ref<VertexBuffer> m_PositionBuffer;
+		Ref<VertexBuffer> m_AttributeBuffer;
+		Ref<IndexBuffer> m_IndexBuffer;
+
+		FreeListAllocator m_VertexAllocator;
+		FreeListAllocator m_IndexAllocator;
+	};
+}
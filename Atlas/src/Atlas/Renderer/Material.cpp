@@ -14,7 +14,7 @@ namespace Atlas
 	}
 
 	Material::Material(const glm::vec4& color, const float& metallic, const float& roughness)
-		: m_Color(color), m_Metallic(metallic), m_Roughness(roughness)
+		: m_Color(color), m_Metallic(metallic), m_Roughness(roughness), m_Opacity(color.a)
 	{
 		m_MaterialPreset = MaterialPresets::Custom;
 	}
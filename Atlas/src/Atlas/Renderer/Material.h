@@ -54,6 +54,9 @@ namespace Atlas
 		const float& GetMetallic() { return m_Metallic; }
 		void SetRoughness(const float& roughness) { m_Roughness = roughness; m_MaterialPreset = MaterialPresets::Custom; }
 		const float& GetRoughness() { return m_Roughness; }
+		void SetOpacity(const float& opacity) { m_Opacity = opacity; m_MaterialPreset = MaterialPresets::Custom; }
+		const float& GetOpacity() { return m_Opacity; }
+		bool IsTransparent() const { return m_Opacity < 1.0f; } // Drawn in the forward pass, sorted back to front
 
 		// Material Textures
 		void SetAlbedoTexture(const Ref<Texture2D>& albedoTexture);
@@ -78,6 +81,7 @@ namespace Atlas
 		glm::vec3 m_Color = glm::vec3(1.0f, 1.0f, 1.0f);
 		float m_Metallic = 0.25f;
 		float m_Roughness = 0.25f;
+		float m_Opacity = 1.0f;
 
 		Ref<Texture2D> m_AlbedoTexture       = nullptr;
 		Ref<Texture2D> m_NormalTexture       = nullptr;
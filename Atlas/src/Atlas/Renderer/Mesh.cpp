@@ -1,8 +1,17 @@
 #include "atlaspch.h"
 #include "Atlas/Renderer/Mesh.h"
 
+#include "Atlas/Renderer/Renderer.h"
+#include "Atlas/Renderer/MeshSimplifier.h"
+#include "Atlas/Renderer/MeshOptimizer.h"
+
+#include <glm/gtc/packing.hpp>
+
 namespace Atlas
 {
+	static const float s_MaxLODError     = 0.02f; // Relative to the mesh extent, per level
+	static const float s_MinLODReduction = 0.8f;  // Levels keeping more of the previous level's triangles are dropped
+
 	void Mesh::SetMeshPreset(const MeshPresets& meshPresets)
 	{
 		if (m_MeshPreset == meshPresets)
@@ -11,6 +20,7 @@ namespace Atlas
 		}
 
 		m_MeshPreset = meshPresets;
+		ClearDerivedGeometry();
 
 		switch (m_MeshPreset)
 		{
@@ -26,7 +36,247 @@ namespace Atlas
 				CalculateTangents();
 				break;
 		}
+
+		m_IsGeometryDirty = true;
+		UpdateBounds();
+	}
+
+	Mesh::~Mesh()
+	{
+		FreeGeometry();
+	}
+
+	GeometryArena::Allocation Mesh::GetGeometry(uint32_t lod)
+	{
+		if (m_IsGeometryDirty)
+		{
+			UpdateGeometry();
+		}
+
+		GeometryArena::Allocation geometry = m_Geometry;
+		if (!geometry.IsValid())
+		{
+			return geometry;
+		}
+
+		// Levels follow the mesh indices in the allocation
+		lod = glm::min(lod, GetLODCount() - 1);
+		if (lod > 0)
+		{
+			geometry.FirstIndex += (uint32_t)m_Indices.size() + GetLOD(lod).FirstIndex;
+		}
+		geometry.IndexCount = GetLODIndexCount(lod);
+
+		return geometry;
+	}
+
+	void Mesh::GenerateLODs()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		m_LODs.clear();
+		m_LODIndices.clear();
+
+		// Each level simplifies the previous one rather than the full mesh: faster, and errors only grow
+		std::vector<uint32_t> previousIndices = m_Indices;
+		float error = 0.0f;
+
+		for (uint32_t lod = 1; lod < MaxLODCount; lod++)
+		{
+			uint32_t targetIndexCount = (uint32_t)(m_Indices.size() >> lod) / 3 * 3;
+
+			float levelError = 0.0f;
+			std::vector<uint32_t> indices = MeshSimplifier::Simplify(m_Vertices, previousIndices, targetIndexCount, s_MaxLODError, &levelError);
+			if (indices.empty() || indices.size() > previousIndices.size() * s_MinLODReduction)
+			{
+				break;
+			}
+
+			// Collapses leave the triangles in their original order, with gaps
+			MeshOptimizer::OptimizeVertexCache(indices, (uint32_t)m_Vertices.size());
+
+			error += levelError;
+			m_LODs.push_back({ (uint32_t)m_LODIndices.size(), (uint32_t)indices.size(), error });
+			m_LODIndices.insert(m_LODIndices.end(), indices.begin(), indices.end());
+			previousIndices = std::move(indices);
+		}
+
+		m_IsGeometryDirty = true;
+	}
+
+	void Mesh::BuildMeshlets()
+	{
+		m_Meshlets = MeshOptimizer::BuildMeshlets(m_Vertices, m_Indices);
+	}
+
+	void Mesh::SetVertexFormat(VertexFormat format)
+	{
+		if (m_VertexFormat == format)
+		{
+			return;
+		}
+
+		// Released from the arena of the previous format
+		FreeGeometry();
+
+		m_VertexFormat = format;
+		m_IsGeometryDirty = true;
+	}
+
+	BufferLayout Mesh::GetVertexLayout(VertexFormat format)
+	{
+		switch (format)
+		{
+			default:
+			case VertexFormat::Full:
+				return {
+					{ ShaderDataType::Float3, "a_Position"  },
+					{ ShaderDataType::Float3, "a_Normal"    },
+					{ ShaderDataType::Float2, "a_TexCoord"  },
+					{ ShaderDataType::Float3, "a_Tangent"   },
+					{ ShaderDataType::Float3, "a_Bitangent" }
+				};
+			case VertexFormat::Compressed:
+				return {
+					{ ShaderDataType::UShort4, "a_Position", true },
+					{ ShaderDataType::Short2,  "a_Normal",   true },
+					{ ShaderDataType::Half2,   "a_TexCoord"       },
+					{ ShaderDataType::Short2,  "a_Tangent",  true }
+				};
+		}
+	}
+
+	void Mesh::UpdateGeometry()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		FreeGeometry();
+
+		m_IndexType = m_Vertices.size() <= (size_t)UINT16_MAX + 1 ? IndexType::UInt16 : IndexType::UInt32;
+
+		GeometryArena* arena = Renderer::GetMeshGeometryArena(m_VertexFormat, m_IndexType);
+		if (arena != nullptr && !m_Indices.empty())
+		{
+			// LOD indices are uploaded right after the mesh indices, in the same allocation
+			std::vector<uint32_t> lodIndices;
+			if (!m_LODIndices.empty())
+			{
+				lodIndices.reserve(m_Indices.size() + m_LODIndices.size());
+				lodIndices.insert(lodIndices.end(), m_Indices.begin(), m_Indices.end());
+				lodIndices.insert(lodIndices.end(), m_LODIndices.begin(), m_LODIndices.end());
+			}
+			const std::vector<uint32_t>& indices = m_LODIndices.empty() ? m_Indices : lodIndices;
+
+			switch (m_VertexFormat)
+			{
+				default:
+				case VertexFormat::Full:
+				{
+					m_PositionOffset = glm::vec3(0.0f);
+					m_PositionScale  = glm::vec3(1.0f);
+					m_Geometry = arena->Allocate(m_Vertices.data(), (uint32_t)m_Vertices.size(), indices.data(), (uint32_t)indices.size());
+					break;
+				}
+				case VertexFormat::Compressed:
+				{
+					std::vector<CompressedVertex> vertices = CompressVertices();
+					m_Geometry = arena->Allocate(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size());
+					break;
+				}
+			}
+		}
+
+		m_IsGeometryDirty = false;
+	}
+
+	void Mesh::UpdateBounds()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glm::vec3 boundsMin = m_Vertices.empty() ? glm::vec3(0.0f) : m_Vertices[0].Position;
+		glm::vec3 boundsMax = boundsMin;
+		for (const Vertex& vertex : m_Vertices)
+		{
+			boundsMin = glm::min(boundsMin, vertex.Position);
+			boundsMax = glm::max(boundsMax, vertex.Position);
+		}
+
+		m_Bounds = AABB(boundsMin, boundsMax);
+
+		// Centered on the box, but sized on the vertices: tighter than the box's half diagonal
+		float radiusSquared = 0.0f;
+		glm::vec3 center = m_Bounds.GetCenter();
+		for (const Vertex& vertex : m_Vertices)
+		{
+			glm::vec3 offset = vertex.Position - center;
+			radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+		}
+
+		m_BoundingSphere = BoundingSphere(center, glm::sqrt(radiusSquared));
 	}
+
+	void Mesh::FreeGeometry()
+	{
+		// The arena is gone once the renderer shut down, along with the memory it held
+		GeometryArena* arena = Renderer::GetMeshGeometryArena(m_VertexFormat, m_IndexType);
+		if (arena != nullptr)
+		{
+			arena->Free(m_Geometry);
+		}
+	}
+
+	static glm::vec2 OctahedralEncode(glm::vec3 direction)
+	{
+		float length = glm::abs(direction.x) + glm::abs(direction.y) + glm::abs(direction.z);
+		if (length == 0.0f)
+		{
+			return glm::vec2(0.0f);
+		}
+
+		direction /= length;
+		if (direction.z >= 0.0f)
+		{
+			return glm::vec2(direction.x, direction.y);
+		}
+
+		// Fold the lower hemisphere over the diagonals
+		glm::vec2 signs = glm::vec2(direction.x >= 0.0f ? 1.0f : -1.0f, direction.y >= 0.0f ? 1.0f : -1.0f);
+		return (1.0f - glm::abs(glm::vec2(direction.y, direction.x))) * signs;
+	}
+
+	std::vector<Mesh::CompressedVertex> Mesh::CompressVertices()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		const AABB& bounds = GetBounds();
+
+		m_PositionOffset = bounds.Min;
+		m_PositionScale  = bounds.Max - bounds.Min;
+		glm::vec3 inverseScale = glm::vec3(
+			m_PositionScale.x > 0.0f ? 1.0f / m_PositionScale.x : 0.0f,
+			m_PositionScale.y > 0.0f ? 1.0f / m_PositionScale.y : 0.0f,
+			m_PositionScale.z > 0.0f ? 1.0f / m_PositionScale.z : 0.0f);
+
+		std::vector<CompressedVertex> compressedVertices(m_Vertices.size());
+		for (size_t i = 0; i < m_Vertices.size(); i++)
+		{
+			const Vertex& vertex = m_Vertices[i];
+			CompressedVertex& compressedVertex = compressedVertices[i];
+
+			glm::vec3 position = glm::clamp((vertex.Position - bounds.Min) * inverseScale, 0.0f, 1.0f);
+			compressedVertex.Position[0] = glm::packUnorm1x16(position.x);
+			compressedVertex.Position[1] = glm::packUnorm1x16(position.y);
+			compressedVertex.Position[2] = glm::packUnorm1x16(position.z);
+			compressedVertex.Position[3] = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f ? 0 : UINT16_MAX;
+
+			compressedVertex.Normal    = glm::packSnorm2x16(OctahedralEncode(vertex.Normal));
+			compressedVertex.TexCoords = glm::packHalf2x16(vertex.TexCoords);
+			compressedVertex.Tangent   = glm::packSnorm2x16(OctahedralEncode(vertex.Tangent));
+		}
+
+		return compressedVertices;
+	}
+
 	void Mesh::CalculateSquareVertices()
 	{
 		// All indices are in counter-clockwise order (for culling)
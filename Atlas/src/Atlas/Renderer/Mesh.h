@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Atlas/Renderer/GeometryArena.h"
+#include "Atlas/Math/Bounds.h"
+
 #include <glm/glm.hpp>
 
 namespace Atlas
@@ -14,6 +17,13 @@ namespace Atlas
 			Sphere
 		};
 
+		// GPU vertex layout, picked per mesh before its geometry is uploaded
+		enum class VertexFormat
+		{
+			Full       = 0, // Vertex as is (56 bytes)
+			Compressed = 1  // CompressedVertex (20 bytes)
+		};
+
 		struct Vertex
 		{
 			glm::vec3 Position;
@@ -34,15 +44,78 @@ namespace Atlas
 			{}
 		};
 
+		// Simplified level of detail, indexing the mesh vertices (LOD 0 is the mesh itself)
+		struct LOD
+		{
+			uint32_t FirstIndex; // In the concatenated LOD indices
+			uint32_t IndexCount;
+			float Error;         // Relative to the mesh extent, accumulated over the previous levels
+		};
+
+		static const uint32_t MaxLODCount = 4;
+
+		// Cluster of neighbouring triangles, a contiguous range of the mesh indices (LOD 0 only)
+		struct Meshlet
+		{
+			uint32_t FirstIndex;
+			uint32_t IndexCount;
+			BoundingSphere Bounds;
+			// Normal cone: every triangle faces away from viewers for which dot(normalize(ConeApex - viewer), ConeAxis) >= ConeCutoff
+			glm::vec3 ConeApex;
+			glm::vec3 ConeAxis;
+			float ConeCutoff; // 1 when the triangles face too many ways for the cone to ever cull
+		};
+
+		static const uint32_t MaxMeshletVertices  = 64;
+		static const uint32_t MaxMeshletTriangles = 124;
+
+		struct CompressedVertex
+		{
+			uint16_t Position[4]; // xyz: unorm relative to the mesh bounds, w: bitangent sign (0 = negative)
+			uint32_t Normal;      // Octahedral, 2 x snorm16
+			uint32_t TexCoords;   // 2 x half
+			uint32_t Tangent;     // Octahedral, 2 x snorm16 (bitangent = cross(normal, tangent) * sign)
+		};
+
 		Mesh() { SetMeshPreset(MeshPresets::Square); }
 		Mesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
-			: m_Vertices(vertices), m_Indices(indices) { SetMeshPreset(MeshPresets::Custom); }
+			: m_Vertices(vertices), m_Indices(indices) { SetMeshPreset(MeshPresets::Custom); UpdateBounds(); }
+		Mesh(const Mesh&) = delete; // Owns its range of the geometry arena
+		~Mesh();
 
-		void SetVertices(const std::vector<Vertex>& vertices) { m_Vertices = vertices; }
+		void SetVertices(const std::vector<Vertex>& vertices) { m_Vertices = vertices; ClearDerivedGeometry(); m_IsGeometryDirty = true; UpdateBounds(); }
 		const std::vector<Vertex>& GetVertices() { return m_Vertices; }
-		void SetIndices(const std::vector<uint32_t>& indices) { m_Indices = indices; }
+		void SetIndices(const std::vector<uint32_t>& indices) { m_Indices = indices; ClearDerivedGeometry(); m_IsGeometryDirty = true; }
 		const std::vector<uint32_t>& GetIndices() { return m_Indices; }
 
+		// Builds up to MaxLODCount - 1 simplified levels (halving the triangle count each time), stopping early once
+		// simplification stalls. Levels are uploaded with the mesh and dropped when its vertices or indices change.
+		void GenerateLODs();
+		uint32_t GetLODCount() const { return (uint32_t)m_LODs.size() + 1; }
+		const LOD& GetLOD(uint32_t lod) const { return m_LODs[lod - 1]; }
+		uint32_t GetLODIndexCount(uint32_t lod) const { return lod == 0 ? (uint32_t)m_Indices.size() : GetLOD(lod).IndexCount; }
+
+		// Splits the mesh indices into meshlets in their current order (so after any reordering), dropped along with the LODs
+		void BuildMeshlets();
+		const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+
+		// Location of the geometry in the renderer's mesh arena, (re)uploaded on first use after the vertices or indices changed.
+		// Every level shares the vertices, only the index range differs (the level is clamped to the last one).
+		GeometryArena::Allocation GetGeometry(uint32_t lod = 0);
+		// Mesh space bounds, recomputed as soon as the vertices change so reading them never writes (scenes read them from
+		// a worker while the previous frame is drawn)
+		const AABB& GetBounds() const { return m_Bounds; }
+		const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+		static BufferLayout GetVertexLayout(VertexFormat format);
+
+		void SetVertexFormat(VertexFormat format);
+		VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+		// Maps compressed positions back to mesh space (position = offset + scale * stored)
+		const glm::vec3& GetPositionOffset() const { return m_PositionOffset; }
+		const glm::vec3& GetPositionScale() const { return m_PositionScale; }
+		// 16-bit whenever every vertex can be addressed with it, picked when the geometry is uploaded
+		IndexType GetIndexType() const { return m_IndexType; }
+
 		void SetMeshPreset(const MeshPresets& materialPreset);
 		const MeshPresets& GetMeshPreset() { return m_MeshPreset; }
 
@@ -50,10 +123,29 @@ namespace Atlas
 		void CalculateSquareVertices();
 		void CalculateSphereVertices();
 		void CalculateTangents();
+		void ClearDerivedGeometry() { m_LODs.clear(); m_LODIndices.clear(); m_Meshlets.clear(); }
+		void UpdateGeometry();
+		void UpdateBounds();
+		void FreeGeometry();
+		std::vector<CompressedVertex> CompressVertices();
 
 		MeshPresets m_MeshPreset;
 
 		std::vector<Vertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;
+		std::vector<LOD> m_LODs;              // Levels 1 and up
+		std::vector<uint32_t> m_LODIndices;   // Indices of every level, one after the other
+		std::vector<Meshlet> m_Meshlets;
+
+		VertexFormat m_VertexFormat = VertexFormat::Full;
+		glm::vec3 m_PositionOffset = glm::vec3(0.0f);
+		glm::vec3 m_PositionScale  = glm::vec3(1.0f);
+		IndexType m_IndexType      = IndexType::UInt32;
+
+		GeometryArena::Allocation m_Geometry; // Indices of every level
+		bool m_IsGeometryDirty = true;
+
+		AABB m_Bounds;
+		BoundingSphere m_BoundingSphere;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,533 @@
+#include "atlaspch.h"
+#include "Atlas/Renderer/MeshOptimizer.h"
+
+#include <cstring>
+#include <numeric>
+
+namespace Atlas
+{
+	// FIFO cache simulated with time stamps: a vertex is cached while fewer than CacheSize misses happened since its own
+	struct VertexCache
+	{
+		std::vector<uint32_t> TimeStamps;
+		uint32_t Time = MeshOptimizer::CacheSize + 1;
+
+		VertexCache(uint32_t vertexCount)
+			: TimeStamps(vertexCount, 0) {}
+
+		// Returns the number of misses (0 to 3)
+		uint32_t AddTriangle(const uint32_t* triangle)
+		{
+			uint32_t misses = 0;
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = triangle[corner];
+				if (Time - TimeStamps[vertex] > MeshOptimizer::CacheSize)
+				{
+					TimeStamps[vertex] = Time++;
+					misses++;
+				}
+			}
+
+			return misses;
+		}
+
+		void Flush() { Time += MeshOptimizer::CacheSize + 1; }
+	};
+
+	// Triangles around each vertex
+	struct VertexAdjacency
+	{
+		std::vector<uint32_t> Offsets; // Vertex -> first entry in Triangles, vertexCount + 1 entries
+		std::vector<uint32_t> Triangles;
+
+		VertexAdjacency(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+			: Offsets(vertexCount + 1, 0), Triangles(indices.size())
+		{
+			for (uint32_t index : indices)
+			{
+				Offsets[index + 1]++;
+			}
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				Offsets[i + 1] += Offsets[i];
+			}
+
+			std::vector<uint32_t> cursors(Offsets.begin(), Offsets.end() - 1);
+			for (uint32_t i = 0; i < (uint32_t)indices.size(); i++)
+			{
+				Triangles[cursors[indices[i]]++] = i / 3;
+			}
+		}
+	};
+
+	void MeshOptimizer::Optimize(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		WeldVertices(vertices, indices);
+		OptimizeVertexCache(indices, (uint32_t)vertices.size());
+		OptimizeOverdraw(indices, vertices);
+		OptimizeVertexFetch(vertices, indices);
+	}
+
+	void MeshOptimizer::WeldVertices(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		uint32_t vertexCount = (uint32_t)vertices.size();
+
+		// Equal vertices end up next to each other, the stable sort keeps the first one of each run first
+		std::vector<uint32_t> order(vertexCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&vertices](uint32_t a, uint32_t b)
+		{
+			return std::memcmp(&vertices[a], &vertices[b], sizeof(Mesh::Vertex)) < 0;
+		});
+
+		std::vector<uint32_t> representatives(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			bool isDuplicate = i > 0 && std::memcmp(&vertices[order[i]], &vertices[order[i - 1]], sizeof(Mesh::Vertex)) == 0;
+			representatives[order[i]] = isDuplicate ? representatives[order[i - 1]] : order[i];
+		}
+
+		// Representatives keep their relative order
+		std::vector<uint32_t> remap(vertexCount);
+		uint32_t weldedCount = 0;
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			if (representatives[i] == i)
+			{
+				remap[i] = weldedCount;
+				vertices[weldedCount++] = vertices[i];
+			}
+		}
+
+		vertices.erase(vertices.begin() + weldedCount, vertices.end());
+
+		for (uint32_t& index : indices)
+		{
+			index = remap[representatives[index]];
+		}
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		VertexAdjacency adjacency(indices, vertexCount);
+
+		std::vector<uint32_t> liveTriangles(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			liveTriangles[i] = adjacency.Offsets[i + 1] - adjacency.Offsets[i];
+		}
+
+		std::vector<uint32_t> cacheTimeStamps(vertexCount, 0);
+		std::vector<uint8_t> isEmitted(triangleCount, 0);
+		std::vector<uint32_t> deadEnds; // Recently used vertices, to restart from when the fan runs out
+		std::vector<uint32_t> candidates;
+		deadEnds.reserve(indices.size());
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+
+		uint32_t time   = CacheSize + 1;
+		uint32_t cursor = 0; // Next vertex to restart from once the dead ends are exhausted
+		int64_t fanVertex = 0;
+
+		while (fanVertex >= 0)
+		{
+			candidates.clear();
+
+			for (uint32_t i = adjacency.Offsets[fanVertex]; i < adjacency.Offsets[fanVertex + 1]; i++)
+			{
+				uint32_t triangle = adjacency.Triangles[i];
+				if (isEmitted[triangle])
+				{
+					continue;
+				}
+
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t vertex = indices[triangle * 3 + corner];
+					result.push_back(vertex);
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					liveTriangles[vertex]--;
+
+					if (time - cacheTimeStamps[vertex] > CacheSize)
+					{
+						cacheTimeStamps[vertex] = time++;
+					}
+				}
+
+				isEmitted[triangle] = 1;
+			}
+
+			// Next fan: the candidate that stays cached the longest, as long as its remaining triangles won't push it out
+			fanVertex = -1;
+			int64_t bestPriority = -1;
+			for (uint32_t vertex : candidates)
+			{
+				if (liveTriangles[vertex] == 0)
+				{
+					continue;
+				}
+
+				int64_t priority = 0;
+				if (time - cacheTimeStamps[vertex] + 2 * liveTriangles[vertex] <= CacheSize)
+				{
+					priority = time - cacheTimeStamps[vertex];
+				}
+
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					fanVertex = vertex;
+				}
+			}
+
+			if (fanVertex >= 0)
+			{
+				continue;
+			}
+
+			// Dead end: most recent vertex with triangles left, or else the next one in index order
+			while (!deadEnds.empty() && fanVertex < 0)
+			{
+				uint32_t vertex = deadEnds.back();
+				deadEnds.pop_back();
+				fanVertex = liveTriangles[vertex] > 0 ? (int64_t)vertex : -1;
+			}
+
+			while (fanVertex < 0 && cursor < vertexCount)
+			{
+				fanVertex = liveTriangles[cursor] > 0 ? (int64_t)cursor : -1;
+				cursor++;
+			}
+		}
+
+		indices = std::move(result);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Mesh::Vertex>& vertices, float threshold)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		VertexCache cache((uint32_t)vertices.size());
+
+		// Hard boundaries: triangles missing all three vertices, where the cache starts over anyway
+		std::vector<uint32_t> hardClusters;
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			if (cache.AddTriangle(&indices[i * 3]) == 3 || i == 0)
+			{
+				hardClusters.push_back(i);
+			}
+		}
+		hardClusters.push_back(triangleCount);
+
+		// Soft boundaries: a hard cluster is split as soon as its first triangles reach the cluster's ACMR (with some
+		// slack), starting the next part with a cold cache costs about as much as the cluster did
+		std::vector<uint32_t> clusters;
+		for (size_t hardCluster = 0; hardCluster + 1 < hardClusters.size(); hardCluster++)
+		{
+			uint32_t start = hardClusters[hardCluster];
+			uint32_t end   = hardClusters[hardCluster + 1];
+
+			cache.Flush();
+			uint32_t clusterMisses = 0;
+			for (uint32_t i = start; i < end; i++)
+			{
+				clusterMisses += cache.AddTriangle(&indices[i * 3]);
+			}
+
+			float clusterThreshold = threshold * (float)clusterMisses / (float)(end - start);
+
+			clusters.push_back(start);
+			cache.Flush();
+			uint32_t runningMisses    = 0;
+			uint32_t runningTriangles = 0;
+
+			for (uint32_t i = start; i < end; i++)
+			{
+				runningMisses += cache.AddTriangle(&indices[i * 3]);
+				runningTriangles++;
+
+				if ((float)runningMisses / (float)runningTriangles <= clusterThreshold && i + 1 < end)
+				{
+					clusters.push_back(i + 1);
+					cache.Flush();
+					runningMisses    = 0;
+					runningTriangles = 0;
+				}
+			}
+
+			// The last part rarely reaches the target, it is merged back into the previous one
+			if (runningTriangles > 0 && clusters.back() != start && (float)runningMisses / (float)runningTriangles > clusterThreshold)
+			{
+				clusters.pop_back();
+			}
+		}
+		clusters.push_back(triangleCount);
+
+		// Mesh centroid, weighted by area
+		glm::vec3 meshCentroid = glm::vec3(0.0f);
+		float meshArea = 0.0f;
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const glm::vec3& p0 = vertices[indices[i * 3    ]].Position;
+			const glm::vec3& p1 = vertices[indices[i * 3 + 1]].Position;
+			const glm::vec3& p2 = vertices[indices[i * 3 + 2]].Position;
+
+			float area = glm::length(glm::cross(p1 - p0, p2 - p0));
+			meshCentroid += (p0 + p1 + p2) * (area / 3.0f);
+			meshArea += area;
+		}
+		meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : meshCentroid;
+
+		// Clusters facing away from the centroid are likely in front of the others, whichever side they are seen from
+		std::vector<std::pair<float, uint32_t>> clusterKeys(clusters.size() - 1); // Key, cluster
+		for (uint32_t cluster = 0; cluster + 1 < (uint32_t)clusters.size(); cluster++)
+		{
+			glm::vec3 centroid = glm::vec3(0.0f);
+			glm::vec3 normal   = glm::vec3(0.0f);
+			float area = 0.0f;
+
+			for (uint32_t i = clusters[cluster]; i < clusters[cluster + 1]; i++)
+			{
+				const glm::vec3& p0 = vertices[indices[i * 3    ]].Position;
+				const glm::vec3& p1 = vertices[indices[i * 3 + 1]].Position;
+				const glm::vec3& p2 = vertices[indices[i * 3 + 2]].Position;
+
+				glm::vec3 triangleNormal = glm::cross(p1 - p0, p2 - p0);
+				float triangleArea = glm::length(triangleNormal);
+
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				normal   += triangleNormal;
+				area     += triangleArea;
+			}
+
+			centroid = area > 0.0f ? centroid / area : centroid;
+			float normalLength = glm::length(normal);
+			normal = normalLength > 0.0f ? normal / normalLength : normal;
+
+			clusterKeys[cluster] = { glm::dot(centroid - meshCentroid, normal), cluster };
+		}
+
+		// Stable, so equal keys keep the cache order
+		std::stable_sort(clusterKeys.begin(), clusterKeys.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (const auto& [key, cluster] : clusterKeys)
+		{
+			result.insert(result.end(), indices.begin() + clusters[cluster] * 3, indices.begin() + clusters[cluster + 1] * 3);
+		}
+
+		indices = std::move(result);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+		std::vector<Mesh::Vertex> result;
+		result.reserve(vertices.size());
+
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == UINT32_MAX)
+			{
+				remap[index] = (uint32_t)result.size();
+				result.push_back(vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		vertices = std::move(result);
+	}
+
+	static Mesh::Meshlet ComputeMeshletBounds(const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices,
+		uint32_t firstIndex, uint32_t indexCount)
+	{
+		Mesh::Meshlet meshlet;
+		meshlet.FirstIndex = firstIndex;
+		meshlet.IndexCount = indexCount;
+
+		glm::vec3 min = vertices[indices[firstIndex]].Position;
+		glm::vec3 max = min;
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++)
+		{
+			min = glm::min(min, vertices[indices[i]].Position);
+			max = glm::max(max, vertices[indices[i]].Position);
+		}
+
+		glm::vec3 center = (min + max) * 0.5f;
+		float radiusSquared = 0.0f;
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++)
+		{
+			glm::vec3 offset = vertices[indices[i]].Position - center;
+			radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+		}
+		meshlet.Bounds = BoundingSphere(center, glm::sqrt(radiusSquared));
+
+		// Cone axis: average facing of the triangles, degenerate ones excluded
+		std::vector<glm::vec3> normals;
+		std::vector<glm::vec3> corners; // A point on each triangle plane
+		normals.reserve(indexCount / 3);
+		corners.reserve(indexCount / 3);
+		glm::vec3 axis = glm::vec3(0.0f);
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; i += 3)
+		{
+			const glm::vec3& p0 = vertices[indices[i + 0]].Position;
+			const glm::vec3& p1 = vertices[indices[i + 1]].Position;
+			const glm::vec3& p2 = vertices[indices[i + 2]].Position;
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float length = glm::length(normal);
+			if (length > 0.0f)
+			{
+				normals.push_back(normal / length);
+				corners.push_back(p0);
+				axis += normals.back();
+			}
+		}
+
+		meshlet.ConeApex = center;
+		meshlet.ConeAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+		meshlet.ConeCutoff = 1.0f;
+
+		float axisLength = glm::length(axis);
+		if (normals.empty() || axisLength == 0.0f)
+		{
+			return meshlet;
+		}
+		axis /= axisLength;
+
+		float minDot = 1.0f;
+		for (const glm::vec3& normal : normals)
+		{
+			minDot = glm::min(minDot, glm::dot(normal, axis));
+		}
+
+		// Some triangles face away from the axis: no viewer sees all of them from behind
+		if (minDot <= 0.0f)
+		{
+			meshlet.ConeAxis = axis;
+			return meshlet;
+		}
+
+		// Moves the apex back along the axis until every triangle plane is in front of it, so the cone test is
+		// conservative for viewers anywhere, not only far away
+		float maxT = 0.0f;
+		for (size_t i = 0; i < normals.size(); i++)
+		{
+			// Distance back along the axis from the center to the triangle plane (minDot > 0, so never parallel)
+			float t = glm::dot(center - corners[i], normals[i]) / glm::dot(normals[i], axis);
+			maxT = glm::max(maxT, t);
+		}
+
+		meshlet.ConeApex = center - axis * maxT;
+		meshlet.ConeAxis = axis;
+		meshlet.ConeCutoff = glm::sqrt(1.0f - minDot * minDot);
+		return meshlet;
+	}
+
+	std::vector<Mesh::Meshlet> MeshOptimizer::BuildMeshlets(const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		std::vector<Mesh::Meshlet> meshlets;
+
+		uint32_t indexCount = (uint32_t)indices.size() / 3 * 3;
+		if (indexCount == 0)
+		{
+			return meshlets;
+		}
+
+		// A vertex is in the current meshlet when its stamp matches the meshlet number
+		std::vector<uint32_t> meshletStamps(vertices.size(), UINT32_MAX);
+		uint32_t meshletStart = 0;
+		uint32_t meshletVertexCount = 0;
+
+		for (uint32_t i = 0; i < indexCount; i += 3)
+		{
+			uint32_t meshletIndex = (uint32_t)meshlets.size();
+			uint32_t newVertexCount = 0;
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t index = indices[i + corner];
+				bool isRepeated = (corner > 0 && indices[i] == index) || (corner > 1 && indices[i + 1] == index);
+				newVertexCount += meshletStamps[index] != meshletIndex && !isRepeated ? 1 : 0;
+			}
+
+			uint32_t triangleCount = (i - meshletStart) / 3;
+			if (meshletVertexCount + newVertexCount > Mesh::MaxMeshletVertices || triangleCount == Mesh::MaxMeshletTriangles)
+			{
+				meshlets.push_back(ComputeMeshletBounds(vertices, indices, meshletStart, i - meshletStart));
+				meshletIndex++;
+				meshletStart = i;
+				meshletVertexCount = 0;
+			}
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t index = indices[i + corner];
+				meshletVertexCount += meshletStamps[index] != meshletIndex ? 1 : 0;
+				meshletStamps[index] = meshletIndex;
+			}
+		}
+
+		meshlets.push_back(ComputeMeshletBounds(vertices, indices, meshletStart, indexCount - meshletStart));
+		return meshlets;
+	}
+
+	MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		VertexCacheStats stats;
+
+		uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return stats;
+		}
+
+		VertexCache cache(vertexCount);
+		std::vector<uint8_t> isReferenced(vertexCount, 0);
+		uint32_t misses = 0;
+		uint32_t referencedCount = 0;
+
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			misses += cache.AddTriangle(&indices[i * 3]);
+		}
+
+		for (uint32_t index : indices)
+		{
+			referencedCount += isReferenced[index] ? 0 : 1;
+			isReferenced[index] = 1;
+		}
+
+		stats.ACMR = (float)misses / (float)triangleCount;
+		stats.ATVR = (float)misses / (float)referencedCount;
+		return stats;
+	}
+}
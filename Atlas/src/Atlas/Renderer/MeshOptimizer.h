@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Atlas/Renderer/Mesh.h"
+
+namespace Atlas
+{
+	// Index and vertex reordering for imported meshes. Every step is deterministic: the same input always gives the same
+	// output, and none of them change what is drawn (only the order it is drawn and fetched in).
+	class MeshOptimizer
+	{
+	public:
+		struct VertexCacheStats
+		{
+			float ACMR = 0.0f; // Average cache miss ratio: vertex shader invocations per triangle (0.5 to 3)
+			float ATVR = 0.0f; // Average transformed vertex ratio: invocations per referenced vertex (1 is optimal)
+		};
+
+		// Simulated FIFO post-transform cache
+		static const uint32_t CacheSize = 16;
+
+		// Runs all of the below, in order
+		static void Optimize(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		// Merges bitwise identical vertices (importers emit one vertex per face corner)
+		static void WeldVertices(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices);
+		// Tipsify (Sander et al. 2007): fans around recently used vertices so they are still cached when reused
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+		// Splits the cache-optimized triangles into clusters and draws the most outward facing clusters first, so they
+		// occlude the rest. Clusters only end where the cache would restart anyway, give or take the ACMR threshold.
+		static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Mesh::Vertex>& vertices, float threshold = 1.05f);
+		// Renumbers vertices in order of first use, so they are fetched sequentially, and drops unreferenced ones
+		static void OptimizeVertexFetch(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		// Greedily splits the triangles, in order, into meshlets of at most Mesh::MaxMeshletVertices unique vertices and
+		// Mesh::MaxMeshletTriangles triangles, with a bounding sphere and normal cone each for cluster culling
+		static std::vector<Mesh::Meshlet> BuildMeshlets(const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices);
+
+		static VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount);
+	};
+}
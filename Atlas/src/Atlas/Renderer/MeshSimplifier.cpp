@@ -0,0 +1,359 @@
+#include "atlaspch.h"
+#include "Atlas/Renderer/MeshSimplifier.h"
+
+#include <cfloat>
+#include <numeric>
+#include <tuple>
+
+namespace Atlas
+{
+	// Symmetric 4x4 matrix: weighted sum of the squared distances to a set of planes
+	struct Quadric
+	{
+		double A00 = 0.0, A01 = 0.0, A02 = 0.0, A03 = 0.0;
+		double A11 = 0.0, A12 = 0.0, A13 = 0.0;
+		double A22 = 0.0, A23 = 0.0;
+		double A33 = 0.0;
+		double Weight = 0.0; // Sum of the plane weights, turns the error back into a squared distance
+	};
+
+	struct EdgeCollapse
+	{
+		uint32_t From;
+		uint32_t To;
+		double Cost;
+	};
+
+	static void AddPlaneQuadric(Quadric& quadric, const glm::dvec3& normal, double distance, double weight)
+	{
+		quadric.A00 += weight * normal.x * normal.x;
+		quadric.A01 += weight * normal.x * normal.y;
+		quadric.A02 += weight * normal.x * normal.z;
+		quadric.A03 += weight * normal.x * distance;
+		quadric.A11 += weight * normal.y * normal.y;
+		quadric.A12 += weight * normal.y * normal.z;
+		quadric.A13 += weight * normal.y * distance;
+		quadric.A22 += weight * normal.z * normal.z;
+		quadric.A23 += weight * normal.z * distance;
+		quadric.A33 += weight * distance * distance;
+		quadric.Weight += weight;
+	}
+
+	static void AddQuadric(Quadric& quadric, const Quadric& other)
+	{
+		quadric.A00 += other.A00; quadric.A01 += other.A01; quadric.A02 += other.A02; quadric.A03 += other.A03;
+		quadric.A11 += other.A11; quadric.A12 += other.A12; quadric.A13 += other.A13;
+		quadric.A22 += other.A22; quadric.A23 += other.A23;
+		quadric.A33 += other.A33;
+		quadric.Weight += other.Weight;
+	}
+
+	// Unnormalized: divide by the weight to get a squared distance
+	static double EvaluateQuadric(const Quadric& quadric, const glm::vec3& position)
+	{
+		double x = position.x;
+		double y = position.y;
+		double z = position.z;
+
+		double error = quadric.A00 * x * x + 2.0 * quadric.A01 * x * y + 2.0 * quadric.A02 * x * z + 2.0 * quadric.A03 * x
+		             + quadric.A11 * y * y + 2.0 * quadric.A12 * y * z + 2.0 * quadric.A13 * y
+		             + quadric.A22 * z * z + 2.0 * quadric.A23 * z
+		             + quadric.A33;
+
+		// Rounding can take a zero error slightly below 0
+		return error > 0.0 ? error : 0.0;
+	}
+
+	// Squared distance of the merged vertex to the planes of both quadrics
+	static double GetCollapseCost(const Quadric& a, const Quadric& b, const glm::vec3& position)
+	{
+		double weight = a.Weight + b.Weight;
+		return weight > 0.0 ? (EvaluateQuadric(a, position) + EvaluateQuadric(b, position)) / weight : 0.0;
+	}
+
+	// Moving "from" onto "to" must not turn any remaining triangle around "from" over
+	static bool IsCollapseFlipping(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+		const uint32_t* triangles, uint32_t triangleCount, uint32_t from, uint32_t to)
+	{
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const uint32_t* triangle = &indices[triangles[i] * 3];
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+			{
+				continue; // Removed by the collapse
+			}
+
+			glm::vec3 corners[3];
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				corners[corner] = positions[triangle[corner]];
+			}
+			glm::vec3 normalBefore = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				corners[corner] = positions[triangle[corner] == from ? to : triangle[corner]];
+			}
+			glm::vec3 normalAfter = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+			if (glm::dot(normalBefore, normalAfter) <= 0.0f)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices,
+		uint32_t targetIndexCount, float maxError, float* resultError)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		std::vector<uint32_t> result = indices;
+		double resultCost = 0.0;
+
+		uint32_t vertexCount   = (uint32_t)vertices.size();
+		uint32_t triangleCount = (uint32_t)result.size() / 3;
+		uint32_t targetTriangleCount = targetIndexCount / 3;
+
+		if (triangleCount <= targetTriangleCount || vertexCount == 0)
+		{
+			if (resultError)
+			{
+				*resultError = 0.0f;
+			}
+
+			return result;
+		}
+
+		// Positions are normalized to the mesh extent so errors don't depend on its scale
+		glm::vec3 boundsMin = vertices[0].Position;
+		glm::vec3 boundsMax = boundsMin;
+		for (const Mesh::Vertex& vertex : vertices)
+		{
+			boundsMin = glm::min(boundsMin, vertex.Position);
+			boundsMax = glm::max(boundsMax, vertex.Position);
+		}
+
+		glm::vec3 extents = boundsMax - boundsMin;
+		float extent = glm::max(extents.x, glm::max(extents.y, extents.z));
+		float scale  = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+		std::vector<glm::vec3> positions(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			positions[i] = (vertices[i].Position - boundsMin) * scale;
+		}
+
+		// Locked vertices never move (other vertices may still collapse onto them):
+		// - Seams, where vertices share a position but not their other attributes: moving one would tear the surface
+		// - Open and non-manifold edges, to keep borders in place
+		std::vector<uint8_t> isLocked(vertexCount, 0);
+		{
+			std::vector<uint32_t> order(vertexCount);
+			std::iota(order.begin(), order.end(), 0);
+			auto isPositionLess = [&vertices](uint32_t a, uint32_t b)
+			{
+				const glm::vec3& positionA = vertices[a].Position;
+				const glm::vec3& positionB = vertices[b].Position;
+				return std::tie(positionA.x, positionA.y, positionA.z) < std::tie(positionB.x, positionB.y, positionB.z);
+			};
+			std::sort(order.begin(), order.end(), isPositionLess);
+
+			for (uint32_t i = 1; i < vertexCount; i++)
+			{
+				if (vertices[order[i]].Position == vertices[order[i - 1]].Position)
+				{
+					isLocked[order[i]]     = 1;
+					isLocked[order[i - 1]] = 1;
+				}
+			}
+
+			std::vector<uint64_t> edges;
+			edges.reserve(result.size());
+			for (uint32_t i = 0; i < (uint32_t)result.size(); i += 3)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t a = result[i + corner];
+					uint32_t b = result[i + (corner + 1) % 3];
+					edges.push_back((uint64_t)glm::min(a, b) << 32 | glm::max(a, b));
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+
+			for (size_t first = 0; first < edges.size();)
+			{
+				size_t last = first + 1;
+				while (last < edges.size() && edges[last] == edges[first])
+				{
+					last++;
+				}
+
+				// Interior edges are shared by exactly two triangles
+				if (last - first != 2)
+				{
+					isLocked[edges[first] >> 32]         = 1;
+					isLocked[edges[first] & UINT32_MAX] = 1;
+				}
+
+				first = last;
+			}
+		}
+
+		// Each vertex starts with the planes of its triangles, weighted by their area
+		std::vector<Quadric> quadrics(vertexCount);
+		for (uint32_t i = 0; i < (uint32_t)result.size(); i += 3)
+		{
+			const glm::vec3& p0 = positions[result[i    ]];
+			const glm::vec3& p1 = positions[result[i + 1]];
+			const glm::vec3& p2 = positions[result[i + 2]];
+
+			glm::dvec3 normal = glm::dvec3(glm::cross(p1 - p0, p2 - p0));
+			double doubleArea = glm::length(normal);
+			if (doubleArea == 0.0)
+			{
+				continue;
+			}
+
+			normal /= doubleArea;
+			double distance = -glm::dot(normal, glm::dvec3(p0));
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				AddPlaneQuadric(quadrics[result[i + corner]], normal, distance, doubleArea * 0.5);
+			}
+		}
+
+		double maxCost = (double)maxError * (double)maxError;
+
+		std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+		std::vector<uint32_t> vertexTriangles;
+		std::vector<EdgeCollapse> collapses;
+		std::vector<uint8_t> isTouched(vertexCount);
+
+		// Each pass collapses the cheapest independent edges (no two collapses share a triangle), then drops the
+		// degenerate triangles and rebuilds the adjacency
+		while (triangleCount > targetTriangleCount)
+		{
+			// Triangles around each vertex
+			std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+			for (uint32_t index : result)
+			{
+				triangleOffsets[index + 1]++;
+			}
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				triangleOffsets[i + 1] += triangleOffsets[i];
+			}
+
+			vertexTriangles.resize(result.size());
+			std::vector<uint32_t> cursors(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (uint32_t i = 0; i < (uint32_t)result.size(); i++)
+			{
+				vertexTriangles[cursors[result[i]]++] = i / 3;
+			}
+
+			// Interior edges are seen from both of their triangles, only the (a < b) side is kept
+			collapses.clear();
+			for (uint32_t i = 0; i < (uint32_t)result.size(); i += 3)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t a = result[i + corner];
+					uint32_t b = result[i + (corner + 1) % 3];
+					if (a > b || (isLocked[a] && isLocked[b]))
+					{
+						continue;
+					}
+
+					double costAB = isLocked[a] ? DBL_MAX : GetCollapseCost(quadrics[a], quadrics[b], positions[b]);
+					double costBA = isLocked[b] ? DBL_MAX : GetCollapseCost(quadrics[a], quadrics[b], positions[a]);
+
+					EdgeCollapse collapse = costAB <= costBA ? EdgeCollapse{ a, b, costAB } : EdgeCollapse{ b, a, costBA };
+					if (collapse.Cost <= maxCost)
+					{
+						collapses.push_back(collapse);
+					}
+				}
+			}
+
+			if (collapses.empty())
+			{
+				break;
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& a, const EdgeCollapse& b) { return a.Cost < b.Cost; });
+
+			std::fill(isTouched.begin(), isTouched.end(), 0);
+			uint32_t collapseCount = 0;
+
+			for (const EdgeCollapse& collapse : collapses)
+			{
+				if (triangleCount <= targetTriangleCount)
+				{
+					break;
+				}
+
+				if (isTouched[collapse.From] || isTouched[collapse.To])
+				{
+					continue;
+				}
+
+				const uint32_t* fromTriangles = &vertexTriangles[triangleOffsets[collapse.From]];
+				uint32_t fromTriangleCount = triangleOffsets[collapse.From + 1] - triangleOffsets[collapse.From];
+
+				if (IsCollapseFlipping(positions, result, fromTriangles, fromTriangleCount, collapse.From, collapse.To))
+				{
+					continue;
+				}
+
+				// Triangles sharing the edge become degenerate, they are dropped at the end of the pass
+				for (uint32_t i = 0; i < fromTriangleCount; i++)
+				{
+					uint32_t* triangle = &result[fromTriangles[i] * 3];
+					if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+					{
+						triangleCount--;
+					}
+
+					for (uint32_t corner = 0; corner < 3; corner++)
+					{
+						triangle[corner] = triangle[corner] == collapse.From ? collapse.To : triangle[corner];
+						isTouched[triangle[corner]] = 1;
+					}
+				}
+
+				isTouched[collapse.From] = 1;
+				AddQuadric(quadrics[collapse.To], quadrics[collapse.From]);
+				resultCost = glm::max(resultCost, collapse.Cost);
+				collapseCount++;
+			}
+
+			if (collapseCount == 0)
+			{
+				break;
+			}
+
+			uint32_t writeIndex = 0;
+			for (uint32_t i = 0; i < (uint32_t)result.size(); i += 3)
+			{
+				uint32_t a = result[i], b = result[i + 1], c = result[i + 2];
+				if (a != b && b != c && a != c)
+				{
+					result[writeIndex++] = a;
+					result[writeIndex++] = b;
+					result[writeIndex++] = c;
+				}
+			}
+			result.resize(writeIndex);
+		}
+
+		if (resultError)
+		{
+			*resultError = (float)glm::sqrt(resultCost);
+		}
+
+		return result;
+	}
+}
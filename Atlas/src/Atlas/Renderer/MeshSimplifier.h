@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Atlas/Renderer/Mesh.h"
+
+namespace Atlas
+{
+	// Quadric error metric edge collapse (Garland & Heckbert). Vertices are only ever collapsed onto existing ones,
+	// so simplified indices still address the original vertices and LODs can share their vertex range.
+	class MeshSimplifier
+	{
+	public:
+		// Collapses the cheapest edges until the index count reaches the target or the next collapse would exceed
+		// the maximum error. Errors are distances relative to the mesh extent (largest bounds dimension).
+		static std::vector<uint32_t> Simplify(const std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices,
+			uint32_t targetIndexCount, float maxError, float* resultError = nullptr);
+	};
+}
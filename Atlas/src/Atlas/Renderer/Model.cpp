@@ -1,6 +1,8 @@
 #include "atlaspch.h"
 #include "Atlas/Renderer/Model.h"
 
+#include "Atlas/Renderer/MeshOptimizer.h"
+
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
@@ -27,9 +29,9 @@ namespace Atlas
 		return;
 	}
 
-	void Model::ProcessNode(Ref<Scene> activeScene, const std::filesystem::path& modelPath, const aiNode& node, const aiScene& modelScene, Entity* parent)
+	void Model::ProcessNode(Ref<Scene> activeScene, const std::filesystem::path& modelPath, const aiNode& node, const aiScene& modelScene, Entity parent)
 	{
-		Entity* nodeParent;
+		Entity nodeParent;
 
 		if (node.mNumMeshes != 1)
 		{
@@ -39,18 +41,18 @@ namespace Atlas
 			{
 				aiMesh* mesh = modelScene.mMeshes[node.mMeshes[meshIndex]];
 
-				Entity* meshEntity = activeScene->CreateEntity(mesh->mName.C_Str(), nodeParent);
-				meshEntity->AddComponent<MeshComponent>(CreateMesh(*mesh, modelScene));
-				//meshEntity->AddComponent<MaterialComponent>(CreateMaterial(*mesh, modelPath, modelScene)); TODO: Fix: Memory leak?
+				Entity meshEntity = activeScene->CreateEntity(mesh->mName.C_Str(), nodeParent);
+				meshEntity.AddComponent<MeshComponent>(CreateMesh(*mesh, modelScene));
+				//meshEntity.AddComponent<MaterialComponent>(CreateMaterial(*mesh, modelPath, modelScene)); TODO: Fix: Memory leak?
 			}
 		}
 		else
 		{
 			aiMesh* mesh = modelScene.mMeshes[node.mMeshes[0]];
 
-			Entity* meshEntity = activeScene->CreateEntity(mesh->mName.C_Str(), parent);
-			meshEntity->AddComponent<MeshComponent>(CreateMesh(*mesh, modelScene));
-			//meshEntity->AddComponent<MaterialComponent>(CreateMaterial(*mesh, modelPath, modelScene)); TODO: Fix: Memory leak?
+			Entity meshEntity = activeScene->CreateEntity(mesh->mName.C_Str(), parent);
+			meshEntity.AddComponent<MeshComponent>(CreateMesh(*mesh, modelScene));
+			//meshEntity.AddComponent<MaterialComponent>(CreateMaterial(*mesh, modelPath, modelScene)); TODO: Fix: Memory leak?
 
 			nodeParent = meshEntity;
 		}
@@ -99,7 +101,23 @@ namespace Atlas
 			}
 		}
 
-		return CreateRef<Mesh>(vertices, indices);
+		// Assimp emits one vertex per face corner, in file order
+		MeshOptimizer::VertexCacheStats importedStats = MeshOptimizer::AnalyzeVertexCache(indices, (uint32_t)vertices.size());
+		uint32_t importedVertexCount = (uint32_t)vertices.size();
+
+		MeshOptimizer::Optimize(vertices, indices);
+
+		MeshOptimizer::VertexCacheStats optimizedStats = MeshOptimizer::AnalyzeVertexCache(indices, (uint32_t)vertices.size());
+		ATLAS_CORE_TRACE("Optimized mesh {0}: {1} -> {2} vertices, ACMR {3:.3f} -> {4:.3f}, ATVR {5:.3f} -> {6:.3f}", mesh.mName.C_Str(),
+			importedVertexCount, vertices.size(), importedStats.ACMR, optimizedStats.ACMR, importedStats.ATVR, optimizedStats.ATVR);
+
+		Ref<Mesh> importedMesh = CreateRef<Mesh>(vertices, indices);
+		// Imported meshes tend to be large (scans, CAD...): keep them quantized on the GPU, with a LOD chain for distant instances
+		// and meshlets so close ones only draw their visible clusters
+		importedMesh->SetVertexFormat(Mesh::VertexFormat::Compressed);
+		importedMesh->GenerateLODs();
+		importedMesh->BuildMeshlets();
+		return importedMesh;
 	}
 
 	//Ref<Material> Model::CreateMaterial(const aiMesh& mesh, const std::filesystem::path& modelPath, const aiScene& modelScene)
@@ -16,7 +16,7 @@ namespace Atlas
 		static void LoadModel(Ref<Scene> activeScene, const std::filesystem::path& path);
 
 	private:
-		static void ProcessNode(Ref<Scene> activeScene, const std::filesystem::path& modelPath, const aiNode& node, const aiScene& modelScene, Entity* parent = nullptr);
+		static void ProcessNode(Ref<Scene> activeScene, const std::filesystem::path& modelPath, const aiNode& node, const aiScene& modelScene, Entity parent = {});
 		static Ref<Mesh> CreateMesh(const aiMesh& mesh, const aiScene& modelScene);
 		//static Ref<Material> CreateMaterial(const aiMesh& mesh, const std::filesystem::path& modelPath, const aiScene& modelScene);
 	};
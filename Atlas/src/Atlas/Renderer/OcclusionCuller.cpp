@@ -0,0 +1,341 @@
+#include "atlaspch.h"
+#include "Atlas/Renderer/OcclusionCuller.h"
+
+#include "Atlas/Core/JobSystem.h"
+
+#include <cfloat>
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#define ATLAS_OCCLUSION_SSE
+	#include <emmintrin.h>
+#endif
+
+namespace Atlas
+{
+	// Below this, a vertex is too close to (or behind) the eye to be projected
+	static const float s_NearW = 1e-5f;
+
+	OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height)
+	{
+		m_TilesX = (width  + TileWidth  - 1) / TileWidth;
+		m_TilesY = (height + TileHeight - 1) / TileHeight;
+		m_Width  = m_TilesX * TileWidth;
+		m_Height = m_TilesY * TileHeight;
+
+		m_Depth.resize(m_Width * m_Height, 1.0f);
+		m_TileMaxDepth.resize(m_TilesX * m_TilesY, 1.0f);
+		m_TileBins.resize(m_TilesX * m_TilesY);
+	}
+
+	void OcclusionCuller::Begin(const glm::mat4& viewProjection)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		m_ViewProjection = viewProjection;
+
+		std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+		std::fill(m_TileMaxDepth.begin(), m_TileMaxDepth.end(), 1.0f);
+		m_Triangles.clear();
+
+		for (std::vector<uint32_t>& bin : m_TileBins)
+		{
+			bin.clear();
+		}
+	}
+
+	void OcclusionCuller::AddOccluder(const glm::mat4& transform, const glm::vec3* positions, uint32_t stride, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glm::mat4 modelViewProjection = m_ViewProjection * transform;
+		const uint8_t* position = (const uint8_t*)positions;
+
+		m_ClipPositions.resize(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			m_ClipPositions[i] = modelViewProjection * glm::vec4(*(const glm::vec3*)(position + i * stride), 1.0f);
+		}
+
+		for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			BinTriangle(m_ClipPositions[indices[i]], m_ClipPositions[indices[i + 1]], m_ClipPositions[indices[i + 2]]);
+		}
+	}
+
+	void OcclusionCuller::BinTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2)
+	{
+		// Clipping is skipped: dropping an occluder triangle only makes culling less effective, never wrong
+		if (v0.w < s_NearW || v1.w < s_NearW || v2.w < s_NearW)
+		{
+			return;
+		}
+
+		float x[3], y[3], z[3];
+		const glm::vec4* vertices[3] = { &v0, &v1, &v2 };
+		for (int i = 0; i < 3; i++)
+		{
+			const glm::vec4& vertex = *vertices[i];
+			x[i] = (vertex.x / vertex.w * 0.5f + 0.5f) * m_Width;
+			y[i] = (vertex.y / vertex.w * 0.5f + 0.5f) * m_Height;
+			z[i] = vertex.z / vertex.w * 0.5f + 0.5f;
+		}
+
+		float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+		if (glm::abs(area) < 1e-8f)
+		{
+			return;
+		}
+
+		// Both windings are rasterized, the nearest depth wins either way
+		if (area < 0.0f)
+		{
+			std::swap(x[1], x[2]);
+			std::swap(y[1], y[2]);
+			std::swap(z[1], z[2]);
+			area = -area;
+		}
+
+		Triangle triangle;
+		triangle.MinX = std::max((int32_t)glm::floor(std::min({ x[0], x[1], x[2] })), 0);
+		triangle.MinY = std::max((int32_t)glm::floor(std::min({ y[0], y[1], y[2] })), 0);
+		triangle.MaxX = std::min((int32_t)glm::ceil(std::max({ x[0], x[1], x[2] })), (int32_t)m_Width - 1);
+		triangle.MaxY = std::min((int32_t)glm::ceil(std::max({ y[0], y[1], y[2] })), (int32_t)m_Height - 1);
+
+		if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+		{
+			return;
+		}
+
+		// Edge i goes from vertex i to vertex i + 1
+		for (int i = 0; i < 3; i++)
+		{
+			int j = (i + 1) % 3;
+			triangle.EdgeA[i] = y[i] - y[j];
+			triangle.EdgeB[i] = x[j] - x[i];
+			triangle.EdgeC[i] = -(triangle.EdgeA[i] * x[i] + triangle.EdgeB[i] * y[i]);
+		}
+
+		// Barycentric weights of vertices 1 and 2 are the edges facing them (2 -> 0 and 0 -> 1) over the area
+		float depth1 = (z[1] - z[0]) / area;
+		float depth2 = (z[2] - z[0]) / area;
+		triangle.DepthA = triangle.EdgeA[2] * depth1 + triangle.EdgeA[0] * depth2;
+		triangle.DepthB = triangle.EdgeB[2] * depth1 + triangle.EdgeB[0] * depth2;
+		triangle.DepthC = triangle.EdgeC[2] * depth1 + triangle.EdgeC[0] * depth2 + z[0];
+
+		uint32_t triangleIndex = (uint32_t)m_Triangles.size();
+		m_Triangles.push_back(triangle);
+
+		for (int32_t tileY = triangle.MinY / TileHeight; tileY <= triangle.MaxY / (int32_t)TileHeight; tileY++)
+		{
+			for (int32_t tileX = triangle.MinX / TileWidth; tileX <= triangle.MaxX / (int32_t)TileWidth; tileX++)
+			{
+				m_TileBins[tileY * m_TilesX + tileX].push_back(triangleIndex);
+			}
+		}
+	}
+
+	void OcclusionCuller::Rasterize()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		if (m_Triangles.empty())
+		{
+			return;
+		}
+
+		// Tiles don't share pixels, so they are rasterized in any order on any thread without further synchronization
+		JobSystem::ParallelFor(m_TilesX * m_TilesY, 1, [this](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t tile = begin; tile < end; tile++)
+			{
+				RasterizeTile(tile);
+			}
+		});
+	}
+
+	void OcclusionCuller::RasterizeTile(uint32_t tileIndex)
+	{
+		const std::vector<uint32_t>& bin = m_TileBins[tileIndex];
+		if (bin.empty())
+		{
+			return;
+		}
+
+		int32_t tileMinX = (tileIndex % m_TilesX) * TileWidth;
+		int32_t tileMinY = (tileIndex / m_TilesX) * TileHeight;
+		int32_t tileMaxX = tileMinX + TileWidth - 1;
+		int32_t tileMaxY = tileMinY + TileHeight - 1;
+
+		for (uint32_t triangleIndex : bin)
+		{
+			const Triangle& triangle = m_Triangles[triangleIndex];
+
+			// Columns start on a multiple of 4 so each step stays inside the tile
+			int32_t startX = std::max(triangle.MinX, tileMinX) & ~3;
+			int32_t endX   = std::min(triangle.MaxX, tileMaxX);
+			int32_t startY = std::max(triangle.MinY, tileMinY);
+			int32_t endY   = std::min(triangle.MaxY, tileMaxY);
+
+#ifdef ATLAS_OCCLUSION_SSE
+			const __m128 columnOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+			const __m128 zero = _mm_setzero_ps();
+
+			__m128 edgeA[3], edgeB[3], edgeC[3];
+			for (int i = 0; i < 3; i++)
+			{
+				edgeA[i] = _mm_set1_ps(triangle.EdgeA[i]);
+				edgeB[i] = _mm_set1_ps(triangle.EdgeB[i]);
+				edgeC[i] = _mm_set1_ps(triangle.EdgeC[i]);
+			}
+
+			__m128 depthA = _mm_set1_ps(triangle.DepthA);
+			__m128 depthB = _mm_set1_ps(triangle.DepthB);
+			__m128 depthC = _mm_set1_ps(triangle.DepthC);
+
+			for (int32_t y = startY; y <= endY; y++)
+			{
+				float* row = &m_Depth[y * m_Width];
+				__m128 pixelY = _mm_set1_ps(y + 0.5f);
+
+				for (int32_t x = startX; x <= endX; x += 4)
+				{
+					__m128 pixelX = _mm_add_ps(_mm_set1_ps((float)x), columnOffsets);
+
+					// Coverage mask of the 4 pixels: inside all three edges
+					__m128 coverage = _mm_cmpge_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], pixelX), _mm_mul_ps(edgeB[0], pixelY)), edgeC[0]), zero);
+					coverage = _mm_and_ps(coverage, _mm_cmpge_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], pixelX), _mm_mul_ps(edgeB[1], pixelY)), edgeC[1]), zero));
+					coverage = _mm_and_ps(coverage, _mm_cmpge_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], pixelX), _mm_mul_ps(edgeB[2], pixelY)), edgeC[2]), zero));
+
+					if (_mm_movemask_ps(coverage) == 0)
+					{
+						continue;
+					}
+
+					__m128 depth    = _mm_add_ps(_mm_add_ps(_mm_mul_ps(depthA, pixelX), _mm_mul_ps(depthB, pixelY)), depthC);
+					__m128 previous = _mm_loadu_ps(row + x);
+					__m128 nearest  = _mm_min_ps(previous, depth);
+
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(coverage, nearest), _mm_andnot_ps(coverage, previous)));
+				}
+			}
+#else
+			for (int32_t y = startY; y <= endY; y++)
+			{
+				float* row = &m_Depth[y * m_Width];
+				float pixelY = y + 0.5f;
+
+				for (int32_t x = startX; x <= endX; x++)
+				{
+					float pixelX = x + 0.5f;
+
+					bool isCovered = true;
+					for (int i = 0; i < 3; i++)
+					{
+						isCovered &= triangle.EdgeA[i] * pixelX + triangle.EdgeB[i] * pixelY + triangle.EdgeC[i] >= 0.0f;
+					}
+
+					if (isCovered)
+					{
+						row[x] = std::min(row[x], triangle.DepthA * pixelX + triangle.DepthB * pixelY + triangle.DepthC);
+					}
+				}
+			}
+#endif
+		}
+
+		float maxDepth = 0.0f;
+		for (int32_t y = tileMinY; y <= tileMaxY; y++)
+		{
+			const float* row = &m_Depth[y * m_Width];
+			for (int32_t x = tileMinX; x <= tileMaxX; x++)
+			{
+				maxDepth = std::max(maxDepth, row[x]);
+			}
+		}
+
+		m_TileMaxDepth[tileIndex] = maxDepth;
+	}
+
+	bool OcclusionCuller::IsVisible(const AABB& box) const
+	{
+		glm::vec3 ndcMin = glm::vec3(FLT_MAX);
+		glm::vec3 ndcMax = glm::vec3(-FLT_MAX);
+
+		for (int i = 0; i < 8; i++)
+		{
+			glm::vec3 corner = glm::vec3(i & 1 ? box.Max.x : box.Min.x, i & 2 ? box.Max.y : box.Min.y, i & 4 ? box.Max.z : box.Min.z);
+			glm::vec4 clip = m_ViewProjection * glm::vec4(corner, 1.0f);
+
+			if (clip.w < s_NearW)
+			{
+				return true;
+			}
+
+			glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			ndcMin = glm::min(ndcMin, ndc);
+			ndcMax = glm::max(ndcMax, ndc);
+		}
+
+		// Grown by a pixel to make up for occluders being sampled at pixel centers
+		int32_t minX = std::max((int32_t)glm::floor((ndcMin.x * 0.5f + 0.5f) * m_Width)  - 1, 0);
+		int32_t minY = std::max((int32_t)glm::floor((ndcMin.y * 0.5f + 0.5f) * m_Height) - 1, 0);
+		int32_t maxX = std::min((int32_t)glm::ceil((ndcMax.x * 0.5f + 0.5f) * m_Width)   + 1, (int32_t)m_Width - 1);
+		int32_t maxY = std::min((int32_t)glm::ceil((ndcMax.y * 0.5f + 0.5f) * m_Height)  + 1, (int32_t)m_Height - 1);
+
+		// Off screen, left to frustum culling
+		if (minX > maxX || minY > maxY)
+		{
+			return true;
+		}
+
+		float boxDepth = ndcMin.z * 0.5f + 0.5f;
+
+		for (int32_t tileY = minY / TileHeight; tileY <= maxY / (int32_t)TileHeight; tileY++)
+		{
+			for (int32_t tileX = minX / TileWidth; tileX <= maxX / (int32_t)TileWidth; tileX++)
+			{
+				// Every pixel of the tile is in front of the box
+				if (m_TileMaxDepth[tileY * m_TilesX + tileX] <= boxDepth)
+				{
+					continue;
+				}
+
+				int32_t startX = std::max(minX, tileX * (int32_t)TileWidth);
+				int32_t endX   = std::min(maxX, (tileX + 1) * (int32_t)TileWidth - 1);
+				int32_t startY = std::max(minY, tileY * (int32_t)TileHeight);
+				int32_t endY   = std::min(maxY, (tileY + 1) * (int32_t)TileHeight - 1);
+
+				for (int32_t y = startY; y <= endY; y++)
+				{
+					const float* row = &m_Depth[y * m_Width];
+
+#ifdef ATLAS_OCCLUSION_SSE
+					__m128 depth = _mm_set1_ps(boxDepth);
+					for (int32_t x = startX & ~3; x <= endX; x += 4)
+					{
+						// Lanes outside the tested columns are masked out
+						int laneMask = 0xF;
+						laneMask &= x < startX ? 0xF << (startX - x) : 0xF;
+						laneMask &= x + 3 > endX ? 0xF >> (x + 3 - endX) : 0xF;
+
+						if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(row + x), depth)) & laneMask)
+						{
+							return true;
+						}
+					}
+#else
+					for (int32_t x = startX; x <= endX; x++)
+					{
+						if (row[x] > boxDepth)
+						{
+							return true;
+						}
+					}
+#endif
+				}
+			}
+		}
+
+		return false;
+	}
+}
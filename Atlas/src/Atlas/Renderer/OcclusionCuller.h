@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Atlas/Math/Bounds.h"
+
+#include <glm/glm.hpp>
+
+namespace Atlas
+{
+	// Software occlusion culling: a few large occluders are rasterized into a small CPU depth buffer,
+	// then bounding boxes are tested against it. Runs entirely on the CPU (no graphics context needed).
+	// Depth is normalized to [0, 1], 1 being the far plane / nothing rasterized.
+	class OcclusionCuller
+	{
+	public:
+		static const uint32_t TileWidth  = 32; // Multiple of the SIMD width
+		static const uint32_t TileHeight = 32;
+
+		// Sizes are rounded up to whole tiles
+		OcclusionCuller(uint32_t width = 256, uint32_t height = 128);
+
+		// Clears the depth buffer and the occluders of the previous frame
+		void Begin(const glm::mat4& viewProjection);
+
+		// Positions are read with the given stride in bytes, so vertex structs can be passed as is
+		void AddOccluder(const glm::mat4& transform, const glm::vec3* positions, uint32_t stride, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+		// Rasterizes every occluder added since Begin, one screen tile per job system batch
+		void Rasterize();
+
+		// Conservative: anything straddling the near plane or not fully behind the occluders is visible
+		bool IsVisible(const AABB& box) const;
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		uint32_t GetTriangleCount() const { return (uint32_t)m_Triangles.size(); }
+		const std::vector<float>& GetDepthBuffer() const { return m_Depth; } // Row major, bottom row first
+
+	private:
+		// Screen space triangle setup: edge functions and depth plane, evaluated at pixel centers
+		struct Triangle
+		{
+			float EdgeA[3], EdgeB[3], EdgeC[3]; // Inside when A * x + B * y + C >= 0 for all three edges
+			float DepthA, DepthB, DepthC;       // depth = A * x + B * y + C
+			int32_t MinX, MinY, MaxX, MaxY;     // Inclusive pixel bounds, clamped to the buffer
+		};
+
+		void BinTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2);
+		void RasterizeTile(uint32_t tileIndex);
+
+		uint32_t m_Width;
+		uint32_t m_Height;
+		uint32_t m_TilesX;
+		uint32_t m_TilesY;
+
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+
+		std::vector<glm::vec4> m_ClipPositions; // Scratch for the occluder being added
+		std::vector<Triangle> m_Triangles;
+		std::vector<std::vector<uint32_t>> m_TileBins; // Triangle indices overlapping each tile
+		std::vector<float> m_Depth;
+		std::vector<float> m_TileMaxDepth;             // Farthest depth in each tile, a box behind it is hidden without per-pixel tests
+	};
+}
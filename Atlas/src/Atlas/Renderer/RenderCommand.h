@@ -27,6 +27,21 @@ namespace Atlas
 			s_RendererAPI->DisableDepthTest();
 		}
 
+		static void SetDepthFunction(const RendererAPI::TestFunction& function)
+		{
+			s_RendererAPI->SetDepthFunction(function);
+		}
+
+		static void SetDepthMask(bool isWritable)
+		{
+			s_RendererAPI->SetDepthMask(isWritable);
+		}
+
+		static void SetColorMask(bool isWritable)
+		{
+			s_RendererAPI->SetColorMask(isWritable);
+		}
+
 		static void SetStencilMask(const uint32_t& mask)
 		{
 			s_RendererAPI->SetStencilMask(mask);
@@ -77,14 +92,26 @@ namespace Atlas
 			s_RendererAPI->ClearDepth();
 		}
 
-		static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0)
+		// Base vertex is added to every index, e.g. to read from a region of a streaming buffer
+		static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t baseVertex = 0)
+		{
+			s_RendererAPI->DrawIndexed(vertexArray, indexCount, baseVertex);
+		}
+
+		static void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t instanceCount, uint32_t indexCount = 0)
+		{
+			s_RendererAPI->DrawIndexedInstanced(vertexArray, instanceCount, indexCount);
+		}
+
+		// Offset is in bytes into the indirect buffer
+		static void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t offset = 0)
 		{
-			s_RendererAPI->DrawIndexed(vertexArray, indexCount);
+			s_RendererAPI->MultiDrawIndexedIndirect(vertexArray, indirectBuffer, drawCount, offset);
 		}
 
-		static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+		static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0)
 		{
-			s_RendererAPI->DrawLines(vertexArray, vertexCount);
+			s_RendererAPI->DrawLines(vertexArray, vertexCount, firstVertex);
 		}
 
 		static void BindTextureSlot(uint32_t slot, uint32_t rendererID)
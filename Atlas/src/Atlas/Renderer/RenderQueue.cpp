@@ -0,0 +1,94 @@
+#include "atlaspch.h"
+#include "Atlas/Renderer/RenderQueue.h"
+
+#include "Atlas/Math/RadixSort.h"
+#include "Atlas/Scene/Components.h"
+
+namespace Atlas
+{
+	static const uint32_t s_PassBits     = 4;
+	static const uint32_t s_ShaderBits   = 4;
+	static const uint32_t s_MaterialBits = 16;
+	static const uint32_t s_TextureBits  = 16;
+	static const uint32_t s_DepthBits    = 24;
+
+	static const uint32_t s_DepthShift    = 0;
+	static const uint32_t s_TextureShift  = s_DepthShift + s_DepthBits;
+	static const uint32_t s_MaterialShift = s_TextureShift + s_TextureBits;
+	static const uint32_t s_ShaderShift   = s_MaterialShift + s_MaterialBits;
+	static const uint32_t s_PassShift     = s_ShaderShift + s_ShaderBits;
+
+	static_assert(s_PassShift + s_PassBits == 64, "Sort key fields must fill 64 bits");
+
+	void RenderQueue::SubmitSprite(const glm::mat4& transform, const SpriteRendererComponent& sprite, float depth, int entityID, Pass pass)
+	{
+		ShaderType shader = sprite.Type == SpriteRendererComponent::RenderType::Circle ? ShaderType::Circle : ShaderType::Quad;
+
+		// Sub textures are drawn from their sheet, quads sharing it share the texture slot
+		const void* texture = nullptr;
+		if (shader == ShaderType::Quad && sprite.Texture)
+		{
+			texture = sprite.SubTexture ? sprite.SubTexture->GetTexture().get() : sprite.Texture.get();
+		}
+
+		m_Packets.push_back({ MakeSortKey(pass, shader, 0, GetStateID(m_TextureSetIDs, texture), depth), (uint32_t)m_Commands.size() });
+
+		DrawCommand& command = m_Commands.emplace_back();
+		command.Transform = transform;
+		command.Sprite    = &sprite;
+		command.EntityID  = entityID;
+	}
+
+	void RenderQueue::SubmitMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, uint32_t lod, float depth, int entityID, Pass pass)
+	{
+		// A material always binds the same textures, so it is its own texture set
+		const void* materialKey = material == nullptr ? nullptr : material->Material.get();
+
+		m_Packets.push_back({ MakeSortKey(pass, ShaderType::Mesh, GetStateID(m_MaterialIDs, materialKey), 0, depth), (uint32_t)m_Commands.size() });
+
+		DrawCommand& command = m_Commands.emplace_back();
+		command.Transform = transform;
+		command.Mesh      = &mesh;
+		command.Material  = material;
+		command.LOD       = lod;
+		command.EntityID  = entityID;
+	}
+
+	void RenderQueue::Sort()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		RadixSort(m_Packets, m_SortScratch, [](const DrawPacket& packet) { return packet.SortKey; });
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_Packets.clear();
+		m_Commands.clear();
+		m_MaterialIDs.clear();
+		m_TextureSetIDs.clear();
+	}
+
+	uint64_t RenderQueue::MakeSortKey(Pass pass, ShaderType shader, uint32_t materialID, uint32_t textureSetID, float depth)
+	{
+		// Distances are non-negative, so the sign bit set by the sortable key is dropped along with the lowest mantissa bits
+		uint32_t depthBits = (GetSortableFloatKey(depth > 0.0f ? depth : 0.0f) & 0x7FFFFFFFu) >> (31 - s_DepthBits);
+
+		return (uint64_t)pass                                            << s_PassShift
+		     | (uint64_t)shader                                          << s_ShaderShift
+		     | (uint64_t)glm::min(materialID,   (1u << s_MaterialBits) - 1) << s_MaterialShift
+		     | (uint64_t)glm::min(textureSetID, (1u << s_TextureBits)  - 1) << s_TextureShift
+		     | (uint64_t)depthBits                                       << s_DepthShift;
+	}
+
+	uint32_t RenderQueue::GetStateID(std::unordered_map<const void*, uint32_t>& stateIDs, const void* state)
+	{
+		if (state == nullptr)
+		{
+			return 0;
+		}
+
+		auto [it, isNew] = stateIDs.try_emplace(state, (uint32_t)stateIDs.size() + 1);
+		return it->second;
+	}
+}
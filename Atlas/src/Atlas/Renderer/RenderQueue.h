@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Atlas
+{
+	struct SpriteRendererComponent;
+	struct MeshComponent;
+	struct MaterialComponent;
+
+	// Draws recorded while traversing the scene, then executed in sort key order so that draws sharing
+	// the same state end up next to each other (and in the same batches).
+	// Key layout, most significant bits first: pass (4), shader (4), material (16), texture set (16), depth (24).
+	class RenderQueue
+	{
+	public:
+		enum class Pass : uint8_t
+		{
+			Opaque = 0,
+		};
+
+		enum class ShaderType : uint8_t
+		{
+			Quad   = 0,
+			Circle = 1,
+			Mesh   = 2,
+		};
+
+		struct DrawPacket
+		{
+			uint64_t SortKey;
+			uint32_t CommandIndex;
+		};
+
+		// Components are referenced, not copied: the queue must be executed before the scene changes
+		struct DrawCommand
+		{
+			glm::mat4 Transform;
+			const SpriteRendererComponent* Sprite = nullptr; // Set for sprites
+			const MeshComponent* Mesh = nullptr;             // Set for meshes
+			const MaterialComponent* Material = nullptr;
+			uint32_t LOD = 0;                                // Meshes only
+			int EntityID = -1;
+		};
+
+		void SubmitSprite(const glm::mat4& transform, const SpriteRendererComponent& sprite, float depth, int entityID, Pass pass = Pass::Opaque);
+		void SubmitMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, uint32_t lod, float depth, int entityID, Pass pass = Pass::Opaque);
+
+		// Stable LSD radix sort on the keys, byte passes shared by every key are skipped
+		void Sort();
+		void Clear();
+
+		const std::vector<DrawPacket>& GetPackets() const { return m_Packets; }
+		const DrawCommand& GetCommand(uint32_t commandIndex) const { return m_Commands[commandIndex]; }
+		bool IsEmpty() const { return m_Packets.empty(); }
+
+		// Depth is a non-negative distance, front to back
+		static uint64_t MakeSortKey(Pass pass, ShaderType shader, uint32_t materialID, uint32_t textureSetID, float depth);
+
+	private:
+		// Small IDs, assigned in submission order, 0 meaning no material or texture
+		static uint32_t GetStateID(std::unordered_map<const void*, uint32_t>& stateIDs, const void* state);
+
+		std::vector<DrawPacket> m_Packets;
+		std::vector<DrawPacket> m_SortScratch;
+		std::vector<DrawCommand> m_Commands;
+
+		std::unordered_map<const void*, uint32_t> m_MaterialIDs;
+		std::unordered_map<const void*, uint32_t> m_TextureSetIDs;
+	};
+}
@@ -2,6 +2,7 @@
 #include "Atlas/Renderer/Renderer.h"
 
 #include <Atlas/Core/Application.h>
+#include "Atlas/Core/JobSystem.h"
 
 #include "Atlas/Renderer/ScreenSpaceRenderer.h"
 
@@ -10,10 +11,13 @@
 #include "Atlas/Renderer/Shader.h"
 #include "Atlas/Renderer/UniformBuffer.h"
 #include "Atlas/Renderer/StorageBuffer.h"
+#include "Atlas/Renderer/OcclusionCuller.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <atomic>
+
 namespace Atlas
 {
 	struct SimpleVertex
@@ -51,26 +55,68 @@ namespace Atlas
 	};
 
 	// 3D
-	struct MeshVertex
+	struct MeshObjectData // std430
 	{
-		glm::vec3 Position;
-		float EntityID;
-		glm::vec3 Normal;
-		glm::vec2 TexCoord;
-		glm::vec3 Tangent;
-		glm::vec3 Bitangent;
-
 		glm::mat4 Model;
+		glm::mat4 NormalMatrix;   // mat3 stored as mat4 for std430 alignment
+		glm::vec4 PositionOffset; // Mesh::GetPositionOffset, w: 1 if normals and tangents are octahedral-encoded
+		glm::vec4 PositionScale;  // Mesh::GetPositionScale
+		int MaterialIndex;
+
+		// Editor-only
+		int EntityID;
+
+		int Padding[2]; // Keeps the C++ size equal to the std430 array stride
+	};
 
-		glm::vec3 Color;
+	struct MeshMaterialData // std430
+	{
+		glm::vec4 Color;
 		float Metallic;
 		float Roughness;
-		float AlbedoTextureIndex;
-		float NormalTextureIndex;
-		float MetallicTextureIndex;
-		float RoughnessTextureIndex;
-		float AOTextureIndex;
-		float DisplacementTextureIndex;
+
+		int AlbedoTextureIndex;
+		int NormalTextureIndex;
+		int MetallicTextureIndex;
+		int RoughnessTextureIndex;
+		int AOTextureIndex;
+		int DisplacementTextureIndex;
+	};
+
+	struct MeshDrawCommand
+	{
+		Ref<Mesh> Mesh;
+		uint32_t LOD;        // Clamped to the mesh's levels
+		uint32_t ArenaIndex; // See GetMeshArenaIndex
+		const Material* Material; // Only used to group instances, parameters live in the object data
+		uint32_t ObjectIndex;
+		bool IsDepthPrepassed = false; // Drawn by the depth pre-pass, then shaded with an equal depth test
+
+		// Set by CullMeshClusters: the object is drawn as its visible meshlet ranges instead of instanced with the others
+		bool IsClusterCulled = false;
+		uint32_t ClusterRangeOffset = 0; // First range in MeshClusterRanges
+		uint32_t ClusterRangeCount  = 0; // 0 when every meshlet was culled
+	};
+
+	// Consecutive visible meshlets, merged into a single draw
+	struct MeshClusterRange
+	{
+		uint32_t FirstIndex; // Relative to the mesh's first index
+		uint32_t IndexCount;
+	};
+
+	struct MeshDrawRun
+	{
+		uint32_t ArenaIndex;
+		uint32_t DrawCount; // Consecutive indirect draws reading from the arena
+	};
+
+	// Queued draw whose vertices (or object data) are generated by worker threads into the range reserved for it
+	struct BatchFillJob
+	{
+		const RenderQueue::DrawCommand* Command;
+		uint32_t Offset;           // First vertex for quads and circles, object index for meshes
+		uint32_t TextureIndex = 0; // Quads only
 	};
 
 	struct RendererData
@@ -96,51 +142,66 @@ namespace Atlas
 
 		// 2D
 		Ref<VertexArray> QuadVertexArray;
-		Ref<VertexBuffer> QuadVertexBuffer;
+		Ref<StreamingBuffer> QuadVertexBuffer;
 		Ref<Shader> QuadShader;
 		glm::vec4 QuadVertexPositions[4];
 		
 		Ref<VertexArray> CircleVertexArray;
-		Ref<VertexBuffer> CircleVertexBuffer;
+		Ref<StreamingBuffer> CircleVertexBuffer;
 		Ref<Shader> CircleShader;
 
 		Ref<VertexArray> LineVertexArray;
-		Ref<VertexBuffer> LineVertexBuffer;
+		Ref<StreamingBuffer> LineVertexBuffer;
 		Ref<Shader> LineShader;
 
 		uint32_t QuadVertexCount = 0;
 		uint32_t QuadIndexCount = 0;
-		QuadVertex* QuadVertexBufferBase = nullptr;
+		QuadVertex* QuadVertexBufferRegion = nullptr; // Mapped region of QuadVertexBuffer filled by this batch
 
 		uint32_t CircleVertexCount = 0;
 		uint32_t CircleIndexCount = 0;
-		CircleVertex* CircleVertexBufferBase = nullptr;
+		CircleVertex* CircleVertexBufferRegion = nullptr; // Mapped region of CircleVertexBuffer filled by this batch
 
 		uint32_t LineVertexCount = 0;
 		uint32_t LineIndexCount = 0;
-		SimpleVertex* LineVertexBufferBase = nullptr;
+		SimpleVertex* LineVertexBufferRegion = nullptr; // Mapped region of LineVertexBuffer filled by this batch
+
+		// 3D (geometry lives on the GPU, in one arena per vertex format and index type shared by all meshes)
+		static const uint32_t MeshVertexFormatCount = 2;
+		static const uint32_t MeshIndexTypeCount = 2;
+		static const uint32_t MeshArenaCount = MeshVertexFormatCount * MeshIndexTypeCount;
+		static const uint32_t MaxArenaVertices = 1 << 20; // TODO: Check renderer capabilities
+		static const uint32_t MaxArenaIndices  = 1 << 21; // TODO: Check renderer capabilities
+		static const uint32_t MaxMeshInstances = 1 << 16;
+		static const uint32_t PerVertexMeshDataSize = 168; // Former batched MeshVertex: geometry, model matrix and material in every vertex
+		std::array<Scope<GeometryArena>, MeshArenaCount> MeshGeometryArenas; // Indexed by GetMeshArenaIndex
+		Ref<VertexBuffer> MeshObjectIndexVertexBuffer; // 0, 1, 2... read per instance: BaseInstance selects the object data
 
-		// 3D
-		Ref<VertexArray> MeshVertexArray;
-		Ref<VertexBuffer> MeshVertexBuffer;
-		Ref<IndexBuffer> MeshIndexBuffer;
 		Ref<Shader> MeshShader;
-		
-		uint32_t MeshVertexCount = 0;
-		uint32_t MeshIndexCount = 0;
-		MeshVertex* MeshVertexBufferBase = nullptr;
-		uint32_t* MeshIndexBufferBase = nullptr;
+		std::vector<MeshDrawCommand> MeshDrawCommands;
+		std::array<uint32_t, MeshArenaCount> MeshIndirectDrawCounts = {};
+
+		// Depth pre-pass (positions only: pre-passed meshes come first in the indirect draws, then the others)
+		Ref<Shader> MeshDepthShader;
+		std::array<uint32_t, MeshArenaCount> MeshDepthPrepassIndirectDrawCounts = {};
 
 		// Outline
-		Ref<VertexArray> MeshOutlineVertexArray;
-		Ref<VertexBuffer> MeshOutlineVertexBuffer;
-		Ref<IndexBuffer> MeshOutlineIndexBuffer;
 		Ref<Shader> MeshOutlineShader;
-
-		uint32_t MeshOutlineVertexCount = 0;
-		uint32_t MeshOutlineIndexCount = 0;
-		SimpleVertex* MeshOutlineVertexBufferBase = nullptr;
-		uint32_t* MeshOutlineIndexBufferBase = nullptr;
+		std::vector<MeshDrawCommand> MeshOutlineDrawCommands;
+		std::array<uint32_t, MeshArenaCount> MeshOutlineIndirectDrawCounts = {};
+
+		// Transparent (forward lit and blended, drawn in submission order: the scene sorts them back to front)
+		Ref<Shader> MeshTransparentShader;
+		std::vector<MeshDrawCommand> MeshTransparentDrawCommands;
+		std::vector<MeshDrawRun> MeshTransparentDrawRuns;
+
+		// Instances and indirect draws (shared by meshes, outlines and transparent meshes, in that order)
+		std::vector<MeshObjectData> MeshObjects;      // Indexed by MeshDrawCommand::ObjectIndex
+		std::vector<MeshObjectData> MeshInstanceData; // MeshObjects reordered by indirect draw, as uploaded
+		std::vector<MeshMaterialData> MeshMaterials;  // Indexed by MeshObjectData::MaterialIndex
+		std::unordered_map<const Material*, uint32_t> MeshMaterialIndices;
+		std::vector<DrawIndexedIndirectCommand> MeshIndirectCommands;
+		Ref<IndirectBuffer> MeshIndirectBuffer;
 
 		// Skybox
 		Ref<VertexArray> CubeVertexArray;
@@ -153,6 +214,39 @@ namespace Atlas
 		Ref<Texture2D> WhiteTexture;
 		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
 		uint32_t TextureSlotIndex = 1; // 0 = white texture
+		std::unordered_map<uint32_t, uint32_t> TextureSlotIndices; // Renderer ID -> slot
+
+		// Material textures, pooled into arrays so most materials share the same few bindings
+		static const uint32_t MaterialTextureCount = 6;
+		Scope<TextureArrayPool> MaterialTexturePool;
+		TextureArrayPool::Location WhiteTextureLocation;
+		std::array<uint32_t, MaxTextureSlots> TextureArraySlots; // Pool array index bound to each slot
+		uint32_t TextureArraySlotIndex = 1; // 0 = array holding the white texture
+		std::unordered_map<uint32_t, uint32_t> TextureArraySlotIndices; // Pool array index -> slot
+
+		// Occlusion culling
+		Scope<OcclusionCuller> SceneOcclusionCuller;
+		Ref<Texture2D> OcclusionDebugTexture;
+		std::vector<uint32_t> OcclusionDebugPixels;
+
+		// Render queue
+		RenderQueue SceneRenderQueue;
+
+		// Batch building: queued draws reserve their ranges in order (a running prefix sum of vertices, indices and objects),
+		// then the job system's workers fill them right before the batch is flushed
+		static const uint32_t BatchFillChunkSize = 128;
+		static const uint32_t MinParallelBatchFillJobs = 512; // Below this, queuing jobs costs more than it saves
+		std::vector<BatchFillJob> QuadFillJobs;
+		std::vector<BatchFillJob> CircleFillJobs;
+		std::vector<BatchFillJob> MeshFillJobs;
+
+		// Cluster culling: opaque meshes split into enough meshlets are tested meshlet by meshlet against the frustum and
+		// their normal cones, on worker threads, before their indirect draws are built
+		static const uint32_t MinCulledMeshletCount = 8;       // Smaller meshes are drawn whole
+		static const uint32_t ClusterCullChunkSize = 4;         // Meshes per chunk
+		static const uint32_t MinParallelClusterCullMeshes = 32;
+		std::vector<uint32_t> ClusterCullCommands; // Indices in MeshDrawCommands
+		std::vector<MeshClusterRange> MeshClusterRanges;
 
 		// Camera
 		struct CameraData
@@ -164,6 +258,9 @@ namespace Atlas
 		};
 		CameraData CameraBuffer;
 		Ref<UniformBuffer> CameraUniformBuffer;
+		Frustum CameraFrustum;
+		glm::vec3 CameraForward = glm::vec3(0.0f, 0.0f, -1.0f);
+		bool IsCameraOrthographic = false;
 
 		// Lights
 		uint32_t LightCountBuffer;
@@ -173,6 +270,12 @@ namespace Atlas
 		uint32_t LightStorageBufferCapacity = 100;
 		Ref<StorageBuffer> LightStorageBuffer;
 
+		uint32_t MeshObjectStorageBufferCapacity = 1024;
+		Ref<StorageBuffer> MeshObjectStorageBuffer;
+
+		uint32_t MeshMaterialStorageBufferCapacity = 256;
+		Ref<StorageBuffer> MeshMaterialStorageBuffer;
+
 		// Graphics Settings
 		struct Settings
 		{
@@ -187,6 +290,11 @@ namespace Atlas
 		bool HDR = false;
 		bool Bloom = true;
 		bool SSAO = true;
+		bool OcclusionCulling = false;
+		bool ClusterCulling = true;
+		bool DepthPrepass = true;
+		bool RenderQueueSorting = true;
+		bool FramePipelining = true; // Scenes build their next render packet while the last one is drawn
 		Cubemap::MapType SkyboxType = Cubemap::MapType::Cubemap;
 		Renderer::RenderBuffers DisplayedRenderBuffer = Renderer::RenderBuffers::Final;
 
@@ -197,6 +305,101 @@ namespace Atlas
 
 	static RendererData s_RendererData;
 
+	static uint32_t GetMeshArenaIndex(Mesh::VertexFormat format, IndexType indexType)
+	{
+		return (uint32_t)format * RendererData::MeshIndexTypeCount + (uint32_t)indexType;
+	}
+
+	// Calls job(0) to job(jobCount - 1) in chunks, spread over the job system's workers when there are enough of them.
+	// Jobs must be independent: they run in any order on any thread.
+	template<typename Job>
+	static void RunJobs(uint32_t jobCount, uint32_t chunkSize, uint32_t minParallelJobCount, const Job& job)
+	{
+		auto runRange = [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				job(i);
+			}
+		};
+
+		if (jobCount < minParallelJobCount)
+		{
+			runRange(0, jobCount);
+			return;
+		}
+
+		JobSystem::ParallelFor(jobCount, chunkSize, runRange);
+	}
+
+	// Alpha tested albedo textures and parallax mapping make the G-Buffer shader discard fragments. Depth pre-passing
+	// such materials would write depth where nothing is shaded, so they are drawn with a regular depth test instead.
+	static bool CanMaterialDiscard(const MaterialComponent* material)
+	{
+		if (material == nullptr)
+		{
+			return false;
+		}
+
+		const Ref<Texture2D>& albedoTexture = material->Material->GetAlbedoTexture();
+		ImageFormat albedoFormat = albedoTexture ? albedoTexture->GetSpecification().Format : ImageFormat::None;
+		bool hasAlbedoAlpha = albedoFormat == ImageFormat::RGBA8 || albedoFormat == ImageFormat::RGBA16F || albedoFormat == ImageFormat::RGBA32F;
+
+		return hasAlbedoAlpha || material->Material->GetDisplacementTexture() != nullptr;
+	}
+
+	static void AddMeshIndirectCommand(const GeometryArena::Allocation& geometry)
+	{
+		DrawIndexedIndirectCommand& indirectCommand = s_RendererData.MeshIndirectCommands.emplace_back();
+		indirectCommand.IndexCount    = geometry.IndexCount;
+		indirectCommand.InstanceCount = 0;
+		indirectCommand.FirstIndex    = geometry.FirstIndex;
+		indirectCommand.BaseVertex    = geometry.BaseVertex;
+		indirectCommand.BaseInstance  = (uint32_t)s_RendererData.MeshInstanceData.size();
+	}
+
+	static void FillQuadVertices(const BatchFillJob& job)
+	{
+		constexpr glm::vec2 defaultTextureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+		const SpriteRendererComponent& sprite = *job.Command->Sprite;
+		const glm::vec2* textureCoords = sprite.Texture && sprite.SubTexture ? sprite.SubTexture->GetTexCoords() : defaultTextureCoords;
+		float tilingFactor = sprite.Texture ? sprite.TilingFactor : 1.0f;
+
+		QuadVertex* vertices = s_RendererData.QuadVertexBufferRegion + job.Offset;
+		for (size_t i = 0; i < 4; i++)
+		{
+			vertices[i].Position     = job.Command->Transform * s_RendererData.QuadVertexPositions[i];
+			vertices[i].Color        = sprite.Color;
+			vertices[i].TexCoord     = textureCoords[i];
+			vertices[i].TexIndex     = job.TextureIndex;
+			vertices[i].TilingFactor = tilingFactor;
+			vertices[i].EntityID     = job.Command->EntityID;
+		}
+	}
+
+	static void FillCircleVertices(const BatchFillJob& job)
+	{
+		const SpriteRendererComponent& sprite = *job.Command->Sprite;
+
+		CircleVertex* vertices = s_RendererData.CircleVertexBufferRegion + job.Offset;
+		for (size_t i = 0; i < 4; i++)
+		{
+			vertices[i].WorldPosition = job.Command->Transform * s_RendererData.QuadVertexPositions[i];
+			vertices[i].LocalPosition = s_RendererData.QuadVertexPositions[i] * 2.0f;
+			vertices[i].Color         = sprite.Color;
+			vertices[i].Thickness     = sprite.Thickness;
+			vertices[i].Fade          = sprite.Fade;
+			vertices[i].EntityID      = job.Command->EntityID;
+		}
+	}
+
+	static void FillMeshObjectTransform(MeshObjectData& objectData, const glm::mat4& transform)
+	{
+		objectData.Model        = transform;
+		objectData.NormalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(transform))));
+	}
+
 	void Renderer::Init()
 	{
 		ATLAS_PROFILE_FUNCTION();
@@ -232,7 +435,7 @@ namespace Atlas
 		s_RendererData.QuadVertexArray = VertexArray::Create();
 
 		// Quad VBO
-		s_RendererData.QuadVertexBuffer = VertexBuffer::Create(s_RendererData.MaxQuadVertices * sizeof(QuadVertex));
+		s_RendererData.QuadVertexBuffer = StreamingBuffer::Create(s_RendererData.MaxQuadVertices * sizeof(QuadVertex));
 		s_RendererData.QuadVertexBuffer->SetLayout({
 			{ ShaderDataType::Float3, "a_Position"     },
 			{ ShaderDataType::Float4, "a_Color"        },
@@ -242,7 +445,6 @@ namespace Atlas
 			{ ShaderDataType::Int,    "a_EntityID"     }
 		});
 		s_RendererData.QuadVertexArray->AddVertexBuffer(s_RendererData.QuadVertexBuffer);
-		s_RendererData.QuadVertexBufferBase = new QuadVertex[s_RendererData.MaxQuadVertices];
 
 		s_RendererData.QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
 		s_RendererData.QuadVertexPositions[1] = {  0.5f, -0.5f, 0.0f, 1.0f };
@@ -272,7 +474,7 @@ namespace Atlas
 		s_RendererData.CircleVertexArray = VertexArray::Create();
 
 		// Circle VBO
-		s_RendererData.CircleVertexBuffer = VertexBuffer::Create(s_RendererData.MaxQuadVertices * sizeof(CircleVertex));
+		s_RendererData.CircleVertexBuffer = StreamingBuffer::Create(s_RendererData.MaxQuadVertices * sizeof(CircleVertex));
 		s_RendererData.CircleVertexBuffer->SetLayout({
 			{ ShaderDataType::Float3, "a_WorldPosition" },
 			{ ShaderDataType::Float3, "a_LocalPosition" },
@@ -282,7 +484,6 @@ namespace Atlas
 			{ ShaderDataType::Int,    "a_EntityID"      }
 			});
 		s_RendererData.CircleVertexArray->AddVertexBuffer(s_RendererData.CircleVertexBuffer);
-		s_RendererData.CircleVertexBufferBase = new CircleVertex[s_RendererData.MaxQuadVertices];
 
 		// Circle IBO / EBO
 		s_RendererData.CircleVertexArray->SetIndexBuffer(quadIndexBuffer);
@@ -291,57 +492,44 @@ namespace Atlas
 		s_RendererData.LineVertexArray = VertexArray::Create();
 
 		// Line VBO
-		s_RendererData.LineVertexBuffer = VertexBuffer::Create(s_RendererData.MaxVertices * sizeof(SimpleVertex));
+		s_RendererData.LineVertexBuffer = StreamingBuffer::Create(s_RendererData.MaxVertices * sizeof(SimpleVertex));
 		s_RendererData.LineVertexBuffer->SetLayout({
 			{ ShaderDataType::Float3, "a_Position" },
 			{ ShaderDataType::Float4, "a_Color"    },
 			{ ShaderDataType::Int,    "a_EntityID" }
 			});
 		s_RendererData.LineVertexArray->AddVertexBuffer(s_RendererData.LineVertexBuffer);
-		s_RendererData.LineVertexBufferBase = new SimpleVertex[s_RendererData.MaxVertices];
-
-		// Mesh VAO
-		s_RendererData.MeshVertexArray = VertexArray::Create();
-
-		// Mesh VBO
-		s_RendererData.MeshVertexBuffer = VertexBuffer::Create(s_RendererData.MaxVertices * sizeof(MeshVertex));
-		s_RendererData.MeshVertexBuffer->SetLayout({
-			{ ShaderDataType::Float4, "a_Position_ID"                        }, // XYZ: Position, W: EntityID (editor-only)
-			{ ShaderDataType::Float3, "a_Normal"                             },
-			{ ShaderDataType::Float2, "a_TexCoord"                           },
-			{ ShaderDataType::Float3, "a_Tangent"                            },
-			{ ShaderDataType::Float3, "a_Bitangent"                          },
-			{ ShaderDataType::Mat4,   "a_Model"                              },
-			{ ShaderDataType::Float3, "a_Color"                              },
-			{ ShaderDataType::Float2, "a_Metallic_Roughness"                 }, // X: Metallic,  Y: Roughness
-			{ ShaderDataType::Float3, "a_Albedo_Normal_Metallic_TexIndex"    }, // X: Albedo,    Y: Normal, Z: Metallic
-			{ ShaderDataType::Float3, "a_Roughness_AO_Displacement_TexIndex" }  // X: Roughness, Y: AO,     Z: Displacement
-			});
-		s_RendererData.MeshVertexArray->AddVertexBuffer(s_RendererData.MeshVertexBuffer);
-		s_RendererData.MeshVertexBufferBase = new MeshVertex[s_RendererData.MaxVertices];
 
-		// Mesh IBO / EBO
-		s_RendererData.MeshIndexBuffer = IndexBuffer::Create(s_RendererData.MaxIndices * sizeof(uint32_t));
-		s_RendererData.MeshVertexArray->SetIndexBuffer(s_RendererData.MeshIndexBuffer);
-		s_RendererData.MeshIndexBufferBase = new uint32_t[s_RendererData.MaxIndices];
-
-		// Outline VAO
-		s_RendererData.MeshOutlineVertexArray = VertexArray::Create();
-
-		// Outline VBO
-		s_RendererData.MeshOutlineVertexBuffer = VertexBuffer::Create(s_RendererData.MaxVertices * sizeof(SimpleVertex));
-		s_RendererData.MeshOutlineVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3, "a_Position" },
-			{ ShaderDataType::Float4, "a_Color"    },
-			{ ShaderDataType::Int,    "a_EntityID" }
+		// Mesh object index VBO
+		std::vector<uint32_t> objectIndices(s_RendererData.MaxMeshInstances);
+		for (uint32_t i = 0; i < s_RendererData.MaxMeshInstances; i++)
+		{
+			objectIndices[i] = i;
+		}
+		s_RendererData.MeshObjectIndexVertexBuffer = VertexBuffer::Create(objectIndices.data(), s_RendererData.MaxMeshInstances * sizeof(uint32_t));
+		s_RendererData.MeshObjectIndexVertexBuffer->SetLayout({
+			{ ShaderDataType::UInt, "a_ObjectIndex" }
 			});
-		s_RendererData.MeshOutlineVertexArray->AddVertexBuffer(s_RendererData.MeshOutlineVertexBuffer);
-		s_RendererData.MeshOutlineVertexBufferBase = new SimpleVertex[s_RendererData.MaxVertices];
 
-		// Outline IBO / EBO
-		s_RendererData.MeshOutlineIndexBuffer = IndexBuffer::Create(s_RendererData.MaxIndices * sizeof(uint32_t));
-		s_RendererData.MeshOutlineVertexArray->SetIndexBuffer(s_RendererData.MeshOutlineIndexBuffer);
-		s_RendererData.MeshOutlineIndexBufferBase = new uint32_t[s_RendererData.MaxIndices];
+		// Mesh arena VAOs: meshes upload their geometry once (see Mesh::GetGeometry), only draw commands are recorded per frame
+		// Meshes small enough for 16-bit indices get their own arenas, halving their index memory and fetch bandwidth
+		for (uint32_t format = 0; format < s_RendererData.MeshVertexFormatCount; format++)
+		{
+			for (uint32_t indexType = 0; indexType < s_RendererData.MeshIndexTypeCount; indexType++)
+			{
+				uint32_t arenaIndex = GetMeshArenaIndex((Mesh::VertexFormat)format, (IndexType)indexType);
+				s_RendererData.MeshGeometryArenas[arenaIndex] = CreateScope<GeometryArena>(Mesh::GetVertexLayout((Mesh::VertexFormat)format),
+					s_RendererData.MaxArenaVertices, s_RendererData.MaxArenaIndices, (IndexType)indexType, s_RendererData.MeshObjectIndexVertexBuffer);
+			}
+		}
+
+		s_RendererData.MeshDrawCommands.reserve(1024);
+		s_RendererData.MeshOutlineDrawCommands.reserve(64);
+		s_RendererData.MeshTransparentDrawCommands.reserve(64);
+		s_RendererData.MeshObjects.reserve(1024);
+		s_RendererData.MeshInstanceData.reserve(1024);
+		s_RendererData.MeshMaterials.reserve(256);
+		s_RendererData.MeshIndirectCommands.reserve(256);
 	}
 
 	void Renderer::InitCube()
@@ -445,16 +633,36 @@ namespace Atlas
 		uint32_t whiteTextureData = 0xffffffff;
 		s_RendererData.WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
 		s_RendererData.TextureSlots[0] = s_RendererData.WhiteTexture;
+
+		// Pooled first, so the white texture is layer 0 of the array in slot 0: material texture index 0
+		s_RendererData.MaterialTexturePool = CreateScope<TextureArrayPool>();
+		s_RendererData.WhiteTextureLocation = s_RendererData.MaterialTexturePool->Get(s_RendererData.WhiteTexture);
+		s_RendererData.TextureArraySlots[0] = s_RendererData.WhiteTextureLocation.ArrayIndex;
+		ATLAS_CORE_ASSERT(s_RendererData.WhiteTextureLocation.Layer == 0, "White texture must be the first pooled layer!");
+
+		s_RendererData.SceneOcclusionCuller = CreateScope<OcclusionCuller>();
+
+		TextureSpecification occlusionDebugTextureSpecification = TextureSpecification();
+		occlusionDebugTextureSpecification.Width        = s_RendererData.SceneOcclusionCuller->GetWidth();
+		occlusionDebugTextureSpecification.Height       = s_RendererData.SceneOcclusionCuller->GetHeight();
+		occlusionDebugTextureSpecification.GenerateMips = false;
+		occlusionDebugTextureSpecification.MagFilter    = ResizeFilter::Nearest;
+		occlusionDebugTextureSpecification.MinFilter    = ResizeFilter::Nearest;
+		s_RendererData.OcclusionDebugTexture = Texture2D::Create(occlusionDebugTextureSpecification);
+		s_RendererData.OcclusionDebugPixels.resize(occlusionDebugTextureSpecification.Width * occlusionDebugTextureSpecification.Height, 0xff000000);
+		s_RendererData.OcclusionDebugTexture->SetData(s_RendererData.OcclusionDebugPixels.data(), (uint32_t)s_RendererData.OcclusionDebugPixels.size() * sizeof(uint32_t));
 	}
 
 	void Renderer::InitShaders()
 	{
-		s_RendererData.QuadShader        = Shader::Create("assets/shaders/2D/Renderer2D_Quad_Vert.glsl"   , "assets/shaders/2D/Renderer2D_Quad_Frag.glsl"   );
-		s_RendererData.CircleShader      = Shader::Create("assets/shaders/2D/Renderer2D_Circle_Vert.glsl" , "assets/shaders/2D/Renderer2D_Circle_Frag.glsl" );
-		s_RendererData.LineShader        = Shader::Create("assets/shaders/2D/Renderer2D_Line_Vert.glsl"   , "assets/shaders/2D/Renderer2D_Line_Frag.glsl"   );
-		s_RendererData.MeshShader        = Shader::Create("assets/shaders/3D/Renderer3D_GBuffer_Vert.glsl", "assets/shaders/3D/Renderer3D_GBuffer_Frag.glsl");
-		s_RendererData.MeshOutlineShader = Shader::Create("assets/shaders/3D/Renderer3D_Outline_Vert.glsl", "assets/shaders/3D/Renderer3D_Outline_Frag.glsl");
-		s_RendererData.SkyboxShader      = Shader::Create("assets/shaders/Skybox/Skybox_Vert.glsl"        , "assets/shaders/Skybox/Skybox_Frag.glsl"        );
+		s_RendererData.QuadShader            = Shader::Create("assets/shaders/2D/Renderer2D_Quad_Vert.glsl"   , "assets/shaders/2D/Renderer2D_Quad_Frag.glsl"   );
+		s_RendererData.CircleShader          = Shader::Create("assets/shaders/2D/Renderer2D_Circle_Vert.glsl" , "assets/shaders/2D/Renderer2D_Circle_Frag.glsl" );
+		s_RendererData.LineShader            = Shader::Create("assets/shaders/2D/Renderer2D_Line_Vert.glsl"   , "assets/shaders/2D/Renderer2D_Line_Frag.glsl"   );
+		s_RendererData.MeshShader            = Shader::Create("assets/shaders/3D/Renderer3D_GBuffer_Vert.glsl", "assets/shaders/3D/Renderer3D_GBuffer_Frag.glsl");
+		s_RendererData.MeshDepthShader       = Shader::Create("assets/shaders/3D/Renderer3D_Depth_Vert.glsl"  , "assets/shaders/3D/Renderer3D_Depth_Frag.glsl"  );
+		s_RendererData.MeshOutlineShader     = Shader::Create("assets/shaders/3D/Renderer3D_Outline_Vert.glsl", "assets/shaders/3D/Renderer3D_Outline_Frag.glsl");
+		s_RendererData.MeshTransparentShader = Shader::Create("assets/shaders/3D/Renderer3D_GBuffer_Vert.glsl", "assets/shaders/3D/Renderer3D_Transparent_Frag.glsl");
+		s_RendererData.SkyboxShader          = Shader::Create("assets/shaders/Skybox/Skybox_Vert.glsl"        , "assets/shaders/Skybox/Skybox_Frag.glsl"        );
 	}
 
 	void Renderer::InitBuffers()
@@ -465,24 +673,24 @@ namespace Atlas
 		s_RendererData.LightCountUniformBuffer    = UniformBuffer::Create(sizeof(uint32_t)                   , 2);
 
 		// Storage buffers
-		s_RendererData.LightStorageBuffer = StorageBuffer::Create(sizeof(LightData) * s_RendererData.LightStorageBufferCapacity, 0);
+		s_RendererData.LightStorageBuffer        = StorageBuffer::Create(sizeof(LightData) * s_RendererData.LightStorageBufferCapacity          , 0);
+		s_RendererData.MeshObjectStorageBuffer   = StorageBuffer::Create(sizeof(MeshObjectData) * s_RendererData.MeshObjectStorageBufferCapacity    , 1);
+		s_RendererData.MeshMaterialStorageBuffer = StorageBuffer::Create(sizeof(MeshMaterialData) * s_RendererData.MeshMaterialStorageBufferCapacity, 2);
+
+		// Indirect buffers
+		s_RendererData.MeshIndirectBuffer = IndirectBuffer::Create(sizeof(DrawIndexedIndirectCommand) * s_RendererData.MeshIndirectCommands.capacity());
 	}
 
 	void Renderer::Shutdown()
 	{
 		ATLAS_PROFILE_FUNCTION();
 
-		delete[] s_RendererData.QuadVertexBufferBase;
-
-		delete[] s_RendererData.CircleVertexBufferBase;
-
-		delete[] s_RendererData.LineVertexBufferBase;
-
-		delete[] s_RendererData.MeshVertexBufferBase;
-		delete[] s_RendererData.MeshIndexBufferBase;
+		s_RendererData.MaterialTexturePool.reset();
 
-		delete[] s_RendererData.MeshOutlineVertexBufferBase;
-		delete[] s_RendererData.MeshOutlineIndexBufferBase;
+		for (Scope<GeometryArena>& arena : s_RendererData.MeshGeometryArenas)
+		{
+			arena.reset();
+		}
 	}
 
 	uint32_t Renderer::GetLightStorageBufferCapacity()
@@ -490,6 +698,11 @@ namespace Atlas
 		return s_RendererData.LightStorageBufferCapacity;
 	}
 
+	GeometryArena* Renderer::GetMeshGeometryArena(Mesh::VertexFormat format, IndexType indexType)
+	{
+		return s_RendererData.MeshGeometryArenas[GetMeshArenaIndex(format, indexType)].get();
+	}
+
 	RendererAPI::PolygonMode Renderer::GetPolygonMode()
 	{
 		return s_RendererData.PolygonMode;
@@ -571,6 +784,56 @@ namespace Atlas
 		s_RendererData.SSAO = !s_RendererData.SSAO;
 	}
 
+	bool Renderer::IsOcclusionCullingEnabled()
+	{
+		return s_RendererData.OcclusionCulling;
+	}
+
+	void Renderer::ToggleOcclusionCulling()
+	{
+		s_RendererData.OcclusionCulling = !s_RendererData.OcclusionCulling;
+	}
+
+	bool Renderer::IsClusterCullingEnabled()
+	{
+		return s_RendererData.ClusterCulling;
+	}
+
+	void Renderer::ToggleClusterCulling()
+	{
+		s_RendererData.ClusterCulling = !s_RendererData.ClusterCulling;
+	}
+
+	bool Renderer::IsDepthPrepassEnabled()
+	{
+		return s_RendererData.DepthPrepass;
+	}
+
+	void Renderer::ToggleDepthPrepass()
+	{
+		s_RendererData.DepthPrepass = !s_RendererData.DepthPrepass;
+	}
+
+	bool Renderer::IsRenderQueueSortingEnabled()
+	{
+		return s_RendererData.RenderQueueSorting;
+	}
+
+	void Renderer::ToggleRenderQueueSorting()
+	{
+		s_RendererData.RenderQueueSorting = !s_RendererData.RenderQueueSorting;
+	}
+
+	bool Renderer::IsFramePipeliningEnabled()
+	{
+		return s_RendererData.FramePipelining;
+	}
+
+	void Renderer::ToggleFramePipelining()
+	{
+		s_RendererData.FramePipelining = !s_RendererData.FramePipelining;
+	}
+
 	void Renderer::SetSkyboxType(Cubemap::MapType skyboxType)
 	{
 		s_RendererData.SkyboxType = skyboxType;
@@ -689,6 +952,10 @@ namespace Atlas
 		{
 			return GetSSAOFramebufferID();
 		}
+		else if (bufferType == RenderBuffers::Occlusion)
+		{
+			return s_RendererData.OcclusionDebugTexture->GetRendererID();
+		}
 		else
 		{
 			return s_RendererData.GBufferFramebuffer->GetColorAttachmentRendererID((uint32_t)bufferType);
@@ -706,9 +973,53 @@ namespace Atlas
 		memset(&s_RendererData.Stats, 0, sizeof(Statistics));
 	}
 
+	void Renderer::RecordCulledMeshes(uint32_t count)
+	{
+		s_RendererData.Stats.CulledMeshCount += count;
+	}
+
+	void Renderer::RecordCulledSprites(uint32_t count)
+	{
+		s_RendererData.Stats.CulledSpriteCount += count;
+	}
+
+	void Renderer::RecordOccludedMeshes(uint32_t count)
+	{
+		s_RendererData.Stats.OccludedMeshCount += count;
+	}
+
 	Renderer::Statistics Renderer::GetStats()
 	{
-		return s_RendererData.Stats;
+		Statistics stats = s_RendererData.Stats;
+
+		for (const Scope<GeometryArena>& arena : s_RendererData.MeshGeometryArenas)
+		{
+			if (!arena)
+			{
+				continue;
+			}
+
+			const FreeListAllocator& vertexAllocator = arena->GetVertexAllocator();
+			const FreeListAllocator& indexAllocator  = arena->GetIndexAllocator();
+
+			stats.ArenaVertexCount    += vertexAllocator.GetUsed();
+			stats.ArenaVertexCapacity += vertexAllocator.GetCapacity();
+			stats.ArenaVertexBytes    += (uint64_t)vertexAllocator.GetUsed() * arena->GetVertexSize();
+			stats.ArenaIndexCount     += indexAllocator.GetUsed();
+			stats.ArenaIndexCapacity  += indexAllocator.GetCapacity();
+			stats.ArenaIndexBytes     += (uint64_t)indexAllocator.GetUsed() * IndexTypeSize(arena->GetIndexType());
+			stats.ArenaFreeBlockCount += vertexAllocator.GetFreeBlockCount() + indexAllocator.GetFreeBlockCount();
+			stats.ArenaFragmentation   = std::max(stats.ArenaFragmentation, std::max(vertexAllocator.GetFragmentation(), indexAllocator.GetFragmentation()));
+		}
+
+		if (s_RendererData.MaterialTexturePool)
+		{
+			stats.PooledTextureCount = s_RendererData.MaterialTexturePool->GetTextureCount();
+			stats.TextureArrayCount  = s_RendererData.MaterialTexturePool->GetArrayCount();
+			stats.TextureArrayBytes  = s_RendererData.MaterialTexturePool->GetMemoryUsage();
+		}
+
+		return stats;
 	}
 
 	void Renderer::BeginScene(const Camera& camera, const TransformComponent& cameraTransform, const std::vector<LightData>& lights)
@@ -718,6 +1029,11 @@ namespace Atlas
 		SetUniformBuffers(camera.GetProjection(), glm::inverse(cameraTransform.GetTransform()), cameraTransform.Translation);
 		SetStorageBuffers(lights);
 
+		if (s_RendererData.OcclusionCulling)
+		{
+			s_RendererData.SceneOcclusionCuller->Begin(s_RendererData.CameraBuffer.ViewProjection);
+		}
+
 		StartBatch();
 	}
 
@@ -728,6 +1044,11 @@ namespace Atlas
 		SetUniformBuffers(camera.GetProjection(), camera.GetViewMatrix(), camera.GetPosition());
 		SetStorageBuffers(lights);
 
+		if (s_RendererData.OcclusionCulling)
+		{
+			s_RendererData.SceneOcclusionCuller->Begin(s_RendererData.CameraBuffer.ViewProjection);
+		}
+
 		StartBatch();
 	}
 
@@ -740,6 +1061,10 @@ namespace Atlas
 		s_RendererData.CameraBuffer.View           = cameraView;
 		s_RendererData.CameraBuffer.Position       = cameraPosition;
 		s_RendererData.CameraUniformBuffer->SetData(&s_RendererData.CameraBuffer, sizeof(RendererData::CameraData));
+
+		s_RendererData.CameraFrustum        = Frustum(s_RendererData.CameraBuffer.ViewProjection);
+		s_RendererData.CameraForward        = -glm::normalize(glm::vec3(glm::inverse(cameraView)[2]));
+		s_RendererData.IsCameraOrthographic = cameraProjection[3][3] == 1.0f;
 	}
 
 	void Renderer::SetStorageBuffers(const std::vector<LightData>& lights)
@@ -762,6 +1087,28 @@ namespace Atlas
 		s_RendererData.LightStorageBuffer->SetSize(sizeof(LightData) * s_RendererData.LightStorageBufferCapacity);
 	}
 
+	void Renderer::EnsureMeshObjectStorageBufferCapacity(uint32_t capacity)
+	{
+		if (capacity <= s_RendererData.MeshObjectStorageBufferCapacity)
+		{
+			return;
+		}
+
+		s_RendererData.MeshObjectStorageBufferCapacity = capacity;
+		s_RendererData.MeshObjectStorageBuffer->SetSize(sizeof(MeshObjectData) * s_RendererData.MeshObjectStorageBufferCapacity);
+	}
+
+	void Renderer::EnsureMeshMaterialStorageBufferCapacity(uint32_t capacity)
+	{
+		if (capacity <= s_RendererData.MeshMaterialStorageBufferCapacity)
+		{
+			return;
+		}
+
+		s_RendererData.MeshMaterialStorageBufferCapacity = capacity;
+		s_RendererData.MeshMaterialStorageBuffer->SetSize(sizeof(MeshMaterialData) * s_RendererData.MeshMaterialStorageBufferCapacity);
+	}
+
 	uint32_t Renderer::EnsureTextureSlot(const Ref<Texture2D>& texture)
 	{
 		uint32_t textureIndex = 0;
@@ -772,31 +1119,49 @@ namespace Atlas
 		}
 
 		// Check if texture is already slotted
-		for (uint32_t i = 1; i < s_RendererData.TextureSlotIndex; i++)
+		auto textureSlot = s_RendererData.TextureSlotIndices.find(texture->GetRendererID());
+		if (textureSlot != s_RendererData.TextureSlotIndices.end())
 		{
-			if (*s_RendererData.TextureSlots[i] == *texture)
-			{
-				textureIndex = i;
-				break;
-			}
+			return textureSlot->second;
 		}
 
-		// If texture is not found
-		if (textureIndex == 0)
+		if (s_RendererData.TextureSlotIndex >= RendererData::MaxTextureSlots)
 		{
-			if (s_RendererData.TextureSlotIndex >= RendererData::MaxTextureSlots)
-			{
-				NextBatch();
-			}
-
-			textureIndex = s_RendererData.TextureSlotIndex;
-			s_RendererData.TextureSlots[s_RendererData.TextureSlotIndex] = texture;
-			s_RendererData.TextureSlotIndex++;
+			s_RendererData.Stats.TextureBatchBreaks++;
+			NextBatch();
 		}
 
+		textureIndex = s_RendererData.TextureSlotIndex;
+		s_RendererData.TextureSlots[s_RendererData.TextureSlotIndex] = texture;
+		s_RendererData.TextureSlotIndices[texture->GetRendererID()] = textureIndex;
+		s_RendererData.TextureSlotIndex++;
+
 		return textureIndex;
 	}
 
+	uint32_t Renderer::EnsureTextureArraySlot(const TextureArrayPool::Location& location)
+	{
+		uint32_t slot;
+
+		auto arraySlot = s_RendererData.TextureArraySlotIndices.find(location.ArrayIndex);
+		if (arraySlot != s_RendererData.TextureArraySlotIndices.end())
+		{
+			slot = arraySlot->second;
+		}
+		else
+		{
+			// Callers make room beforehand, a batch break here would invalidate the indices they already got
+			ATLAS_CORE_ASSERT(s_RendererData.TextureArraySlotIndex < RendererData::MaxTextureSlots, "Out of texture array slots!");
+
+			slot = s_RendererData.TextureArraySlotIndex;
+			s_RendererData.TextureArraySlots[slot] = location.ArrayIndex;
+			s_RendererData.TextureArraySlotIndices[location.ArrayIndex] = slot;
+			s_RendererData.TextureArraySlotIndex++;
+		}
+
+		return slot << 16 | location.Layer;
+	}
+
 	void Renderer::EndScene()
 	{
 		ATLAS_PROFILE_FUNCTION();
@@ -806,124 +1171,483 @@ namespace Atlas
 
 	void Renderer::Flush()
 	{
+		BuildBatch();
+
+		uint32_t drawCalls = s_RendererData.Stats.DrawCalls;
+
 		if (s_RendererData.QuadIndexCount)
 		{
-			// VBO
-			s_RendererData.QuadVertexBuffer->SetData(s_RendererData.QuadVertexBufferBase, sizeof(QuadVertex) * s_RendererData.QuadVertexCount);
-
 			// Textures
 			for (uint32_t i = 0; i < s_RendererData.TextureSlotIndex; i++)
 			{
 				s_RendererData.TextureSlots[i]->Bind(i);
 			}
+			s_RendererData.Stats.TextureBindCount += s_RendererData.TextureSlotIndex;
 
 			// Shader
 			s_RendererData.QuadShader->Bind();
+			s_RendererData.Stats.ShaderBindCount++;
 
-			// Draw
-			RenderCommand::DrawIndexed(s_RendererData.QuadVertexArray, s_RendererData.QuadIndexCount);
+			// Draw (vertices were written straight into the mapped region)
+			RenderCommand::DrawIndexed(s_RendererData.QuadVertexArray, s_RendererData.QuadIndexCount, s_RendererData.QuadVertexBuffer->GetRegionOffset() / sizeof(QuadVertex));
+			s_RendererData.QuadVertexBuffer->FenceRegion();
 			s_RendererData.Stats.DrawCalls++;
 		}
 
 		if (s_RendererData.CircleIndexCount)
 		{
-			// VBO
-			s_RendererData.CircleVertexBuffer->SetData(s_RendererData.CircleVertexBufferBase, sizeof(CircleVertex) * s_RendererData.CircleVertexCount);
-
 			// Shader
 			s_RendererData.CircleShader->Bind();
+			s_RendererData.Stats.ShaderBindCount++;
 
 			// Draw
-			RenderCommand::DrawIndexed(s_RendererData.CircleVertexArray, s_RendererData.CircleIndexCount);
+			RenderCommand::DrawIndexed(s_RendererData.CircleVertexArray, s_RendererData.CircleIndexCount, s_RendererData.CircleVertexBuffer->GetRegionOffset() / sizeof(CircleVertex));
+			s_RendererData.CircleVertexBuffer->FenceRegion();
 			s_RendererData.Stats.DrawCalls++;
 		}
 
 		if (s_RendererData.LineIndexCount)
 		{
-			// VBO
-			s_RendererData.LineVertexBuffer->SetData(s_RendererData.LineVertexBufferBase, sizeof(SimpleVertex) * s_RendererData.LineVertexCount);
-
 			// Shader
 			s_RendererData.LineShader->Bind();
+			s_RendererData.Stats.ShaderBindCount++;
 
 			// Draw
 			RenderCommand::SetLineWidth(4.0f);
-			RenderCommand::DrawLines(s_RendererData.LineVertexArray, s_RendererData.LineIndexCount);
+			RenderCommand::DrawLines(s_RendererData.LineVertexArray, s_RendererData.LineIndexCount, s_RendererData.LineVertexBuffer->GetRegionOffset() / sizeof(SimpleVertex));
 			RenderCommand::SetLineWidth(2.0f);
+			s_RendererData.LineVertexBuffer->FenceRegion();
 			s_RendererData.Stats.DrawCalls++;
 		}
 
-		if (s_RendererData.MeshIndexCount)
+		if (s_RendererData.MeshDrawCommands.size() || s_RendererData.MeshOutlineDrawCommands.size() || s_RendererData.MeshTransparentDrawCommands.size())
+		{
+			PrepareMeshDraws();
+		}
+
+		uint32_t meshDepthPrepassIndirectDrawCount = 0;
+		for (uint32_t drawCount : s_RendererData.MeshDepthPrepassIndirectDrawCounts)
+		{
+			meshDepthPrepassIndirectDrawCount += drawCount;
+		}
+
+		uint32_t meshIndirectDrawCount = meshDepthPrepassIndirectDrawCount;
+		for (uint32_t drawCount : s_RendererData.MeshIndirectDrawCounts)
+		{
+			meshIndirectDrawCount += drawCount;
+		}
+
+		uint32_t meshOutlineIndirectDrawCount = 0;
+		for (uint32_t drawCount : s_RendererData.MeshOutlineIndirectDrawCounts)
+		{
+			meshOutlineIndirectDrawCount += drawCount;
+		}
+
+		bool areTextureArraysBound = false;
+		auto bindTextureArrays = [&areTextureArraysBound]()
+		{
+			if (areTextureArraysBound)
+			{
+				return;
+			}
+
+			for (uint32_t i = 0; i < s_RendererData.TextureArraySlotIndex; i++)
+			{
+				s_RendererData.MaterialTexturePool->GetArray(s_RendererData.TextureArraySlots[i])->Bind(i);
+			}
+			s_RendererData.Stats.TextureBindCount += s_RendererData.TextureArraySlotIndex;
+			areTextureArraysBound = true;
+		};
+
+		if (meshIndirectDrawCount)
 		{
 			RenderCommand::EnableCulling();
 			RenderCommand::SetBackCulling();
 
-			// VBO
-			s_RendererData.MeshVertexBuffer->SetData(s_RendererData.MeshVertexBufferBase, sizeof(MeshVertex) * s_RendererData.MeshVertexCount);
+			// Depth pre-pass: lays down the nearest depth so the G-Buffer pass shades (and writes) each pixel only once
+			if (meshDepthPrepassIndirectDrawCount)
+			{
+				RenderCommand::SetColorMask(false);
 
-			// IBO / EBO
-			s_RendererData.MeshIndexBuffer->SetData(s_RendererData.MeshIndexBufferBase, sizeof(uint32_t) * s_RendererData.MeshIndexCount);
+				s_RendererData.MeshDepthShader->Bind();
+				s_RendererData.Stats.ShaderBindCount++;
 
-			// Textures
-			for (uint32_t i = 0; i < s_RendererData.TextureSlotIndex; i++)
-			{
-				s_RendererData.TextureSlots[i]->Bind(i);
+				DrawMeshIndirect(s_RendererData.MeshDepthPrepassIndirectDrawCounts.data(), 0, true);
+
+				RenderCommand::SetColorMask(true);
 			}
 
+			// Textures
+			bindTextureArrays();
+
 			// Shader
 			s_RendererData.MeshShader->Bind();
+			s_RendererData.Stats.ShaderBindCount++;
 
 			// Draw
-			RenderCommand::DrawIndexed(s_RendererData.MeshVertexArray, s_RendererData.MeshIndexCount);
-			s_RendererData.Stats.DrawCalls++;
+			if (meshDepthPrepassIndirectDrawCount)
+			{
+				RenderCommand::SetDepthFunction(RendererAPI::TestFunction::Equal);
+				RenderCommand::SetDepthMask(false);
+
+				DrawMeshIndirect(s_RendererData.MeshDepthPrepassIndirectDrawCounts.data(), 0);
+
+				RenderCommand::SetDepthFunction(RendererAPI::TestFunction::LEqual);
+				RenderCommand::SetDepthMask(true);
+			}
+
+			DrawMeshIndirect(s_RendererData.MeshIndirectDrawCounts.data(), meshDepthPrepassIndirectDrawCount);
+
+			RenderCommand::DisableCulling();
+		}
+
+		if (s_RendererData.MeshTransparentDrawRuns.size())
+		{
+			RenderCommand::EnableCulling();
+			RenderCommand::SetBackCulling();
+
+			// Textures
+			bindTextureArrays();
+
+			// Shader
+			s_RendererData.MeshTransparentShader->Bind();
+			s_RendererData.Stats.ShaderBindCount++;
+
+			// Draw (one multi-draw per run, so arenas switching back and forth keep the order)
+			uint32_t firstDraw = meshIndirectDrawCount + meshOutlineIndirectDrawCount;
+			for (const MeshDrawRun& run : s_RendererData.MeshTransparentDrawRuns)
+			{
+				RenderCommand::MultiDrawIndexedIndirect(s_RendererData.MeshGeometryArenas[run.ArenaIndex]->GetVertexArray(), s_RendererData.MeshIndirectBuffer,
+					run.DrawCount, firstDraw * sizeof(DrawIndexedIndirectCommand));
+				s_RendererData.Stats.DrawCalls++;
+
+				firstDraw += run.DrawCount;
+			}
 
 			RenderCommand::DisableCulling();
 		}
 
-		if (s_RendererData.MeshOutlineIndexCount)
+		if (meshOutlineIndirectDrawCount)
 		{
 			RenderCommand::EnableCulling();
 			RenderCommand::SetFrontCulling();
 			RenderCommand::SetLineWidth(10.0f);
 			RenderCommand::SetPolygonMode(RendererAPI::PolygonMode::Line);
 
-			// VBO
-			s_RendererData.MeshOutlineVertexBuffer->SetData(s_RendererData.MeshOutlineVertexBufferBase, sizeof(SimpleVertex) * s_RendererData.MeshOutlineVertexCount);
-
-			// IBO / EBO
-			s_RendererData.MeshOutlineIndexBuffer->SetData(s_RendererData.MeshOutlineIndexBufferBase, sizeof(uint32_t) * s_RendererData.MeshOutlineIndexCount);
-
 			// Shader
 			s_RendererData.MeshOutlineShader->Bind();
+			s_RendererData.Stats.ShaderBindCount++;
 
 			// Draw
-			RenderCommand::DrawIndexed(s_RendererData.MeshOutlineVertexArray, s_RendererData.MeshOutlineIndexCount);
-			s_RendererData.Stats.DrawCalls++;
+			DrawMeshIndirect(s_RendererData.MeshOutlineIndirectDrawCounts.data(), meshIndirectDrawCount, true);
 
 			RenderCommand::SetPolygonMode(Renderer::GetPolygonMode());
 			RenderCommand::DisableCulling();
 			RenderCommand::SetLineWidth(2.0f);
 		}
+
+		if (s_RendererData.Stats.DrawCalls != drawCalls)
+		{
+			s_RendererData.Stats.FlushCount++;
+		}
+	}
+
+	void Renderer::DrawMeshIndirect(const uint32_t* drawCounts, uint32_t firstDraw, bool isPositionOnly)
+	{
+		// One multi-draw per arena (vertex format and index type), each reading its own VAO
+		for (uint32_t arena = 0; arena < s_RendererData.MeshArenaCount; arena++)
+		{
+			if (drawCounts[arena])
+			{
+				const GeometryArena& geometryArena = *s_RendererData.MeshGeometryArenas[arena];
+				RenderCommand::MultiDrawIndexedIndirect(isPositionOnly ? geometryArena.GetPositionVertexArray() : geometryArena.GetVertexArray(), s_RendererData.MeshIndirectBuffer,
+					drawCounts[arena], firstDraw * sizeof(DrawIndexedIndirectCommand));
+				s_RendererData.Stats.DrawCalls++;
+			}
+
+			firstDraw += drawCounts[arena];
+		}
+	}
+
+	void Renderer::PrepareMeshDraws()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		s_RendererData.MeshInstanceData.clear();
+		s_RendererData.MeshIndirectCommands.clear();
+
+		if (s_RendererData.ClusterCulling)
+		{
+			CullMeshClusters();
+		}
+
+		// Sort depth pre-passed objects first (their draws are issued twice), then by arena (one multi-draw each), then mesh
+		// and LOD so every mesh level becomes a single indirect draw instanced over its objects, then material so instances
+		// sharing a material are kept contiguous in the object buffer
+		using DrawCounts = std::array<uint32_t, RendererData::MeshArenaCount>;
+		auto buildIndirectCommands = [](std::vector<MeshDrawCommand>& commands, DrawCounts& drawCounts, DrawCounts& depthPrepassDrawCounts)
+		{
+			std::sort(commands.begin(), commands.end(), [](const MeshDrawCommand& a, const MeshDrawCommand& b)
+			{
+				if (a.IsDepthPrepassed != b.IsDepthPrepassed)
+				{
+					return a.IsDepthPrepassed;
+				}
+
+				if (a.ArenaIndex != b.ArenaIndex)
+				{
+					return a.ArenaIndex < b.ArenaIndex;
+				}
+
+				if (a.Mesh != b.Mesh)
+				{
+					return a.Mesh.get() < b.Mesh.get();
+				}
+
+				if (a.LOD != b.LOD)
+				{
+					return a.LOD < b.LOD;
+				}
+
+				return a.Material < b.Material;
+			});
+
+			drawCounts.fill(0);
+			depthPrepassDrawCounts.fill(0);
+			const Mesh* previousMesh = nullptr;
+			uint32_t previousLOD = 0;
+			bool wasDepthPrepassed = false;
+
+			for (const MeshDrawCommand& command : commands)
+			{
+				DrawCounts& commandDrawCounts = command.IsDepthPrepassed ? depthPrepassDrawCounts : drawCounts;
+
+				// Cluster culled objects get one draw per visible range, of their instance alone
+				if (command.IsClusterCulled)
+				{
+					if (command.ClusterRangeCount == 0)
+					{
+						continue;
+					}
+
+					GeometryArena::Allocation geometry = command.Mesh->GetGeometry();
+					for (uint32_t i = 0; i < command.ClusterRangeCount; i++)
+					{
+						const MeshClusterRange& range = s_RendererData.MeshClusterRanges[command.ClusterRangeOffset + i];
+						GeometryArena::Allocation rangeGeometry = geometry;
+						rangeGeometry.FirstIndex += range.FirstIndex;
+						rangeGeometry.IndexCount  = range.IndexCount;
+
+						AddMeshIndirectCommand(rangeGeometry);
+						s_RendererData.MeshIndirectCommands.back().InstanceCount = 1;
+					}
+
+					commandDrawCounts[command.ArenaIndex] += command.ClusterRangeCount;
+					s_RendererData.MeshInstanceData.push_back(s_RendererData.MeshObjects[command.ObjectIndex]);
+					previousMesh = nullptr;
+					continue;
+				}
+
+				if (command.Mesh.get() != previousMesh || command.LOD != previousLOD || command.IsDepthPrepassed != wasDepthPrepassed)
+				{
+					AddMeshIndirectCommand(command.Mesh->GetGeometry(command.LOD));
+					commandDrawCounts[command.ArenaIndex]++;
+					previousMesh      = command.Mesh.get();
+					previousLOD       = command.LOD;
+					wasDepthPrepassed = command.IsDepthPrepassed;
+				}
+
+				s_RendererData.MeshInstanceData.push_back(s_RendererData.MeshObjects[command.ObjectIndex]);
+				s_RendererData.MeshIndirectCommands.back().InstanceCount++;
+			}
+
+		};
+
+		// Outlines are never pre-passed, their second array stays empty
+		DrawCounts outlineDepthPrepassDrawCounts;
+		buildIndirectCommands(s_RendererData.MeshDrawCommands,        s_RendererData.MeshIndirectDrawCounts,        s_RendererData.MeshDepthPrepassIndirectDrawCounts);
+		buildIndirectCommands(s_RendererData.MeshOutlineDrawCommands, s_RendererData.MeshOutlineIndirectDrawCounts, outlineDepthPrepassDrawCounts);
+
+		// Transparent meshes keep their order: only consecutive objects of the same mesh level are instanced together
+		s_RendererData.MeshTransparentDrawRuns.clear();
+		const Mesh* previousTransparentMesh = nullptr;
+		uint32_t previousTransparentLOD = 0;
+
+		for (const MeshDrawCommand& command : s_RendererData.MeshTransparentDrawCommands)
+		{
+			if (command.Mesh.get() != previousTransparentMesh || command.LOD != previousTransparentLOD)
+			{
+				AddMeshIndirectCommand(command.Mesh->GetGeometry(command.LOD));
+
+				if (s_RendererData.MeshTransparentDrawRuns.empty() || s_RendererData.MeshTransparentDrawRuns.back().ArenaIndex != command.ArenaIndex)
+				{
+					s_RendererData.MeshTransparentDrawRuns.push_back({ command.ArenaIndex, 0 });
+				}
+
+				s_RendererData.MeshTransparentDrawRuns.back().DrawCount++;
+				previousTransparentMesh = command.Mesh.get();
+				previousTransparentLOD  = command.LOD;
+			}
+
+			s_RendererData.MeshInstanceData.push_back(s_RendererData.MeshObjects[command.ObjectIndex]);
+			s_RendererData.MeshIndirectCommands.back().InstanceCount++;
+		}
+
+		// Object data
+		EnsureMeshObjectStorageBufferCapacity(s_RendererData.MeshInstanceData.capacity());
+		s_RendererData.MeshObjectStorageBuffer->SetData(s_RendererData.MeshInstanceData.data(), sizeof(MeshObjectData) * s_RendererData.MeshInstanceData.size());
+
+		// Material data
+		EnsureMeshMaterialStorageBufferCapacity(s_RendererData.MeshMaterials.capacity());
+		s_RendererData.MeshMaterialStorageBuffer->SetData(s_RendererData.MeshMaterials.data(), sizeof(MeshMaterialData) * s_RendererData.MeshMaterials.size());
+
+		// Indirect commands
+		if (s_RendererData.MeshIndirectCommands.size() > s_RendererData.MeshIndirectBuffer->GetMaxCount())
+		{
+			s_RendererData.MeshIndirectBuffer = IndirectBuffer::Create(sizeof(DrawIndexedIndirectCommand) * s_RendererData.MeshIndirectCommands.capacity());
+		}
+		s_RendererData.MeshIndirectBuffer->SetData(s_RendererData.MeshIndirectCommands.data(), sizeof(DrawIndexedIndirectCommand) * s_RendererData.MeshIndirectCommands.size());
+
+		uint64_t uploadedBytes = sizeof(MeshObjectData)             * s_RendererData.MeshInstanceData.size()
+		                       + sizeof(MeshMaterialData)           * s_RendererData.MeshMaterials.size()
+		                       + sizeof(DrawIndexedIndirectCommand) * s_RendererData.MeshIndirectCommands.size();
+		s_RendererData.Stats.MeshUploadBytes      += uploadedBytes;
+		s_RendererData.Stats.MeshUploadBytesSaved -= uploadedBytes;
+	}
+
+	void Renderer::CullMeshClusters()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		// Every command gets room for as many ranges as it has meshlets, so jobs write to their own region only
+		s_RendererData.ClusterCullCommands.clear();
+		uint32_t rangeCount = 0;
+
+		for (uint32_t i = 0; i < s_RendererData.MeshDrawCommands.size(); i++)
+		{
+			MeshDrawCommand& command = s_RendererData.MeshDrawCommands[i];
+			uint32_t meshletCount = (uint32_t)command.Mesh->GetMeshlets().size();
+			if (command.LOD != 0 || meshletCount < RendererData::MinCulledMeshletCount)
+			{
+				continue;
+			}
+
+			command.IsClusterCulled    = true;
+			command.ClusterRangeOffset = rangeCount;
+			command.ClusterRangeCount  = 0;
+			rangeCount += meshletCount;
+			s_RendererData.ClusterCullCommands.push_back(i);
+		}
+
+		if (s_RendererData.ClusterCullCommands.empty())
+		{
+			return;
+		}
+
+		s_RendererData.MeshClusterRanges.resize(rangeCount);
+
+		std::atomic<uint32_t> clusterCount = 0;
+		std::atomic<uint32_t> frustumCulledCount = 0;
+		std::atomic<uint32_t> backfaceCulledCount = 0;
+
+		auto cull = [&](uint32_t job)
+		{
+			MeshDrawCommand& command = s_RendererData.MeshDrawCommands[s_RendererData.ClusterCullCommands[job]];
+			const std::vector<Mesh::Meshlet>& meshlets = command.Mesh->GetMeshlets();
+			const glm::mat4& model = s_RendererData.MeshObjects[command.ObjectIndex].Model;
+
+			float scale = glm::sqrt(glm::max(glm::max(
+				glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+				glm::dot(glm::vec3(model[1]), glm::vec3(model[1]))),
+				glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))));
+
+			// Cones are tested in object space. Mirroring transforms flip the winding, so those are only frustum culled.
+			bool isBackfaceCullable = glm::determinant(glm::mat3(model)) > 0.0f;
+			glm::mat4 inverseModel = glm::inverse(model);
+			glm::vec3 cameraPosition = glm::vec3(inverseModel * glm::vec4(s_RendererData.CameraBuffer.Position, 1.0f));
+			glm::vec3 cameraForward  = glm::normalize(glm::vec3(inverseModel * glm::vec4(s_RendererData.CameraForward, 0.0f)));
+
+			MeshClusterRange* ranges = &s_RendererData.MeshClusterRanges[command.ClusterRangeOffset];
+			uint32_t frustumCulled = 0;
+			uint32_t backfaceCulled = 0;
+
+			for (const Mesh::Meshlet& meshlet : meshlets)
+			{
+				BoundingSphere bounds(glm::vec3(model * glm::vec4(meshlet.Bounds.Center, 1.0f)), meshlet.Bounds.Radius * scale);
+				if (!s_RendererData.CameraFrustum.Intersects(bounds))
+				{
+					frustumCulled++;
+					continue;
+				}
+
+				if (isBackfaceCullable && meshlet.ConeCutoff < 1.0f)
+				{
+					glm::vec3 viewDirection = s_RendererData.IsCameraOrthographic ? cameraForward : glm::normalize(meshlet.ConeApex - cameraPosition);
+					if (glm::dot(viewDirection, meshlet.ConeAxis) >= meshlet.ConeCutoff)
+					{
+						backfaceCulled++;
+						continue;
+					}
+				}
+
+				// Meshlets are contiguous in the index buffer, so visible neighbours share a draw
+				if (command.ClusterRangeCount && ranges[command.ClusterRangeCount - 1].FirstIndex + ranges[command.ClusterRangeCount - 1].IndexCount == meshlet.FirstIndex)
+				{
+					ranges[command.ClusterRangeCount - 1].IndexCount += meshlet.IndexCount;
+				}
+				else
+				{
+					ranges[command.ClusterRangeCount++] = { meshlet.FirstIndex, meshlet.IndexCount };
+				}
+			}
+
+			clusterCount        += (uint32_t)meshlets.size();
+			frustumCulledCount  += frustumCulled;
+			backfaceCulledCount += backfaceCulled;
+		};
+
+		RunJobs((uint32_t)s_RendererData.ClusterCullCommands.size(), RendererData::ClusterCullChunkSize, RendererData::MinParallelClusterCullMeshes, cull);
+
+		s_RendererData.Stats.ClusterCount          += clusterCount;
+		s_RendererData.Stats.ClusterFrustumCulled  += frustumCulledCount;
+		s_RendererData.Stats.ClusterBackfaceCulled += backfaceCulledCount;
 	}
 
 	void Renderer::StartBatch()
 	{
 		s_RendererData.QuadVertexCount = 0;
 		s_RendererData.QuadIndexCount = 0;
+		s_RendererData.QuadVertexBufferRegion = (QuadVertex*)s_RendererData.QuadVertexBuffer->MapRegion();
 
 		s_RendererData.CircleVertexCount = 0;
 		s_RendererData.CircleIndexCount = 0;
+		s_RendererData.CircleVertexBufferRegion = (CircleVertex*)s_RendererData.CircleVertexBuffer->MapRegion();
 
 		s_RendererData.LineVertexCount = 0;
 		s_RendererData.LineIndexCount = 0;
+		s_RendererData.LineVertexBufferRegion = (SimpleVertex*)s_RendererData.LineVertexBuffer->MapRegion();
+
+		s_RendererData.MeshDrawCommands.clear();
+		s_RendererData.MeshIndirectDrawCounts.fill(0);
+		s_RendererData.MeshDepthPrepassIndirectDrawCounts.fill(0);
+
+		s_RendererData.MeshOutlineDrawCommands.clear();
+		s_RendererData.MeshOutlineIndirectDrawCounts.fill(0);
 
-		s_RendererData.MeshVertexCount = 0;
-		s_RendererData.MeshIndexCount  = 0;
+		s_RendererData.MeshTransparentDrawCommands.clear();
+		s_RendererData.MeshTransparentDrawRuns.clear();
 
-		s_RendererData.MeshOutlineVertexCount = 0;
-		s_RendererData.MeshOutlineIndexCount = 0;
+		s_RendererData.MeshObjects.clear();
+		s_RendererData.MeshMaterials.clear();
+		s_RendererData.MeshMaterialIndices.clear();
 
 		s_RendererData.TextureSlotIndex = 1;
+		s_RendererData.TextureSlotIndices.clear();
+		s_RendererData.TextureSlotIndices[s_RendererData.WhiteTexture->GetRendererID()] = 0;
+
+		s_RendererData.TextureArraySlotIndex = 1;
+		s_RendererData.TextureArraySlotIndices.clear();
+		s_RendererData.TextureArraySlotIndices[s_RendererData.WhiteTextureLocation.ArrayIndex] = 0;
 	}
 
 	void Renderer::NextBatch()
@@ -1005,7 +1729,7 @@ namespace Atlas
 		}
 	}
 
-	void Renderer::DrawPostProcessing(PostProcessorComponent* postProcessor)
+	void Renderer::DrawPostProcessing(const PostProcessorComponent* postProcessor)
 	{
 		if (postProcessor)
 		{
@@ -1071,12 +1795,12 @@ namespace Atlas
 
 		for (size_t i = 0; i < quadVertexCount; i++)
 		{
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].Position     = transform * s_RendererData.QuadVertexPositions[i];
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].Color        = color;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TexCoord     = textureCoords[i];
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TexIndex     = textureIndex;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TilingFactor = tilingFactor;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].EntityID     = entityID;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].Position     = transform * s_RendererData.QuadVertexPositions[i];
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].Color        = color;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TexCoord     = textureCoords[i];
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TexIndex     = textureIndex;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TilingFactor = tilingFactor;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].EntityID     = entityID;
 			s_RendererData.QuadVertexCount++;
 		}
 
@@ -1143,12 +1867,12 @@ namespace Atlas
 
 		for (size_t i = 0; i < quadVertexCount; i++)
 		{
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].Position     = transform * s_RendererData.QuadVertexPositions[i];
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].Color        = tintColor;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TexCoord     = textureCoords[i];
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TexIndex     = textureIndex;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TilingFactor = tilingFactor;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].EntityID     = entityID;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].Position     = transform * s_RendererData.QuadVertexPositions[i];
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].Color        = tintColor;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TexCoord     = textureCoords[i];
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TexIndex     = textureIndex;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TilingFactor = tilingFactor;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].EntityID     = entityID;
 			s_RendererData.QuadVertexCount++;
 		}
 
@@ -1211,12 +1935,12 @@ namespace Atlas
 
 		for (size_t i = 0; i < quadVertexCount; i++)
 		{
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].Position     = transform * s_RendererData.QuadVertexPositions[i];
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].Color        = tintColor;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TexCoord     = textureCoords[i];
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TexIndex     = textureIndex;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].TilingFactor = tilingFactor;
-			s_RendererData.QuadVertexBufferBase[s_RendererData.QuadVertexCount].EntityID     = entityID;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].Position     = transform * s_RendererData.QuadVertexPositions[i];
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].Color        = tintColor;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TexCoord     = textureCoords[i];
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TexIndex     = textureIndex;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].TilingFactor = tilingFactor;
+			s_RendererData.QuadVertexBufferRegion[s_RendererData.QuadVertexCount].EntityID     = entityID;
 			s_RendererData.QuadVertexCount++;
 		}
 
@@ -1268,12 +1992,12 @@ namespace Atlas
 
 		for (size_t i = 0; i < circleVertexCount; i++)
 		{
-			s_RendererData.CircleVertexBufferBase[s_RendererData.CircleVertexCount].WorldPosition = transform * s_RendererData.QuadVertexPositions[i];
-			s_RendererData.CircleVertexBufferBase[s_RendererData.CircleVertexCount].LocalPosition = s_RendererData.QuadVertexPositions[i] * 2.0f;
-			s_RendererData.CircleVertexBufferBase[s_RendererData.CircleVertexCount].Color         = color;
-			s_RendererData.CircleVertexBufferBase[s_RendererData.CircleVertexCount].Thickness     = thickness;
-			s_RendererData.CircleVertexBufferBase[s_RendererData.CircleVertexCount].Fade          = fade;
-			s_RendererData.CircleVertexBufferBase[s_RendererData.CircleVertexCount].EntityID      = entityID;
+			s_RendererData.CircleVertexBufferRegion[s_RendererData.CircleVertexCount].WorldPosition = transform * s_RendererData.QuadVertexPositions[i];
+			s_RendererData.CircleVertexBufferRegion[s_RendererData.CircleVertexCount].LocalPosition = s_RendererData.QuadVertexPositions[i] * 2.0f;
+			s_RendererData.CircleVertexBufferRegion[s_RendererData.CircleVertexCount].Color         = color;
+			s_RendererData.CircleVertexBufferRegion[s_RendererData.CircleVertexCount].Thickness     = thickness;
+			s_RendererData.CircleVertexBufferRegion[s_RendererData.CircleVertexCount].Fade          = fade;
+			s_RendererData.CircleVertexBufferRegion[s_RendererData.CircleVertexCount].EntityID      = entityID;
 			s_RendererData.CircleVertexCount++;
 		}
 
@@ -1297,14 +2021,14 @@ namespace Atlas
 			NextBatch();
 		}
 
-		s_RendererData.LineVertexBufferBase[s_RendererData.LineVertexCount].Position = p0;
-		s_RendererData.LineVertexBufferBase[s_RendererData.LineVertexCount].Color    = color;
-		s_RendererData.LineVertexBufferBase[s_RendererData.LineVertexCount].EntityID = entityID;
+		s_RendererData.LineVertexBufferRegion[s_RendererData.LineVertexCount].Position = p0;
+		s_RendererData.LineVertexBufferRegion[s_RendererData.LineVertexCount].Color    = color;
+		s_RendererData.LineVertexBufferRegion[s_RendererData.LineVertexCount].EntityID = entityID;
 		s_RendererData.LineVertexCount++;
 
-		s_RendererData.LineVertexBufferBase[s_RendererData.LineVertexCount].Position = p1;
-		s_RendererData.LineVertexBufferBase[s_RendererData.LineVertexCount].Color    = color;
-		s_RendererData.LineVertexBufferBase[s_RendererData.LineVertexCount].EntityID = entityID;
+		s_RendererData.LineVertexBufferRegion[s_RendererData.LineVertexCount].Position = p1;
+		s_RendererData.LineVertexBufferRegion[s_RendererData.LineVertexCount].Color    = color;
+		s_RendererData.LineVertexBufferRegion[s_RendererData.LineVertexCount].EntityID = entityID;
 		s_RendererData.LineVertexCount++;
 
 		s_RendererData.LineIndexCount += lineIndexCount;
@@ -1343,91 +2067,361 @@ namespace Atlas
 		DrawLine(lineVertices[3], lineVertices[0], color, entityID);
 	}
 
-	void Renderer::DrawMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID)
+	uint32_t Renderer::EnsureMeshMaterial(const MaterialComponent* material)
 	{
-		ATLAS_PROFILE_FUNCTION();
+		// Materials are shared by all the objects using them within a batch
+		const Material* materialKey = material == nullptr ? nullptr : material->Material.get();
+		auto materialIt = s_RendererData.MeshMaterialIndices.find(materialKey);
+		if (materialIt != s_RendererData.MeshMaterialIndices.end())
+		{
+			return materialIt->second;
+		}
 
-		const glm::mat3 normalMatrix = glm::transpose(glm::inverse(transform));
+		// Textures live in pooled arrays, missing ones resolve to the white texture (index 0)
+		std::array<TextureArrayPool::Location, RendererData::MaterialTextureCount> textureLocations;
+		textureLocations.fill(s_RendererData.WhiteTextureLocation);
 
-		uint32_t albedoTextureIndex       = material == nullptr ? 0 : EnsureTextureSlot(material->Material->GetAlbedoTexture());
-		uint32_t normalTextureIndex       = material == nullptr ? 0 : EnsureTextureSlot(material->Material->GetNormalTexture());
-		uint32_t metallicTextureIndex     = material == nullptr ? 0 : EnsureTextureSlot(material->Material->GetMetallicTexture());
-		uint32_t roughnessTextureIndex    = material == nullptr ? 0 : EnsureTextureSlot(material->Material->GetRoughnessTexture());
-		uint32_t aoTextureIndex           = material == nullptr ? 0 : EnsureTextureSlot(material->Material->GetAOTexture());
-		uint32_t displacementTextureIndex = material == nullptr ? 0 : EnsureTextureSlot(material->Material->GetDisplacementTexture());
+		if (material != nullptr)
+		{
+			const Ref<Texture2D> textures[RendererData::MaterialTextureCount] = {
+				material->Material->GetAlbedoTexture(),    material->Material->GetNormalTexture(), material->Material->GetMetallicTexture(),
+				material->Material->GetRoughnessTexture(), material->Material->GetAOTexture(),     material->Material->GetDisplacementTexture()
+			};
 
-		const std::vector<Mesh::Vertex>& vertices = mesh.Mesh->GetVertices();
-		const std::vector<uint32_t>& indices = mesh.Mesh->GetIndices();
+			for (uint32_t i = 0; i < RendererData::MaterialTextureCount; i++)
+			{
+				if (textures[i])
+				{
+					textureLocations[i] = s_RendererData.MaterialTexturePool->Get(textures[i]);
+				}
+			}
+		}
 
-		if (s_RendererData.MeshVertexCount + vertices.size() >= RendererData::MaxVertices ||
-			s_RendererData.MeshIndexCount  + indices .size() >= RendererData::MaxIndices)
+		// Slot arrays next: running out of slots flushes (and clears) the pending draw commands and materials
+		uint32_t newArrayCount = 0;
+		for (uint32_t i = 0; i < RendererData::MaterialTextureCount; i++)
 		{
-			NextBatch();
+			uint32_t arrayIndex = textureLocations[i].ArrayIndex;
+			bool isNew = s_RendererData.TextureArraySlotIndices.find(arrayIndex) == s_RendererData.TextureArraySlotIndices.end();
+			for (uint32_t j = 0; j < i && isNew; j++)
+			{
+				isNew = textureLocations[j].ArrayIndex != arrayIndex;
+			}
+
+			newArrayCount += isNew ? 1 : 0;
 		}
 
-		for (uint32_t i = 0; i < indices.size(); i++)
+		if (s_RendererData.TextureArraySlotIndex + newArrayCount > RendererData::MaxTextureSlots)
 		{
-			s_RendererData.MeshIndexBufferBase[s_RendererData.MeshIndexCount++] = s_RendererData.MeshVertexCount + indices[i];
+			s_RendererData.Stats.TextureBatchBreaks++;
+			NextBatch();
 		}
 
-		for (size_t i = 0; i < vertices.size(); i++)
+		uint32_t albedoTextureIndex       = EnsureTextureArraySlot(textureLocations[0]);
+		uint32_t normalTextureIndex       = EnsureTextureArraySlot(textureLocations[1]);
+		uint32_t metallicTextureIndex     = EnsureTextureArraySlot(textureLocations[2]);
+		uint32_t roughnessTextureIndex    = EnsureTextureArraySlot(textureLocations[3]);
+		uint32_t aoTextureIndex           = EnsureTextureArraySlot(textureLocations[4]);
+		uint32_t displacementTextureIndex = EnsureTextureArraySlot(textureLocations[5]);
+
+		uint32_t materialIndex = (uint32_t)s_RendererData.MeshMaterials.size();
+		s_RendererData.MeshMaterialIndices[materialKey] = materialIndex;
+
+		MeshMaterialData& materialData = s_RendererData.MeshMaterials.emplace_back();
+		materialData.Color                    = material == nullptr ? glm::vec4(1.0f) : glm::vec4(material->Material->GetColor(), material->Material->GetOpacity());
+		materialData.Metallic                 = material == nullptr ? 0.25f           : material->Material->GetMetallic();
+		materialData.Roughness                = material == nullptr ? 0.25f           : material->Material->GetRoughness();
+
+		materialData.AlbedoTextureIndex       = albedoTextureIndex;
+		materialData.NormalTextureIndex       = normalTextureIndex;
+		materialData.MetallicTextureIndex     = metallicTextureIndex;
+		materialData.RoughnessTextureIndex    = roughnessTextureIndex;
+		materialData.AOTextureIndex           = aoTextureIndex;
+		materialData.DisplacementTextureIndex = displacementTextureIndex;
+
+		return materialIndex;
+	}
+
+	void Renderer::DrawMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		if (!mesh.Mesh->GetGeometry().IsValid())
 		{
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Position                 = transform * glm::vec4(vertices[i].Position, 1.0f);
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].EntityID                 = entityID;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Normal                   = normalMatrix * vertices[i].Normal;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].TexCoord                 = vertices[i].TexCoords;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Tangent                  = vertices[i].Tangent;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Bitangent                = vertices[i].Bitangent;
+			return;
+		}
 
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Model                    = transform;
+		uint32_t objectIndex = ReserveMeshObject(mesh, material, entityID, lod, false);
+		FillMeshObjectTransform(s_RendererData.MeshObjects[objectIndex], transform);
+	}
 
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Color                    = material == nullptr ? glm::vec3(1.0f) : material->Material->GetColor();
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Metallic                 = material == nullptr ? 0.25f           : material->Material->GetMetallic();
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].Roughness                = material == nullptr ? 0.25f           : material->Material->GetRoughness();
+	void Renderer::DrawTransparentMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod)
+	{
+		ATLAS_PROFILE_FUNCTION();
 
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].AlbedoTextureIndex       = albedoTextureIndex;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].NormalTextureIndex       = normalTextureIndex;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].MetallicTextureIndex     = metallicTextureIndex;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].RoughnessTextureIndex    = roughnessTextureIndex;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].AOTextureIndex           = aoTextureIndex;
-			s_RendererData.MeshVertexBufferBase[s_RendererData.MeshVertexCount].DisplacementTextureIndex = displacementTextureIndex;
+		if (!mesh.Mesh->GetGeometry().IsValid())
+		{
+			return;
+		}
+
+		uint32_t objectIndex = ReserveMeshObject(mesh, material, entityID, lod, true);
+		FillMeshObjectTransform(s_RendererData.MeshObjects[objectIndex], transform);
+	}
 
-			s_RendererData.MeshVertexCount++;
+	uint32_t Renderer::ReserveMeshObject(const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod, bool isTransparent)
+	{
+		if (s_RendererData.MeshObjects.size() >= RendererData::MaxMeshInstances)
+		{
+			NextBatch();
 		}
 
+		uint32_t materialIndex = EnsureMeshMaterial(material);
+		const Material* materialKey = material == nullptr ? nullptr : material->Material.get();
+		uint32_t objectIndex = (uint32_t)s_RendererData.MeshObjects.size();
+		lod = glm::min(lod, mesh.Mesh->GetLODCount() - 1);
+
+		std::vector<MeshDrawCommand>& commands = isTransparent ? s_RendererData.MeshTransparentDrawCommands : s_RendererData.MeshDrawCommands;
+		MeshDrawCommand& command = commands.emplace_back();
+		command.Mesh             = mesh.Mesh;
+		command.LOD              = lod;
+		command.ArenaIndex       = GetMeshArenaIndex(mesh.Mesh->GetVertexFormat(), mesh.Mesh->GetIndexType());
+		command.Material         = materialKey;
+		command.ObjectIndex      = objectIndex;
+		command.IsDepthPrepassed = !isTransparent && s_RendererData.DepthPrepass && !CanMaterialDiscard(material);
+
+		MeshObjectData& objectData = s_RendererData.MeshObjects.emplace_back();
+		objectData.PositionOffset = glm::vec4(mesh.Mesh->GetPositionOffset(), mesh.Mesh->GetVertexFormat() == Mesh::VertexFormat::Compressed ? 1.0f : 0.0f);
+		objectData.PositionScale  = glm::vec4(mesh.Mesh->GetPositionScale(), 0.0f);
+		objectData.MaterialIndex  = materialIndex;
+		objectData.EntityID       = entityID;
+
 		s_RendererData.Stats.MeshCount++;
-		s_RendererData.Stats.TotalVertexCount += vertices.size();
-		s_RendererData.Stats.TotalIndexCount  += indices.size();
+		s_RendererData.Stats.LODMeshCounts[lod]++;
+		s_RendererData.Stats.TotalVertexCount += mesh.Mesh->GetVertices().size();
+		s_RendererData.Stats.TotalIndexCount  += mesh.Mesh->GetLODIndexCount(lod);
+
+		// What the per-vertex layout would have streamed: every vertex plus rebased 32-bit indices
+		s_RendererData.Stats.MeshUploadBytesSaved += (uint64_t)RendererData::PerVertexMeshDataSize * mesh.Mesh->GetVertices().size()
+		                                           + sizeof(uint32_t) * mesh.Mesh->GetIndices().size();
+
+		return objectIndex;
 	}
 
-	void Renderer::DrawMeshOutline(const glm::mat4& transform, const MeshComponent& mesh,const glm::vec4& color, int entityID)
+	void Renderer::DrawMeshOutline(const glm::mat4& transform, const MeshComponent& mesh, const glm::vec4& color, int entityID, uint32_t lod)
 	{
 		ATLAS_PROFILE_FUNCTION();
 
-		const std::vector<Mesh::Vertex>& vertices = mesh.Mesh->GetVertices();
-		const std::vector<uint32_t>& indices = mesh.Mesh->GetIndices();
+		if (!mesh.Mesh->GetGeometry().IsValid())
+		{
+			return;
+		}
 
-		if (s_RendererData.MeshOutlineVertexCount + vertices.size() >= RendererData::MaxVertices ||
-			s_RendererData.MeshOutlineIndexCount  + indices .size() >= RendererData::MaxIndices)
+		if (s_RendererData.MeshObjects.size() >= RendererData::MaxMeshInstances)
 		{
 			NextBatch();
 		}
 
-		for (uint32_t i = 0; i < indices.size(); i++)
+		MeshDrawCommand& command = s_RendererData.MeshOutlineDrawCommands.emplace_back();
+		command.Mesh        = mesh.Mesh;
+		command.LOD         = glm::min(lod, mesh.Mesh->GetLODCount() - 1);
+		command.ArenaIndex  = GetMeshArenaIndex(mesh.Mesh->GetVertexFormat(), mesh.Mesh->GetIndexType());
+		command.Material    = nullptr;
+		command.ObjectIndex = s_RendererData.MeshObjects.size();
+
+		MeshObjectData& objectData = s_RendererData.MeshObjects.emplace_back();
+		objectData.Model          = transform;
+		objectData.PositionOffset = glm::vec4(mesh.Mesh->GetPositionOffset(), 0.0f);
+		objectData.PositionScale  = glm::vec4(mesh.Mesh->GetPositionScale(), 0.0f);
+		objectData.MaterialIndex  = s_RendererData.MeshMaterials.size();
+		objectData.EntityID       = entityID;
+
+		MeshMaterialData& materialData = s_RendererData.MeshMaterials.emplace_back();
+		materialData.Color = color;
+
+		s_RendererData.Stats.SelectionCount++;
+	}
+
+	void Renderer::SubmitSprite(const glm::mat4& transform, const SpriteRendererComponent& src, int entityID)
+	{
+		float depth = glm::length(glm::vec3(transform[3]) - s_RendererData.CameraBuffer.Position);
+		s_RendererData.SceneRenderQueue.SubmitSprite(transform, src, depth, entityID);
+	}
+
+	void Renderer::SubmitMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod)
+	{
+		float depth = glm::length(glm::vec3(transform[3]) - s_RendererData.CameraBuffer.Position);
+		s_RendererData.SceneRenderQueue.SubmitMesh(transform, mesh, material, lod, depth, entityID);
+	}
+
+	void Renderer::ExecuteRenderQueue()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		RenderQueue& queue = s_RendererData.SceneRenderQueue;
+
+		// Unsorted, draws run in submission order (kept to compare the batch stats)
+		if (s_RendererData.RenderQueueSorting)
+		{
+			queue.Sort();
+		}
+
+		// Only batch state and ranges are resolved here, the draws themselves are built by BuildBatch
+		for (const RenderQueue::DrawPacket& packet : queue.GetPackets())
+		{
+			const RenderQueue::DrawCommand& command = queue.GetCommand(packet.CommandIndex);
+			if (command.Mesh)
+			{
+				QueueMeshFill(command);
+			}
+			else
+			{
+				QueueSpriteFill(command);
+			}
+		}
+
+		// The jobs point into the queue, build them before it is cleared
+		BuildBatch();
+
+		s_RendererData.Stats.QueuedDrawCount += (uint32_t)queue.GetPackets().size();
+		queue.Clear();
+	}
+
+	void Renderer::QueueSpriteFill(const RenderQueue::DrawCommand& command)
+	{
+		constexpr uint32_t spriteVertexCount = 4;
+		constexpr uint32_t spriteIndexCount  = 6;
+
+		const SpriteRendererComponent& sprite = *command.Sprite;
+
+		if (sprite.Type == SpriteRendererComponent::RenderType::Circle)
+		{
+			if (s_RendererData.CircleVertexCount + spriteVertexCount >= RendererData::MaxVertices ||
+				s_RendererData.CircleIndexCount  + spriteIndexCount  >= RendererData::MaxIndices)
+			{
+				NextBatch();
+			}
+
+			s_RendererData.CircleFillJobs.push_back({ &command, s_RendererData.CircleVertexCount });
+			s_RendererData.CircleVertexCount += spriteVertexCount;
+			s_RendererData.CircleIndexCount  += spriteIndexCount;
+
+			s_RendererData.Stats.CircleCount++;
+		}
+		else
+		{
+			if (s_RendererData.QuadVertexCount + spriteVertexCount >= RendererData::MaxVertices ||
+				s_RendererData.QuadIndexCount  + spriteIndexCount  >= RendererData::MaxIndices)
+			{
+				NextBatch();
+			}
+
+			// May start a new batch, so the range is reserved afterwards
+			uint32_t textureIndex = 0;
+			if (sprite.Texture)
+			{
+				textureIndex = EnsureTextureSlot(sprite.SubTexture ? sprite.SubTexture->GetTexture() : sprite.Texture);
+			}
+
+			s_RendererData.QuadFillJobs.push_back({ &command, s_RendererData.QuadVertexCount, textureIndex });
+			s_RendererData.QuadVertexCount += spriteVertexCount;
+			s_RendererData.QuadIndexCount  += spriteIndexCount;
+
+			s_RendererData.Stats.QuadCount++;
+		}
+
+		s_RendererData.Stats.TotalVertexCount += spriteVertexCount;
+		s_RendererData.Stats.TotalIndexCount  += spriteIndexCount;
+	}
+
+	void Renderer::QueueMeshFill(const RenderQueue::DrawCommand& command)
+	{
+		if (!command.Mesh->Mesh->GetGeometry().IsValid())
 		{
-			s_RendererData.MeshOutlineIndexBufferBase[s_RendererData.MeshOutlineIndexCount++] = s_RendererData.MeshOutlineVertexCount + indices[i];
+			return;
 		}
 
-		for (size_t i = 0; i < vertices.size(); i++)
+		uint32_t objectIndex = ReserveMeshObject(*command.Mesh, command.Material, command.EntityID, command.LOD, false);
+		s_RendererData.MeshFillJobs.push_back({ &command, objectIndex });
+	}
+
+	void Renderer::BuildBatch()
+	{
+		uint32_t quadJobCount   = (uint32_t)s_RendererData.QuadFillJobs.size();
+		uint32_t circleJobCount = (uint32_t)s_RendererData.CircleFillJobs.size();
+		uint32_t meshJobCount   = (uint32_t)s_RendererData.MeshFillJobs.size();
+		uint32_t jobCount = quadJobCount + circleJobCount + meshJobCount;
+
+		if (jobCount == 0)
 		{
-			s_RendererData.MeshOutlineVertexBufferBase[s_RendererData.MeshOutlineVertexCount].Position = transform * glm::vec4(vertices[i].Position, 1.0f);
-			s_RendererData.MeshOutlineVertexBufferBase[s_RendererData.MeshOutlineVertexCount].Color    = color;
-			s_RendererData.MeshOutlineVertexBufferBase[s_RendererData.MeshOutlineVertexCount].EntityID = entityID;
+			return;
+		}
 
-			s_RendererData.MeshOutlineVertexCount++;
+		ATLAS_PROFILE_FUNCTION();
+
+		// Ranges were reserved up front and never overlap, so jobs run in any order on any thread
+		auto fill = [&](uint32_t job)
+		{
+			if (job < quadJobCount)
+			{
+				FillQuadVertices(s_RendererData.QuadFillJobs[job]);
+			}
+			else if (job < quadJobCount + circleJobCount)
+			{
+				FillCircleVertices(s_RendererData.CircleFillJobs[job - quadJobCount]);
+			}
+			else
+			{
+				const BatchFillJob& meshJob = s_RendererData.MeshFillJobs[job - quadJobCount - circleJobCount];
+				FillMeshObjectTransform(s_RendererData.MeshObjects[meshJob.Offset], meshJob.Command->Transform);
+			}
+		};
+
+		RunJobs(jobCount, RendererData::BatchFillChunkSize, RendererData::MinParallelBatchFillJobs, fill);
+
+		s_RendererData.QuadFillJobs.clear();
+		s_RendererData.CircleFillJobs.clear();
+		s_RendererData.MeshFillJobs.clear();
+	}
+
+	void Renderer::SubmitOccluder(const glm::mat4& transform, const Ref<Mesh>& mesh)
+	{
+		const std::vector<Mesh::Vertex>& vertices = mesh->GetVertices();
+		const std::vector<uint32_t>& indices = mesh->GetIndices();
+
+		if (vertices.empty() || indices.empty())
+		{
+			return;
 		}
 
-		s_RendererData.Stats.SelectionCount++;
+		s_RendererData.SceneOcclusionCuller->AddOccluder(transform, &vertices[0].Position, sizeof(Mesh::Vertex), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size());
+		s_RendererData.Stats.OccluderCount++;
+	}
+
+	void Renderer::RasterizeOccluders()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		OcclusionCuller& culler = *s_RendererData.SceneOcclusionCuller;
+		culler.Rasterize();
+		s_RendererData.Stats.OccluderTriangleCount += culler.GetTriangleCount();
+
+		if (s_RendererData.DisplayedRenderBuffer == RenderBuffers::Occlusion)
+		{
+			// Depth is mostly close to 1 in perspective, a steep curve keeps nearby occluders distinguishable
+			const std::vector<float>& depthBuffer = culler.GetDepthBuffer();
+			for (size_t i = 0; i < depthBuffer.size(); i++)
+			{
+				uint32_t gray = depthBuffer[i] < 1.0f ? 255 - (uint32_t)(191.0f * glm::pow(depthBuffer[i], 64.0f)) : 0;
+				s_RendererData.OcclusionDebugPixels[i] = 0xff000000 | gray << 16 | gray << 8 | gray;
+			}
+
+			s_RendererData.OcclusionDebugTexture->SetData(s_RendererData.OcclusionDebugPixels.data(), (uint32_t)s_RendererData.OcclusionDebugPixels.size() * sizeof(uint32_t));
+		}
+	}
+
+	bool Renderer::IsOccluded(const AABB& bounds)
+	{
+		return !s_RendererData.SceneOcclusionCuller->IsVisible(bounds);
 	}
 
 	void Renderer::DrawSkybox(const Ref<Cubemap>& skybox)
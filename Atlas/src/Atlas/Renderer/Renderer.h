@@ -6,6 +6,11 @@
 #include "Atlas/Renderer/Cubemap.h"
 #include "Atlas/Renderer/Camera.h"
 #include "Atlas/Renderer/EditorCamera.h"
+#include "Atlas/Renderer/GeometryArena.h"
+#include "Atlas/Renderer/TextureArrayPool.h"
+#include "Atlas/Renderer/RenderQueue.h"
+
+#include "Atlas/Math/Bounds.h"
 
 #include "Atlas/Scene/Components.h"
 
@@ -34,12 +39,15 @@ namespace Atlas
 			Material     = 5,
 			BrightColors = 6,
 			SSAO         = 7,
+			Occlusion    = 8, // CPU occlusion depth buffer, brighter is nearer
 		};
 
 		static void Init();
 		static void Shutdown();
 
 		static uint32_t GetLightStorageBufferCapacity();
+		// Shared storage for all mesh geometry (one arena per vertex format and index type), nullptr once the renderer is shut down
+		static GeometryArena* GetMeshGeometryArena(Mesh::VertexFormat format, IndexType indexType);
 
 		static RendererAPI::PolygonMode GetPolygonMode();
 		static void SetPolygonMode(RendererAPI::PolygonMode polygonMode);
@@ -59,6 +67,16 @@ namespace Atlas
 		static void ToggleBloom();
 		static bool IsSSAOEnabled();
 		static void ToggleSSAO();
+		static bool IsOcclusionCullingEnabled();
+		static void ToggleOcclusionCulling();
+		static bool IsClusterCullingEnabled();
+		static void ToggleClusterCulling();
+		static bool IsDepthPrepassEnabled();
+		static void ToggleDepthPrepass();
+		static bool IsRenderQueueSortingEnabled();
+		static void ToggleRenderQueueSorting();
+		static bool IsFramePipeliningEnabled();
+		static void ToggleFramePipelining();
 		static void SetSkyboxType(Cubemap::MapType skyboxType);
 		static const Cubemap::MapType& GetSkyboxType();
 		static void SetDisplayedBuffer(RenderBuffers bufferType);
@@ -80,7 +98,7 @@ namespace Atlas
 
 		static void BeginPostProcessing();
 		static void EndPostProcessing();
-		static void DrawPostProcessing(PostProcessorComponent* postProcessor);
+		static void DrawPostProcessing(const PostProcessorComponent* postProcessor);
 
 		// Primitives
 		static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
@@ -110,8 +128,21 @@ namespace Atlas
 		static void DrawRect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, int entityID = -1);
 		static void DrawRect(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
 
-		static void DrawMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID);
-		static void DrawMeshOutline(const glm::mat4& transform, const MeshComponent& mesh, const glm::vec4& color, int entityID);
+		// The level of detail is clamped to the levels the mesh has
+		static void DrawMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod = 0);
+		// Forward lit and blended over the shaded scene, in submission order (callers sort back to front)
+		static void DrawTransparentMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod = 0);
+		static void DrawMeshOutline(const glm::mat4& transform, const MeshComponent& mesh, const glm::vec4& color, int entityID, uint32_t lod = 0);
+
+		// Render queue: draws are recorded with a sort key (depth is the distance to the camera) and executed in key order
+		static void SubmitSprite(const glm::mat4& transform, const SpriteRendererComponent& src, int entityID);
+		static void SubmitMesh(const glm::mat4& transform, const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod = 0);
+		static void ExecuteRenderQueue();
+
+		// Occlusion culling (CPU): occluders are submitted and rasterized before testing, once per scene
+		static void SubmitOccluder(const glm::mat4& transform, const Ref<Mesh>& mesh);
+		static void RasterizeOccluders();
+		static bool IsOccluded(const AABB& bounds);
 
 		static void DrawSkybox(const Ref<Cubemap>& skybox);
 		static void DrawCube();
@@ -124,10 +155,44 @@ namespace Atlas
 			uint32_t CircleCount = 0;
 			uint32_t LineCount = 0;
 			uint32_t MeshCount = 0;
+			uint32_t LODMeshCounts[Mesh::MaxLODCount] = {}; // Meshes drawn at each level of detail
+			uint32_t CulledMeshCount = 0;   // Skipped by the scene before submission
+			uint32_t OccludedMeshCount = 0; // Part of the culled meshes, hidden behind occluders
+			uint32_t OccluderCount = 0;
+			uint32_t OccluderTriangleCount = 0;
+			uint32_t ClusterCount = 0;          // Meshlets tested by cluster culling
+			uint32_t ClusterFrustumCulled = 0;
+			uint32_t ClusterBackfaceCulled = 0;
+			uint32_t CulledSpriteCount = 0; // Skipped by the scene before submission
 			uint32_t SelectionCount = 0;
 			uint32_t TotalVertexCount = 0;
 			uint32_t TotalIndexCount = 0;
+			uint64_t MeshUploadBytes = 0;      // Object, material and indirect data streamed for meshes
+			uint64_t MeshUploadBytesSaved = 0; // Compared to baking object data into every vertex
+			uint32_t TextureBatchBreaks = 0;   // Batches flushed early because the texture slots ran out
+			uint32_t FlushCount = 0;           // Flushes that drew something
+			uint32_t ShaderBindCount = 0;
+			uint32_t TextureBindCount = 0;     // Texture and texture array bindings
+			uint32_t QueuedDrawCount = 0;      // Draws that went through the render queue
+
+			// Mesh geometry arena (persistent, not reset per frame)
+			uint32_t ArenaVertexCount = 0;
+			uint32_t ArenaVertexCapacity = 0;
+			uint64_t ArenaVertexBytes = 0;
+			uint32_t ArenaIndexCount = 0;
+			uint32_t ArenaIndexCapacity = 0;
+			uint64_t ArenaIndexBytes = 0;
+			uint32_t ArenaFreeBlockCount = 0;
+			float ArenaFragmentation = 0.0f;
+
+			// Material texture arrays (persistent, not reset per frame)
+			uint32_t PooledTextureCount = 0;
+			uint32_t TextureArrayCount = 0;
+			uint64_t TextureArrayBytes = 0;
 		};
+		static void RecordCulledMeshes(uint32_t count);
+		static void RecordCulledSprites(uint32_t count);
+		static void RecordOccludedMeshes(uint32_t count);
 		static void ResetStats();
 		static Statistics GetStats();
 
@@ -141,10 +206,23 @@ namespace Atlas
 		static void SetUniformBuffers(const glm::mat4& cameraProjection, const glm::mat4& cameraView, const glm::vec3& cameraPosition);
 		static void SetStorageBuffers(const std::vector<LightData>& lights);
 		static void EnsureLightStorageBufferCapacity(uint32_t capacity);
+		static void EnsureMeshObjectStorageBufferCapacity(uint32_t capacity);
+		static void EnsureMeshMaterialStorageBufferCapacity(uint32_t capacity);
 		static uint32_t EnsureTextureSlot(const Ref<Texture2D>& texture);
+		static uint32_t EnsureTextureArraySlot(const TextureArrayPool::Location& location); // Returns (slot << 16) | layer
+		static uint32_t EnsureMeshMaterial(const MaterialComponent* material);                  // Returns the material index, may start a new batch
+		static uint32_t ReserveMeshObject(const MeshComponent& mesh, const MaterialComponent* material, int entityID, uint32_t lod, bool isTransparent); // Returns the object index, transforms are filled by the caller
+
+		// Queued draws only reserve their batch ranges, BuildBatch fills them in parallel (before flushing)
+		static void QueueSpriteFill(const RenderQueue::DrawCommand& command);
+		static void QueueMeshFill(const RenderQueue::DrawCommand& command);
+		static void BuildBatch();
 
 		static void StartBatch();
 		static void Flush();
+		static void PrepareMeshDraws();
+		static void CullMeshClusters(); // Part of PrepareMeshDraws
+		static void DrawMeshIndirect(const uint32_t* drawCounts, uint32_t firstDraw, bool isPositionOnly = false); // One count per arena
 
 		static uint32_t GetLastDrawnFramebufferID();
 		static uint32_t GetSSAOFramebufferID();
@@ -53,6 +53,9 @@ namespace Atlas
 
 		virtual void EnableDepthTest() = 0;
 		virtual void DisableDepthTest() = 0;
+		virtual void SetDepthFunction(const TestFunction& function) = 0;
+		virtual void SetDepthMask(bool isWritable) = 0;
+		virtual void SetColorMask(bool isWritable) = 0; // All channels of every draw buffer
 		virtual void SetStencilMask(const uint32_t& mask) = 0;
 		virtual void SetStencilFunction(const TestFunction& function, const int& reference, const uint32_t& mask) = 0;
 
@@ -66,8 +69,10 @@ namespace Atlas
 		virtual void ClearColor() = 0;
 		virtual void ClearDepth() = 0;
 
-		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t baseVertex = 0) = 0;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t instanceCount, uint32_t indexCount = 0) = 0;
+		virtual void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t offset = 0) = 0;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0) = 0;
 
 		virtual void BindTextureSlot(uint32_t slot, uint32_t rendererID) = 0;
 
@@ -35,4 +35,19 @@ namespace Atlas
 		ATLAS_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
+
+	Ref<Texture2DArray> Texture2DArray::Create(const TextureSpecification& specification, uint32_t layerCount)
+	{
+		switch (RenderCommand::GetAPI())
+		{
+		case RendererAPI::API::None:
+			ATLAS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+			return nullptr;
+		case RendererAPI::API::OpenGL:
+			return CreateRef<OpenGLTexture2DArray>(specification, layerCount);
+		}
+
+		ATLAS_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
 }
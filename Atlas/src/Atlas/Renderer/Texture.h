@@ -73,4 +73,18 @@ namespace Atlas
 		static Ref<Texture2D> Create(const TextureSpecification& specification);
 		static Ref<Texture2D> Create(const std::filesystem::path& path, const bool generateMips = true, const bool flipOnLoad = true);
 	};
+
+	// Layers of matching size, format and sampling, sampled through a single binding
+	class Texture2DArray : public Texture
+	{
+	public:
+		virtual uint32_t GetLayerCount() const = 0;
+
+		// The texture must match the array's size and format
+		virtual void CopyLayer(const Ref<Texture2D>& texture, uint32_t layer) = 0;
+		// Copies as many leading layers as both arrays have
+		virtual void CopyLayers(const Ref<Texture2DArray>& source) = 0;
+
+		static Ref<Texture2DArray> Create(const TextureSpecification& specification, uint32_t layerCount);
+	};
 }
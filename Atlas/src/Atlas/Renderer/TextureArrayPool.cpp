@@ -0,0 +1,184 @@
+#include "atlaspch.h"
+#include "Atlas/Renderer/TextureArrayPool.h"
+
+namespace Atlas
+{
+	namespace Utils
+	{
+		static uint32_t ImageFormatToBytesPerPixel(ImageFormat format)
+		{
+			switch (format)
+			{
+			case ImageFormat::R8:      return 1;
+
+			case ImageFormat::RG16F:   return 4;
+
+			case ImageFormat::RGB8:    return 3;
+			case ImageFormat::RGB16F:  return 6;
+			case ImageFormat::RGB32F:  return 12;
+
+			case ImageFormat::RGBA8:   return 4;
+			case ImageFormat::RGBA16F: return 8;
+			case ImageFormat::RGBA32F: return 16;
+			}
+
+			return 0;
+		}
+	}
+
+	TextureArrayPool::TextureArrayPool(uint32_t initialLayerCount, uint32_t maxLayerCount)
+		: m_InitialLayerCount(initialLayerCount), m_MaxLayerCount(maxLayerCount)
+	{
+	}
+
+	TextureArrayPool::Location TextureArrayPool::Get(const Ref<Texture2D>& texture)
+	{
+		uint32_t rendererID = texture->GetRendererID();
+
+		auto entry = m_Entries.find(rendererID);
+		if (entry != m_Entries.end())
+		{
+			if (entry->second.Texture.lock() == texture)
+			{
+				return entry->second.TextureLocation;
+			}
+
+			// The renderer ID was recycled from a deleted texture, its layer is free
+			const Location& location = entry->second.TextureLocation;
+			m_Arrays[location.ArrayIndex].LayerOwners[location.Layer] = 0;
+			m_Arrays[location.ArrayIndex].FreeLayers.push_back(location.Layer);
+			m_Entries.erase(entry);
+		}
+
+		ATLAS_PROFILE_SCOPE("TextureArrayPool::Get - Pool texture");
+
+		const TextureSpecification& specification = texture->GetSpecification();
+		uint64_t key = GetSpecificationKey(specification);
+
+		uint32_t arrayIndex = UINT32_MAX;
+		uint32_t layer      = UINT32_MAX;
+
+		auto array = m_ArrayIndices.find(key);
+		if (array != m_ArrayIndices.end())
+		{
+			arrayIndex = array->second;
+			layer      = AllocateLayer(arrayIndex);
+		}
+
+		// First texture of its kind, or the current array reached the maximum layer count
+		if (layer == UINT32_MAX)
+		{
+			arrayIndex = (uint32_t)m_Arrays.size();
+			m_ArrayIndices[key] = arrayIndex;
+
+			PooledArray& pooledArray = m_Arrays.emplace_back();
+			pooledArray.Array = Texture2DArray::Create(specification, m_InitialLayerCount);
+			pooledArray.LayerOwners.resize(m_InitialLayerCount, 0);
+
+			layer = AllocateLayer(arrayIndex);
+		}
+
+		PooledArray& pooledArray = m_Arrays[arrayIndex];
+		pooledArray.Array->CopyLayer(texture, layer);
+		pooledArray.LayerOwners[layer] = rendererID;
+
+		Entry& newEntry = m_Entries[rendererID];
+		newEntry.Texture         = texture;
+		newEntry.TextureLocation = { arrayIndex, layer };
+
+		return newEntry.TextureLocation;
+	}
+
+	uint64_t TextureArrayPool::GetMemoryUsage() const
+	{
+		uint64_t bytes = 0;
+		for (const PooledArray& pooledArray : m_Arrays)
+		{
+			const Ref<Texture2DArray>& array = pooledArray.Array;
+			bytes += (uint64_t)array->GetWidth() * array->GetHeight() * array->GetLayerCount() * Utils::ImageFormatToBytesPerPixel(array->GetSpecification().Format);
+		}
+
+		return bytes;
+	}
+
+	uint64_t TextureArrayPool::GetSpecificationKey(const TextureSpecification& specification)
+	{
+		ATLAS_CORE_ASSERT(specification.Width <= UINT16_MAX && specification.Height <= UINT16_MAX, "Texture too large to be pooled!");
+
+		// Everything a texture array shares between its layers
+		return (uint64_t)specification.Width
+			| (uint64_t)specification.Height       << 16
+			| (uint64_t)specification.Format       << 32
+			| (uint64_t)specification.MinFilter    << 40
+			| (uint64_t)specification.MagFilter    << 44
+			| (uint64_t)specification.WrapS        << 48
+			| (uint64_t)specification.WrapT        << 52
+			| (uint64_t)specification.GenerateMips << 56;
+	}
+
+	uint32_t TextureArrayPool::AllocateLayer(uint32_t arrayIndex)
+	{
+		PooledArray& pooledArray = m_Arrays[arrayIndex];
+		uint32_t layerCount = pooledArray.Array->GetLayerCount();
+
+		if (pooledArray.FreeLayers.empty() && pooledArray.NextLayer == layerCount)
+		{
+			ReleaseExpiredLayers(arrayIndex);
+		}
+
+		if (!pooledArray.FreeLayers.empty())
+		{
+			uint32_t layer = pooledArray.FreeLayers.back();
+			pooledArray.FreeLayers.pop_back();
+			return layer;
+		}
+
+		if (pooledArray.NextLayer == layerCount)
+		{
+			if (layerCount >= m_MaxLayerCount)
+			{
+				return UINT32_MAX;
+			}
+
+			Grow(arrayIndex);
+		}
+
+		return pooledArray.NextLayer++;
+	}
+
+	void TextureArrayPool::ReleaseExpiredLayers(uint32_t arrayIndex)
+	{
+		PooledArray& pooledArray = m_Arrays[arrayIndex];
+
+		for (uint32_t layer = 0; layer < pooledArray.NextLayer; layer++)
+		{
+			uint32_t owner = pooledArray.LayerOwners[layer];
+			if (owner == 0)
+			{
+				continue;
+			}
+
+			auto entry = m_Entries.find(owner);
+			if (entry != m_Entries.end() && entry->second.Texture.expired())
+			{
+				m_Entries.erase(entry);
+				pooledArray.LayerOwners[layer] = 0;
+				pooledArray.FreeLayers.push_back(layer);
+			}
+		}
+	}
+
+	void TextureArrayPool::Grow(uint32_t arrayIndex)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		PooledArray& pooledArray = m_Arrays[arrayIndex];
+		uint32_t layerCount = std::min(pooledArray.Array->GetLayerCount() * 2, m_MaxLayerCount);
+
+		Ref<Texture2DArray> array = Texture2DArray::Create(pooledArray.Array->GetSpecification(), layerCount);
+		array->CopyLayers(pooledArray.Array);
+
+		pooledArray.Array = array;
+		pooledArray.LayerOwners.resize(layerCount, 0);
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Atlas/Renderer/Texture.h"
+
+namespace Atlas
+{
+	// Copies textures into shared texture arrays, one per size, format and sampling, so a handful of bindings
+	// covers every texture in use. Pooled layers are snapshots: later changes to the source texture are not seen.
+	class TextureArrayPool
+	{
+	public:
+		struct Location
+		{
+			uint32_t ArrayIndex = 0;
+			uint32_t Layer      = 0;
+		};
+
+		TextureArrayPool(uint32_t initialLayerCount = 4, uint32_t maxLayerCount = 256);
+
+		// Pools the texture on first use, afterwards a lookup by renderer ID
+		Location Get(const Ref<Texture2D>& texture);
+
+		// Arrays are replaced when they grow, so only hold on to them for the current frame
+		const Ref<Texture2DArray>& GetArray(uint32_t arrayIndex) const { return m_Arrays[arrayIndex].Array; }
+		uint32_t GetArrayCount() const { return (uint32_t)m_Arrays.size(); }
+		uint32_t GetTextureCount() const { return (uint32_t)m_Entries.size(); }
+		uint64_t GetMemoryUsage() const;
+
+	private:
+		struct PooledArray
+		{
+			Ref<Texture2DArray> Array;
+			uint32_t NextLayer = 0;
+			std::vector<uint32_t> FreeLayers;
+			std::vector<uint32_t> LayerOwners; // Renderer ID of the texture in each layer
+		};
+
+		struct Entry
+		{
+			std::weak_ptr<Texture2D> Texture; // Renderer IDs are recycled once a texture is deleted
+			Location TextureLocation;
+		};
+
+		static uint64_t GetSpecificationKey(const TextureSpecification& specification);
+
+		uint32_t AllocateLayer(uint32_t arrayIndex);
+		void ReleaseExpiredLayers(uint32_t arrayIndex);
+		void Grow(uint32_t arrayIndex);
+
+		uint32_t m_InitialLayerCount;
+		uint32_t m_MaxLayerCount;
+
+		std::vector<PooledArray> m_Arrays;
+		std::unordered_map<uint64_t, uint32_t> m_ArrayIndices; // Specification key -> array currently filled
+		std::unordered_map<uint32_t, Entry> m_Entries;         // Texture renderer ID -> layer
+	};
+}
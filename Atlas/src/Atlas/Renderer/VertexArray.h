@@ -12,7 +12,8 @@ namespace Atlas
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
-		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) = 0;
+		// Instanced buffers advance once per instance instead of once per vertex
+		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, bool instanced = false) = 0;
 		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) = 0;
 
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const = 0;
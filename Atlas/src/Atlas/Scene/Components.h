@@ -13,6 +13,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "entt.hpp"
+
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
@@ -36,6 +38,19 @@ namespace Atlas
 			: Tag(tag) {}
 	};
 
+	// Hierarchy links, kept by Entity::SetParent: children are a doubly linked list, in the order they were parented
+	struct RelationshipComponent
+	{
+		entt::entity Parent          = entt::null;
+		entt::entity FirstChild      = entt::null;
+		entt::entity LastChild       = entt::null;
+		entt::entity PreviousSibling = entt::null;
+		entt::entity NextSibling     = entt::null;
+
+		RelationshipComponent() = default;
+		RelationshipComponent(const RelationshipComponent&) = default;
+	};
+
 	struct TransformComponent
 	{
 		glm::vec3 Translation = { 0.0f, 0.0f, 0.0f };
@@ -152,6 +167,46 @@ namespace Atlas
 			: Light(light) {}
 	};
 
+	// Runtime only: the entity's world matrix, cached by the scene along with the local transform it was built from
+	struct WorldTransformComponent
+	{
+		glm::mat4 Transform = glm::mat4(1.0f);
+		TransformComponent Local;
+		bool IsDirty = true; // Rebuilt on the next scene update or read, along with the whole subtree
+
+		WorldTransformComponent() = default;
+		WorldTransformComponent(const WorldTransformComponent&) = default;
+
+		bool IsBuiltFrom(const TransformComponent& transform) const
+		{
+			return Local.Translation == transform.Translation && Local.Rotation == transform.Rotation && Local.Scale == transform.Scale;
+		}
+	};
+
+	// Runtime only: the entity's leaf in the scene's bounds tree, never serialized (Scene::Copy copies the tree with it)
+	struct BoundsProxyComponent
+	{
+		int32_t ProxyID = -1;
+		bool IsDirty = false; // Queued for a refit on the next scene update
+
+		BoundsProxyComponent() = default;
+		BoundsProxyComponent(const BoundsProxyComponent&) = default;
+	};
+
+	// Runtime only: level of detail the entity's mesh was last drawn at, kept for hysteresis
+	struct MeshLODComponent
+	{
+		uint32_t LOD = 0;
+
+		MeshLODComponent() = default;
+		MeshLODComponent(const MeshLODComponent&) = default;
+	};
+
+	// Runtime only: tags the selected entity and its children, set by the scene at the start of each editor update
+	struct SelectedComponent
+	{
+	};
+
 	template<typename... Component>
 	struct ComponentGroup
 	{
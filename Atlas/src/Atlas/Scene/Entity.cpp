@@ -3,59 +3,90 @@
 
 namespace Atlas
 {
-	Entity::Entity(entt::entity handle, Scene* scene, Entity* parent)
+	Entity::Entity(entt::entity handle, Scene* scene)
 		: m_EntityHandle(handle), m_Scene(scene)
 	{
-		SetParent(parent);
 	}
 
-	Entity* Entity::GetParent()
+	Entity Entity::GetParent()
 	{
-		return m_Parent;
+		return { GetComponent<RelationshipComponent>().Parent, m_Scene };
 	}
 
-	void Entity::SetParent(Entity* parent)
+	Entity Entity::GetFirstChild()
 	{
-		if (m_Parent == parent)
+		return { GetComponent<RelationshipComponent>().FirstChild, m_Scene };
+	}
+
+	Entity Entity::GetNextSibling()
+	{
+		return { GetComponent<RelationshipComponent>().NextSibling, m_Scene };
+	}
+
+	void Entity::SetParent(Entity parent)
+	{
+		if (GetComponent<RelationshipComponent>().Parent == parent.GetHandle() || (parent && (parent == *this || parent.IsDescendantOf(*this))))
 		{
 			return;
 		}
 
-		if (m_Parent != nullptr)
-		{
-			m_Parent->RemoveChild(this);
-		}
+		Detach();
 
-		if (parent != nullptr)
+		if (parent)
 		{
-			parent->AddChild(this);
+			RelationshipComponent& relationship = GetComponent<RelationshipComponent>();
+			RelationshipComponent& parentRelationship = parent.GetComponent<RelationshipComponent>();
+			relationship.Parent = parent;
+			relationship.PreviousSibling = parentRelationship.LastChild;
+
+			if (parentRelationship.LastChild != entt::null)
+			{
+				m_Scene->m_Registry.get<RelationshipComponent>(parentRelationship.LastChild).NextSibling = m_EntityHandle;
+			}
+			else
+			{
+				parentRelationship.FirstChild = m_EntityHandle;
+			}
+
+			parentRelationship.LastChild = m_EntityHandle;
 		}
 
-		m_Parent = parent;
+		// The world transform of the whole subtree changed
+		m_Scene->MarkTransformDirty(*this);
 	}
 
-	const std::vector<Entity*>& Entity::GetDirectChildren()
+	bool Entity::IsDescendantOf(Entity ancestor)
 	{
-		return m_DirectChildren;
+		for (Entity parent = GetParent(); parent; parent = parent.GetParent())
+		{
+			if (parent == ancestor)
+			{
+				return true;
+			}
+		}
+
+		return false;
 	}
 
-	std::vector<Entity*> Entity::GetAllChildren()
+	std::vector<Entity> Entity::GetDirectChildren()
 	{
-		std::vector<Entity*> allChildren;
+		std::vector<Entity> children;
+		for (Entity child = GetFirstChild(); child; child = child.GetNextSibling())
+		{
+			children.push_back(child);
+		}
 
-		size_t childrenNb = m_DirectChildren.size();
+		return children;
+	}
 
-		if (childrenNb > 0)
+	std::vector<Entity> Entity::GetAllChildren()
+	{
+		// Breadth first
+		std::vector<Entity> allChildren = GetDirectChildren();
+		for (size_t i = 0; i < allChildren.size(); i++)
 		{
-			allChildren.reserve(childrenNb);
-
-			for (Entity* child : m_DirectChildren)
+			for (Entity child = allChildren[i].GetFirstChild(); child; child = child.GetNextSibling())
 			{
-				std::vector<Entity*> allChildDescendants = child->GetAllChildren();
-				if (allChildDescendants.size() > 0)
-				{
-					allChildren.insert(allChildren.end(), allChildDescendants.begin(), allChildDescendants.end());
-				}
 				allChildren.push_back(child);
 			}
 		}
@@ -63,17 +94,37 @@ namespace Atlas
 		return allChildren;
 	}
 
-	void Entity::AddChild(Entity* child)
+	void Entity::Detach()
 	{
-		m_DirectChildren.push_back(child);
-	}
+		RelationshipComponent& relationship = GetComponent<RelationshipComponent>();
+		if (relationship.Parent == entt::null)
+		{
+			return;
+		}
 
-	void Entity::RemoveChild(Entity* child)
-	{
-		auto it = std::find(m_DirectChildren.begin(), m_DirectChildren.end(), child);
+		entt::registry& registry = m_Scene->m_Registry;
+		RelationshipComponent& parentRelationship = registry.get<RelationshipComponent>(relationship.Parent);
 
-		if (it != m_DirectChildren.end()) {
-			m_DirectChildren.erase(it);
+		if (relationship.PreviousSibling != entt::null)
+		{
+			registry.get<RelationshipComponent>(relationship.PreviousSibling).NextSibling = relationship.NextSibling;
+		}
+		else
+		{
+			parentRelationship.FirstChild = relationship.NextSibling;
 		}
+
+		if (relationship.NextSibling != entt::null)
+		{
+			registry.get<RelationshipComponent>(relationship.NextSibling).PreviousSibling = relationship.PreviousSibling;
+		}
+		else
+		{
+			parentRelationship.LastChild = relationship.PreviousSibling;
+		}
+
+		relationship.Parent          = entt::null;
+		relationship.PreviousSibling = entt::null;
+		relationship.NextSibling     = entt::null;
 	}
 }
\ No newline at end of file
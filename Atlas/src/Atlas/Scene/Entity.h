@@ -8,11 +8,12 @@
 
 namespace Atlas
 {
+	// Lightweight handle, copied by value: the entity and its hierarchy (RelationshipComponent) live in the registry
 	class Entity
 	{
 	public:
 		Entity() = default;
-		Entity(entt::entity handle, Scene* scene, Entity* parent = nullptr);
+		Entity(entt::entity handle, Scene* scene);
 		Entity(const Entity& other) = default;
 
 		template<typename T, typename... Args>
@@ -20,7 +21,7 @@ namespace Atlas
 		{
 			ATLAS_CORE_ASSERT(!HasComponent<T>(), "Entity already has component!");
 			T& component = m_Scene->m_Registry.emplace<T>(m_EntityHandle, std::forward<Args>(args)...);
-			m_Scene->OnComponentAdded<T>(this, component);
+			m_Scene->OnComponentAdded<T>(*this, component);
 			return component;
 		}
 
@@ -28,7 +29,7 @@ namespace Atlas
 		T& AddOrReplaceComponent(Args&&... args)
 		{
 			T& component = m_Scene->m_Registry.emplace_or_replace<T>(m_EntityHandle, std::forward<Args>(args)...);
-			m_Scene->OnComponentAdded<T>(this, component);
+			m_Scene->OnComponentAdded<T>(*this, component);
 			return component;
 		}
 
@@ -56,7 +57,7 @@ namespace Atlas
 		{
 			ATLAS_CORE_ASSERT(HasComponent<T>(), "Entity does not have component!");
 			T& component = m_Scene->m_Registry.get<T>(m_EntityHandle);
-			m_Scene->OnComponentRemoved<T>(this, component);
+			m_Scene->OnComponentRemoved<T>(*this, component);
 			m_Scene->m_Registry.remove<T>(m_EntityHandle);
 		}
 
@@ -82,19 +83,22 @@ namespace Atlas
 			return !(*this == other);
 		}
 
-		Entity* GetParent();
-		void SetParent(Entity* parent);
-		const std::vector<Entity*>& GetDirectChildren();
-		std::vector<Entity*> GetAllChildren();
+		// Null entities when there is none
+		Entity GetParent();
+		Entity GetFirstChild();
+		Entity GetNextSibling();
+
+		// Appended after the parent's other children. Parenting an entity to itself or one of its descendants is ignored.
+		void SetParent(Entity parent);
+		bool IsDescendantOf(Entity ancestor);
+
+		std::vector<Entity> GetDirectChildren();
+		std::vector<Entity> GetAllChildren();
 
 	private:
-		void AddChild(Entity* child);
-		void RemoveChild(Entity* child);
+		void Detach();
 
 		entt::entity m_EntityHandle{ entt::null };
 		Scene* m_Scene = nullptr;
-
-		Entity* m_Parent = nullptr;
-		std::vector<Entity*> m_DirectChildren;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Atlas/Renderer/Renderer.h"
+#include "Atlas/Renderer/EditorCamera.h"
+#include "Atlas/Renderer/Cubemap.h"
+
+#include "Atlas/Math/Bounds.h"
+
+#include "Atlas/Scene/Components.h"
+
+namespace Atlas
+{
+	// What a scene update draws: view, lights and culled draw lists, copied out of the registry so the packet can be
+	// drawn while the scene goes on to the next frame. Not changed once built.
+	struct RenderPacket
+	{
+		// Opaque meshes, drawn through the render queue once the occlusion test passes
+		struct MeshDraw
+		{
+			glm::mat4 Transform;
+			AABB Bounds; // World space
+			MeshComponent Mesh;
+			MaterialComponent Material;
+			bool HasMaterial = false;
+			int EntityID = -1;
+			uint32_t LOD = 0;
+		};
+
+		// Opaque sprites, drawn through the render queue
+		struct SpriteDraw
+		{
+			glm::mat4 Transform;
+			SpriteRendererComponent Sprite;
+			int EntityID = -1;
+		};
+
+		// Entities drawn one by one (selection, transparent entities): their sprite, or else mesh, or else light
+		struct EntityDraw
+		{
+			glm::mat4 Transform;
+			glm::vec3 Scale = glm::vec3(1.0f); // Local, sizes the selection outline
+			int EntityID = -1;
+			bool IsSelected = false;
+
+			bool HasSprite = false;
+			SpriteRendererComponent Sprite;
+
+			bool HasMesh = false;
+			bool IsTransparentMesh = false;
+			MeshComponent Mesh;
+			MaterialComponent Material;
+			bool HasMaterial = false;
+			uint32_t LOD = 0;
+
+			bool HasLight = false;
+			glm::vec4 LightColor = glm::vec4(1.0f);
+		};
+
+		// Editor icon of an unselected light
+		struct LightGizmo
+		{
+			glm::mat4 Transform;
+			glm::vec4 Color;
+			int EntityID = -1;
+		};
+
+		void Clear()
+		{
+			HasView = false;
+			HasPostProcessor = false;
+			Lights.clear();
+			OpaqueMeshes.clear();
+			Sprites.clear();
+			Selection.clear();
+			OpaqueSelection.clear();
+			TransparentSelection.clear();
+			TransparentEntities.clear();
+			LightGizmos.clear();
+		}
+
+		bool IsBuilt = false;
+		bool HasView = false; // The runtime draws nothing without a primary camera
+
+		// View, from the editor camera or the primary camera
+		bool IsEditorView = false;
+		EditorCamera EditorView;
+		SceneCamera Camera;
+		TransformComponent CameraTransform;
+		glm::vec3 CameraPosition = glm::vec3(0.0f);
+		bool HasPostProcessor = false; // Off in the editor unless the editor camera enables it
+		PostProcessorComponent PostProcessor;
+		std::vector<Renderer::LightData> Lights;
+		Ref<Cubemap> Skybox;
+
+		std::vector<MeshDraw> OpaqueMeshes;
+		std::vector<SpriteDraw> Sprites;
+		std::vector<EntityDraw> Selection;            // Selected entity and its children, parents first
+		std::vector<EntityDraw> OpaqueSelection;      // Selection minus transparent meshes, drawn in the GBuffer pass
+		std::vector<EntityDraw> TransparentSelection; // Blended with the transparent entities
+		std::vector<EntityDraw> TransparentEntities;  // Back to front, selected ones included (drawn as a whole)
+		std::vector<LightGizmo> LightGizmos;
+		bool IsSelectedEntityMesh = false;
+
+		// Statistics
+		uint32_t MeshCount = 0;          // In the scene
+		uint32_t SubmittedMeshCount = 0; // Selected and transparent ones, opaque meshes are counted once occlusion tested
+		uint32_t CulledSpriteCount = 0;
+	};
+}
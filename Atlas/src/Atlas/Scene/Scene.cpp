@@ -6,36 +6,133 @@
 
 #include "Atlas/Scene/Entity.h"
 
+#include "Atlas/Core/JobSystem.h"
+
+#include "Atlas/Math/RadixSort.h"
+
 namespace Atlas
 {
-	////////////////////////////////////////////////////////////////////////////////////////
-	// DrawComponent ///////////////////////////////////////////////////////////////////////
-	////////////////////////////////////////////////////////////////////////////////////////
+	static const AABB s_SpriteBounds = AABB({ -0.5f, -0.5f, 0.0f }, { 0.5f, 0.5f, 0.0f }); // Unit quad
+
+	// Occluders: the largest meshes on screen, as long as they are cheap to rasterize
+	static const uint32_t s_MaxOccluders = 8;
+	static const uint32_t s_MaxOccluderTriangles = 4096;
+	static const float s_MinOccluderScreenSize = 0.2f; // Bounds radius over distance to the camera
+
+	// Mesh LODs: level n is used below the n-th screen size (bounding sphere diameter over viewport height),
+	// a level only switches once the size is past its threshold by the hysteresis margin
+	static const float s_LODScreenSizes[Mesh::MaxLODCount - 1] = { 0.5f, 0.25f, 0.125f };
+	static const float s_LODHysteresis = 0.1f;
+
+	// Depth first (parents before their children) along the relationship links, without allocating. The visitor
+	// returns whether to go down into the children of the entity it was given.
+	template<typename Visitor>
+	static void VisitSubtree(entt::registry& registry, entt::entity root, Visitor&& visitor)
+	{
+		entt::entity current = root;
+		while (current != entt::null)
+		{
+			entt::entity firstChild = registry.get<RelationshipComponent>(current).FirstChild;
+			if (visitor(current) && firstChild != entt::null)
+			{
+				current = firstChild;
+				continue;
+			}
 
-	template<typename T>
-	void Scene::DrawComponent(Entity* entity, const glm::mat4& transform, const T& component)
+			// Next sibling of the entity or of its closest ancestor that has one, without leaving the subtree
+			while (current != root && registry.get<RelationshipComponent>(current).NextSibling == entt::null)
+			{
+				current = registry.get<RelationshipComponent>(current).Parent;
+			}
+
+			current = current == root ? entt::null : registry.get<RelationshipComponent>(current).NextSibling;
+		}
+	}
+
+	// Transparent meshes skip the GBuffer and are blended in the forward pass
+	static bool IsTransparentMesh(entt::registry& registry, entt::entity entityHandle)
 	{
-		static_assert(sizeof(T) == 0);
+		if (!registry.all_of<MeshComponent>(entityHandle))
+		{
+			return false;
+		}
+
+		MaterialComponent* material = registry.try_get<MaterialComponent>(entityHandle);
+		return material != nullptr && material->Material && material->Material->IsTransparent();
 	}
 
-	template<>
-	void Scene::DrawComponent<SpriteRendererComponent>(Entity* entity, const glm::mat4& transform, const SpriteRendererComponent& component)
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Packet drawing //////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	static const glm::vec4 s_SelectionColor = { 0.400f, 0.733f, 0.417f, 1.0f }; // TODO: Link to palette (selection green)
+
+	static void DrawEntity(const RenderPacket::EntityDraw& entity)
 	{
-		Renderer::DrawSprite(transform, component, (int)entity->GetHandle());
+		if (entity.HasSprite)
+		{
+			Renderer::DrawSprite(entity.Transform, entity.Sprite, entity.EntityID);
+		}
+		else if (entity.HasMesh)
+		{
+			const MaterialComponent* material = entity.HasMaterial ? &entity.Material : nullptr;
+			if (entity.IsTransparentMesh)
+			{
+				Renderer::DrawTransparentMesh(entity.Transform, entity.Mesh, material, entity.EntityID, entity.LOD);
+			}
+			else
+			{
+				Renderer::DrawMesh(entity.Transform, entity.Mesh, material, entity.EntityID, entity.LOD);
+			}
+		}
+		else if (entity.HasLight)
+		{
+			Renderer::DrawCircle(entity.Transform, entity.LightColor, 0.1f, 0.0f, entity.EntityID);
+		}
 	}
 
-	template<>
-	void Scene::DrawComponent<MeshComponent>(Entity* entity, const glm::mat4& transform, const MeshComponent& component)
+	static void DrawSelectedEntity(const std::vector<RenderPacket::EntityDraw>& entities)
 	{
-		MaterialComponent* material = m_Registry.try_get<MaterialComponent>(entity->GetHandle());
+		Renderer::NextBatch();
 
-		Renderer::DrawMesh(transform, component, material, (int)entity->GetHandle());
+		for (const RenderPacket::EntityDraw& entity : entities)
+		{
+			DrawEntity(entity);
+		}
+
+		RenderCommand::SetStencilMask(0xFF);
+		Renderer::NextBatch();
+		RenderCommand::SetStencilMask(0x00);
 	}
 
-	template<>
-	void Scene::DrawComponent<LightSourceComponent>(Entity* entity, const glm::mat4& transform, const LightSourceComponent& component)
+	static void DrawSelectedEntityOutline(const std::vector<RenderPacket::EntityDraw>& entities)
 	{
-		Renderer::DrawCircle(transform, glm::vec4(component.Light->GetColor(), 1.0f), 0.1f, 0.0f, (int)entity->GetHandle());
+		Renderer::NextBatch();
+
+		for (const RenderPacket::EntityDraw& entity : entities)
+		{
+			if (entity.HasMesh)
+			{
+				// Same level as the mesh itself
+				Renderer::DrawMeshOutline(entity.Transform, entity.Mesh, s_SelectionColor, entity.EntityID, entity.LOD);
+			}
+
+			float outlineSize = 0.1f;
+			glm::mat4 transform = glm::scale(entity.Transform, glm::vec3(1.0f + outlineSize / entity.Scale.x, 1.0f + outlineSize / entity.Scale.y, 1.0f + outlineSize / entity.Scale.z));
+
+			if (entity.HasSprite)
+			{
+				Renderer::DrawQuad(transform, s_SelectionColor, entity.EntityID);
+			}
+			else if (entity.HasLight)
+			{
+				Renderer::DrawCircle(transform, s_SelectionColor, 0.1f, 0.0f, entity.EntityID);
+			}
+		}
+
+		RenderCommand::SetStencilFunction(RendererAPI::TestFunction::NotEqual, 1, 0xFF);
+		Renderer::NextBatch();
+		RenderCommand::SetStencilFunction(RendererAPI::TestFunction::Always, 1, 0xFF);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////////////
@@ -45,15 +142,23 @@ namespace Atlas
 	Scene::Scene()
 	{
 		m_Name = "Untitled Scene";
-		m_Lights.reserve(Renderer::GetLightStorageBufferCapacity());
 		m_Skybox = Cubemap::Create();
+
+		for (RenderPacket& packet : m_RenderPackets)
+		{
+			packet.Lights.reserve(Renderer::GetLightStorageBufferCapacity());
+		}
 	}
 
 	Scene::Scene(std::string name)
 		: m_Name(name)
 	{
-		m_Lights.reserve(Renderer::GetLightStorageBufferCapacity());
 		m_Skybox = Cubemap::Create();
+
+		for (RenderPacket& packet : m_RenderPackets)
+		{
+			packet.Lights.reserve(Renderer::GetLightStorageBufferCapacity());
+		}
 	}
 
 	Scene::~Scene()
@@ -61,40 +166,43 @@ namespace Atlas
 		DestroyAllEntities();
 	}
 
+	// Whole pools at once: both scenes share their entity handles, so the components are appended in the source's order
 	template<typename... Component>
-	static void CopyComponent(entt::registry& dst, entt::registry& src, const std::unordered_map<entt::entity, Entity*>& correspondanceEnttMap)
+	static void CopyComponentStorage(entt::registry& dst, entt::registry& src)
 	{
 		([&]()
 		{
-			auto view = src.view<Component>();
-			for (auto srcEntity : view)
+			auto& srcStorage = src.storage<Component>();
+			if (srcStorage.empty())
 			{
-				Entity* dstEntity = correspondanceEnttMap.at(srcEntity);
-
-				auto& srcComponent = src.get<Component>(srcEntity);
-				dst.emplace_or_replace<Component>(dstEntity->GetHandle(), srcComponent);
+				return;
 			}
+
+			const entt::sparse_set& srcEntities = srcStorage;
+			auto& dstStorage = dst.storage<Component>();
+			dstStorage.reserve(srcStorage.size());
+			dstStorage.insert(srcEntities.begin(), srcEntities.end(), srcStorage.begin());
 		}(), ...);
 	}
 
 	template<typename... Component>
-	static void CopyComponent(ComponentGroup<Component...>, entt::registry& dst, entt::registry& src, const std::unordered_map<entt::entity, Entity*>& correspondanceEnttMap)
+	static void CopyComponentStorage(ComponentGroup<Component...>, entt::registry& dst, entt::registry& src)
 	{
-		CopyComponent<Component...>(dst, src, correspondanceEnttMap);
+		CopyComponentStorage<Component...>(dst, src);
 	}
 
 	template<typename... Component>
-	static void CopyComponentIfExists(Entity* dst, Entity* src)
+	static void CopyComponentIfExists(Entity dst, Entity src)
 	{
 		([&]()
 		{
-			if (src->HasComponent<Component>())
-				dst->AddOrReplaceComponent<Component>(src->GetComponent<Component>());
+			if (src.HasComponent<Component>())
+				dst.AddOrReplaceComponent<Component>(src.GetComponent<Component>());
 		}(), ...);
 	}
 
 	template<typename... Component>
-	static void CopyComponentIfExists(ComponentGroup<Component...>, Entity* dst, Entity* src)
+	static void CopyComponentIfExists(ComponentGroup<Component...>, Entity dst, Entity src)
 	{
 		CopyComponentIfExists<Component...>(dst, src);
 	}
@@ -108,141 +216,96 @@ namespace Atlas
 
 		newScene->m_ViewportWidth = other->m_ViewportWidth;
 		newScene->m_ViewportHeight = other->m_ViewportHeight;
-		newScene->m_EntityHandleMap.reserve(other->m_EntityHandleMap.size());
-		newScene->m_EntityUUIDMap.reserve(other->m_EntityUUIDMap.size());
 
 		auto& srcSceneRegistry = other->m_Registry;
 		auto& dstSceneRegistry = newScene->m_Registry;
-		std::unordered_map<entt::entity, Entity*> correspondanceEnttMap;
-		correspondanceEnttMap.reserve(other->m_EntityHandleMap.size());
 
-		// Create entities in new scene
-		for (auto& [handle, entity] : other->m_EntityHandleMap)
-		{
-			UUID uuid = srcSceneRegistry.get<IDComponent>(handle).ID;
-			const auto& name = srcSceneRegistry.get<TagComponent>(handle).Tag;
-			Entity* newEntity = newScene->CreateEntity(uuid, name);
-			newScene->m_EntityUUIDMap[uuid] = newEntity;
-			newScene->m_EntityHandleMap[newEntity->GetHandle()] = newEntity;
-			correspondanceEnttMap[handle] = newEntity;
-		}
+		// Same handles as the source, released ones included so both scenes recycle them in the same order. Everything
+		// keyed by handle (hierarchy links, UUID map, bounds tree, primary camera) is then copied as is.
+		auto& srcEntities = srcSceneRegistry.storage<entt::entity>();
+		auto& dstEntities = dstSceneRegistry.storage<entt::entity>();
+		dstEntities.reserve(srcEntities.size());
+		dstEntities.push(srcEntities.data(), srcEntities.data() + srcEntities.size());
+		dstEntities.free_list(srcEntities.free_list());
 
-		for (auto& [handle, entity] : other->m_EntityHandleMap)
-		{
-			if (entity->GetParent() != nullptr)
-			{
-				correspondanceEnttMap[handle]->SetParent(correspondanceEnttMap[entity->GetParent()->GetHandle()]);
-			}
-		}
+		CopyComponentStorage<IDComponent, TagComponent, RelationshipComponent>(dstSceneRegistry, srcSceneRegistry);
+		CopyComponentStorage(AllComponents{}, dstSceneRegistry, srcSceneRegistry);
 
-		CopyComponent(AllComponents{}, dstSceneRegistry, srcSceneRegistry, correspondanceEnttMap);
+		// Cached state stays valid with the same handles, nothing is rebuilt
+		CopyComponentStorage<WorldTransformComponent, BoundsProxyComponent, MeshLODComponent>(dstSceneRegistry, srcSceneRegistry);
+		newScene->m_BoundsTree          = other->m_BoundsTree;
+		newScene->m_DirtyBoundsEntities = other->m_DirtyBoundsEntities;
 
-		if (other->m_PrimaryCamera)
-		{
-			newScene->m_PrimaryCamera = correspondanceEnttMap[other->m_PrimaryCamera->GetHandle()];
-		}
+		newScene->m_EntityUUIDMap = other->m_EntityUUIDMap;
+		newScene->m_PrimaryCamera = other->m_PrimaryCamera;
 
 		return newScene;
 	}
 
 	void Scene::OnRuntimeStart()
 	{
+		InvalidateRenderPackets();
 	}
 
 	void Scene::OnRuntimeStop()
 	{
+		InvalidateRenderPackets();
 	}
 
 	void Scene::OnUpdateRuntime(Timestep ts)
 	{
-		if (m_PrimaryCamera)
+		if (m_PrimaryCamera == entt::null)
 		{
-			const SceneCamera& camera = m_PrimaryCamera->GetComponent<CameraComponent>().Camera;
-			const TransformComponent& cameraTransform = m_PrimaryCamera->GetComponent<TransformComponent>();
-
-			{
-				ATLAS_PROFILE_SCOPE("Lights Prep");
-				UpdateLights();
-			}
+			// Nothing drawn, the packets are kept for when a camera is set
+			return;
+		}
 
-			{
-				ATLAS_PROFILE_SCOPE("GBuffer Pass");
-				Renderer::BeginScene(camera, cameraTransform, m_Lights);
-				DrawSceneDeferred(cameraTransform.Translation, false, nullptr);
-				Renderer::NextBatch();
-			}
+		const SceneCamera& camera = m_Registry.get<CameraComponent>(m_PrimaryCamera).Camera;
+		const TransformComponent& cameraTransform = m_Registry.get<TransformComponent>(m_PrimaryCamera);
+		Frustum frustum = Frustum(camera.GetProjection() * glm::inverse(cameraTransform.GetTransform()));
+		UpdateLODView(camera.GetProjection(), cameraTransform.Translation);
 
-			{
-				ATLAS_PROFILE_SCOPE("SSAO Pass");
-				Renderer::SSAOPass();
-			}
-
-			{
-				ATLAS_PROFILE_SCOPE("Deferred Rendering");
-				Renderer::DeferredRenderingPass(m_Skybox);
-			}
+		BuildAndDrawRenderPacket([&](RenderPacket& packet)
+		{
+			packet.HasView         = true;
+			packet.IsEditorView    = false;
+			packet.Camera          = camera;
+			packet.CameraTransform = cameraTransform;
+			packet.CameraPosition  = cameraTransform.Translation;
 
+			if (PostProcessorComponent* postProcessor = m_Registry.try_get<PostProcessorComponent>(m_PrimaryCamera))
 			{
-				ATLAS_PROFILE_SCOPE("Forward Rendering");
-				DrawSceneForward(cameraTransform.Translation, false, nullptr);
-				Renderer::EndScene();
-
-				Renderer::DrawSkybox(m_Skybox);
+				packet.HasPostProcessor = true;
+				packet.PostProcessor    = *postProcessor;
 			}
 
-			{
-				ATLAS_PROFILE_SCOPE("Post Processing");
-				Renderer::BeginPostProcessing();
-				Renderer::DrawPostProcessing(m_PrimaryCamera->TryGetComponent<PostProcessorComponent>());
-				Renderer::EndPostProcessing();
-			}
-		}
+			BuildRenderPacket(packet, frustum, false, {});
+		});
 	}
 
-	void Scene::OnUpdateEditor(Timestep ts, EditorCamera& camera, Entity* selectedEntity)
+	void Scene::OnUpdateEditor(Timestep ts, EditorCamera& camera, Entity selectedEntity)
 	{
-		{
-			ATLAS_PROFILE_SCOPE("Lights Prep");
-			UpdateLights();
-		}
+		Frustum frustum = Frustum(camera.GetViewProjection());
+		UpdateLODView(camera.GetProjection(), camera.GetPosition());
 
+		BuildAndDrawRenderPacket([&](RenderPacket& packet)
 		{
-			ATLAS_PROFILE_SCOPE("GBuffer Pass");
-			Renderer::BeginScene(camera, m_Lights);
-			DrawSceneDeferred(camera.GetPosition(), true, selectedEntity);
-			Renderer::NextBatch();
-		}
+			packet.HasView        = true;
+			packet.IsEditorView   = true;
+			packet.EditorView     = camera;
+			packet.CameraPosition = camera.GetPosition();
 
-		{
-			ATLAS_PROFILE_SCOPE("SSAO Pass");
-			Renderer::SSAOPass();
-		}
-
-		{
-			ATLAS_PROFILE_SCOPE("Deferred Rendering");
-			Renderer::DeferredRenderingPass(m_Skybox);
-		}
-
-		{
-			ATLAS_PROFILE_SCOPE("Forward Rendering");
-			DrawSceneForward(camera.GetPosition(), true, selectedEntity);
-			Renderer::EndScene();
-
-			Renderer::DrawSkybox(m_Skybox);
-		}
-
-		{
-			ATLAS_PROFILE_SCOPE("Post Processing");
-			Renderer::BeginPostProcessing();
-			if (camera.IsPostProcessEnabled())
+			if (camera.IsPostProcessEnabled() && m_PrimaryCamera != entt::null)
 			{
-				if (m_PrimaryCamera)
+				if (PostProcessorComponent* postProcessor = m_Registry.try_get<PostProcessorComponent>(m_PrimaryCamera))
 				{
-					Renderer::DrawPostProcessing(m_PrimaryCamera->TryGetComponent<PostProcessorComponent>());
+					packet.HasPostProcessor = true;
+					packet.PostProcessor    = *postProcessor;
 				}
 			}
-			Renderer::EndPostProcessing();
-		}
+
+			BuildRenderPacket(packet, frustum, true, selectedEntity);
+		});
 	}
 
 	void Scene::OnViewportResize(uint32_t width, uint32_t height)
@@ -250,6 +313,8 @@ namespace Atlas
 		m_ViewportWidth = width;
 		m_ViewportHeight = height;
 
+		InvalidateRenderPackets();
+
 		auto view = m_Registry.view<CameraComponent>();
 		for (auto entity : view)
 		{
@@ -262,32 +327,45 @@ namespace Atlas
 		}
 	}
 
-	Entity* Scene::CreateEntity(const std::string& name, Entity* parent)
+	void Scene::InvalidateRenderPackets()
+	{
+		for (RenderPacket& packet : m_RenderPackets)
+		{
+			packet.IsBuilt = false;
+		}
+	}
+
+	Entity Scene::CreateEntity(const std::string& name, entt::entity parent)
 	{
 		return CreateEntity(UUID(), name, parent);
 	}
 
-	Entity* Scene::CreateEntity(UUID uuid, const std::string& name, Entity* parent)
+	Entity Scene::CreateEntity(UUID uuid, const std::string& name, entt::entity parent)
 	{
-		Entity* entity = new Entity(m_Registry.create(), this, parent);
-		entity->AddComponent<IDComponent>(uuid);
-		entity->AddComponent<TransformComponent>();
-		auto& tag = entity->AddComponent<TagComponent>();
+		Entity entity = { m_Registry.create(), this };
+		entity.AddComponent<IDComponent>(uuid);
+		entity.AddComponent<RelationshipComponent>();
+		entity.AddComponent<TransformComponent>();
+		auto& tag = entity.AddComponent<TagComponent>();
 		tag.Tag = name.empty() ? "Entity" : name;
 
 		m_EntityUUIDMap[uuid] = entity;
-		m_EntityHandleMap[entity->GetHandle()] = entity;
+
+		if (parent != entt::null)
+		{
+			entity.SetParent({ parent, this });
+		}
 
 		return entity;
 	}
 
-	Entity* Scene::DuplicateEntity(Entity* entity, Entity* parent)
+	Entity Scene::DuplicateEntity(Entity entity, entt::entity parent)
 	{
-		std::string name = entity->GetName();
-		Entity* newEntity = CreateEntity(name, parent == nullptr ? entity->GetParent() : parent);
+		std::string name = entity.GetName();
+		Entity newEntity = CreateEntity(name, parent == entt::null ? entity.GetParent().GetHandle() : parent);
 		CopyComponentIfExists(AllComponents{}, newEntity, entity);
 
-		for (Entity* child : entity->GetDirectChildren())
+		for (Entity child : entity.GetDirectChildren())
 		{
 			DuplicateEntity(child, newEntity);
 		}
@@ -295,86 +373,175 @@ namespace Atlas
 		return newEntity;
 	}
 
-	void Scene::DestroyEntity(Entity* entity, bool isRoot)
+	void Scene::DestroyEntity(Entity entity, bool isRoot)
 	{
+		// Descendants go along with the whole subtree, only the root has to leave its parent's children
 		if (isRoot)
 		{
-			entity->SetParent(nullptr);
+			entity.SetParent({});
 		}
 
-		for (Entity* child : entity->GetDirectChildren())
+		for (Entity child : entity.GetDirectChildren())
 		{
 			DestroyEntity(child, false);
 		}
 
 		OnComponentRemoved(entity, AllComponents{});
-		m_EntityUUIDMap.erase(entity->GetUUID());
-		m_EntityHandleMap.erase(entity->GetHandle());
-		m_Registry.destroy(entity->GetHandle());
-		delete entity;
+		RemoveBoundsProxy(entity);
+		m_EntityUUIDMap.erase(entity.GetUUID());
+		m_Registry.destroy(entity.GetHandle());
 	}
 
 	void Scene::DestroyAllEntities()
 	{
-		for (auto const& [handle, entity] : m_EntityHandleMap)
+		for (auto const& [uuid, handle] : m_EntityUUIDMap)
 		{
-			OnComponentRemoved(entity, AllComponents{});
-			m_EntityUUIDMap.erase(entity->GetUUID());
-			m_Registry.destroy(handle);
-			delete entity;
+			OnComponentRemoved(Entity(handle, this), AllComponents{});
 		}
 
-		m_EntityHandleMap.clear();
+		m_EntityUUIDMap.clear();
+		m_Registry.clear();
+		m_BoundsTree.Clear();
+		m_DirtyBoundsEntities.clear();
 	}
 
-	Entity* Scene::GetEntity(UUID uuid)
+	Entity Scene::GetEntity(UUID uuid)
 	{
-		if (m_EntityUUIDMap.find(uuid) != m_EntityUUIDMap.end())
+		auto it = m_EntityUUIDMap.find(uuid);
+		if (it != m_EntityUUIDMap.end())
 		{
-			return m_EntityUUIDMap.at(uuid);
+			return { it->second, this };
 		}
 
 		return {};
 	}
 
-	Entity* Scene::GetEntity(entt::entity entityHandle)
+	Entity Scene::GetEntity(entt::entity entityHandle)
 	{
-		if (m_EntityHandleMap.find(entityHandle) != m_EntityHandleMap.end())
-		{
-			return m_EntityHandleMap.at(entityHandle);
-		}
-
-		return {};
+		return m_Registry.valid(entityHandle) ? Entity(entityHandle, this) : Entity();
 	}
 
-	Entity* Scene::GetPrimaryCamera()
+	Entity Scene::GetPrimaryCamera()
 	{
-		return m_PrimaryCamera;
+		return { m_PrimaryCamera, this };
 	}
 
-	void Scene::SetPrimaryCamera(Entity* entity)
+	void Scene::SetPrimaryCamera(Entity entity)
 	{
 		m_PrimaryCamera = entity;
 	}
 
-	std::vector<Entity*> Scene::GetCameras()
+	std::vector<Entity> Scene::GetCameras()
 	{
 		auto view = m_Registry.view<CameraComponent>();
-		std::vector<Entity*> cameras;
+		std::vector<Entity> cameras;
 		cameras.reserve(view.size());
 
 		for (auto entity : view)
 		{
-			cameras.push_back(GetEntity(entity));
+			cameras.push_back({ entity, this });
 		}
 
 		return cameras;
 	}
 
-	void Scene::UpdateLights()
+	void Scene::MarkBoundsDirty(Entity entity)
+	{
+		VisitSubtree(m_Registry, entity, [this](entt::entity entityHandle)
+		{
+			BoundsProxyComponent* proxy = m_Registry.try_get<BoundsProxyComponent>(entityHandle);
+			if (proxy != nullptr && !proxy->IsDirty)
+			{
+				proxy->IsDirty = true;
+				m_DirtyBoundsEntities.push_back(entityHandle);
+			}
+
+			return true;
+		});
+	}
+
+	std::vector<Entity> Scene::GetEntitiesInFrustum(const Frustum& frustum)
 	{
-		m_Lights.clear();
+		UpdateBoundsTree();
 
+		std::vector<Entity> entities;
+		m_BoundsTree.Query(frustum, [&](uint32_t userData)
+		{
+			Entity entity = { (entt::entity)userData, this };
+			if (frustum.Intersects(GetEntityBounds(entity)))
+			{
+				entities.push_back(entity);
+			}
+
+			return true;
+		});
+
+		return entities;
+	}
+
+	std::vector<Entity> Scene::GetEntitiesOverlapping(const AABB& box)
+	{
+		UpdateBoundsTree();
+
+		std::vector<Entity> entities;
+		m_BoundsTree.Query(box, [&](uint32_t userData)
+		{
+			Entity entity = { (entt::entity)userData, this };
+			if (box.Intersects(GetEntityBounds(entity)))
+			{
+				entities.push_back(entity);
+			}
+
+			return true;
+		});
+
+		return entities;
+	}
+
+	Entity Scene::Raycast(const Ray& ray, float maxDistance)
+	{
+		UpdateBoundsTree();
+
+		Entity closestEntity;
+		float closestDistance = maxDistance;
+		m_BoundsTree.RayCast(ray, maxDistance, [&](uint32_t userData, float distance)
+		{
+			// The tree only knows the enlarged boxes, the hit is confirmed on the exact one
+			Entity entity = { (entt::entity)userData, this };
+			float exactDistance;
+			if (ray.Intersects(GetEntityBounds(entity), exactDistance) && exactDistance < closestDistance)
+			{
+				closestEntity   = entity;
+				closestDistance = exactDistance;
+			}
+
+			return closestDistance;
+		});
+
+		return closestEntity;
+	}
+
+	void Scene::UpdateSelection(Entity selectedEntity)
+	{
+		// Retagged every update, so children parented to the selection since the last one are part of it
+		m_Registry.clear<SelectedComponent>();
+		m_SelectedEntities.clear();
+
+		if (!selectedEntity)
+		{
+			return;
+		}
+
+		VisitSubtree(m_Registry, selectedEntity, [this](entt::entity entityHandle)
+		{
+			m_Registry.emplace<SelectedComponent>(entityHandle);
+			m_SelectedEntities.push_back({ entityHandle, this });
+			return true;
+		});
+	}
+
+	void Scene::UpdateLights(std::vector<Renderer::LightData>& lights)
+	{
 		auto view = m_Registry.view<TransformComponent, LightSourceComponent>();
 		for (auto entity : view)
 		{
@@ -398,242 +565,702 @@ namespace Atlas
 			lightData.Direction        = lightDirection;
 			lightData.Intensity        = light.Light->GetIntensity();
 			lightData.CutOffs          = light.Light->GetCutOff().x >= 0 ? glm::cos(glm::radians(light.Light->GetCutOff())) : light.Light->GetCutOff();
-			m_Lights.push_back(lightData);
+			lights.push_back(lightData);
 		}
 	}
 
-	void Scene::DrawSceneDeferred(const glm::vec3& cameraPosition, bool isEditor, Entity* selectedEntity)
+	void Scene::UpdateVisibleEntities(const Frustum& frustum)
 	{
-		//std::map<float, entt::entity> transparentEntities;
-		//bool isSelectedEntityTransparent = false;
+		UpdateBoundsTree();
 
-		std::vector<Entity*> selectedEntities;
-		
-		if (selectedEntity)
+		m_VisibleEntities.clear();
+		m_BoundsTree.Query(frustum, [this](uint32_t userData)
 		{
-			selectedEntities = selectedEntity->GetAllChildren();
-			selectedEntities.push_back(selectedEntity);
-		}
+			m_VisibleEntities.push_back((entt::entity)userData);
+			return true;
+		});
+	}
+
+	void Scene::UpdateBoundsTree()
+	{
+		ATLAS_PROFILE_FUNCTION();
 
+		for (entt::entity entityHandle : m_DirtyBoundsEntities)
 		{
-			ATLAS_PROFILE_SCOPE("Deferred Rendering: Meshes");
-			auto view = m_Registry.view<TransformComponent, MeshComponent>();
-			for (auto entityHandle : view)
+			// The entity may have been destroyed, or stopped being renderable, since it was marked
+			BoundsProxyComponent* proxy = m_Registry.valid(entityHandle) ? m_Registry.try_get<BoundsProxyComponent>(entityHandle) : nullptr;
+			if (proxy == nullptr || !proxy->IsDirty)
 			{
-				Entity* entity = GetEntity(entityHandle);
+				continue;
+			}
+
+			proxy->IsDirty = false;
+			m_BoundsTree.MoveProxy(proxy->ProxyID, GetEntityBounds(GetEntity(entityHandle)));
+		}
+
+		m_DirtyBoundsEntities.clear();
+	}
+
+	void Scene::AddBoundsProxy(Entity entity)
+	{
+		if (entity.HasComponent<BoundsProxyComponent>())
+		{
+			MarkBoundsDirty(entity);
+			return;
+		}
+
+		// Also marked dirty: the transform is usually set right after the component is added
+		BoundsProxyComponent& proxy = m_Registry.emplace<BoundsProxyComponent>(entity.GetHandle());
+		proxy.ProxyID = m_BoundsTree.CreateProxy(GetEntityBounds(entity), (uint32_t)entity.GetHandle());
+		proxy.IsDirty = true;
+		m_DirtyBoundsEntities.push_back(entity.GetHandle());
+	}
+
+	void Scene::RemoveBoundsProxy(Entity entity)
+	{
+		BoundsProxyComponent* proxy = m_Registry.try_get<BoundsProxyComponent>(entity.GetHandle());
+		if (proxy == nullptr)
+		{
+			return;
+		}
+
+		m_BoundsTree.DestroyProxy(proxy->ProxyID);
+		m_Registry.remove<BoundsProxyComponent>(entity.GetHandle());
+	}
 
-				if (selectedEntity && std::find(selectedEntities.begin(), selectedEntities.end(), entity) != selectedEntities.end())
+	AABB Scene::GetEntityBounds(Entity entity)
+	{
+		const glm::mat4& transform = GetEntityTransform(entity);
+
+		if (MeshComponent* mesh = m_Registry.try_get<MeshComponent>(entity.GetHandle()))
+		{
+			return mesh->Mesh->GetBounds().Transform(transform);
+		}
+
+		return s_SpriteBounds.Transform(transform);
+	}
+
+	template<typename BuildFunction>
+	void Scene::BuildAndDrawRenderPacket(BuildFunction&& build)
+	{
+		RenderPacket& packet   = m_RenderPackets[m_RenderPacketIndex];
+		RenderPacket& previous = m_RenderPackets[1 - m_RenderPacketIndex];
+		m_RenderPacketIndex = 1 - m_RenderPacketIndex;
+
+		auto buildPacket = [&]()
+		{
+			ATLAS_PROFILE_SCOPE("Build Render Packet");
+			packet.Clear();
+			build(packet);
+			packet.IsBuilt = true;
+		};
+
+		// Drawing only reads the previous packet, so the registry is the worker's until the wait. Packets are not
+		// pipelined without workers (the build would run inline first anyway) or before one has been built.
+		if (Renderer::IsFramePipeliningEnabled() && JobSystem::GetWorkerCount() > 0 && previous.IsBuilt)
+		{
+			JobCounter counter;
+			JobSystem::Execute(buildPacket, &counter);
+			DrawRenderPacket(previous);
+
+			ATLAS_PROFILE_SCOPE("Wait Render Packet");
+			JobSystem::Wait(counter);
+		}
+		else
+		{
+			buildPacket();
+			DrawRenderPacket(packet);
+		}
+	}
+
+	void Scene::BuildRenderPacket(RenderPacket& packet, const Frustum& frustum, bool isEditor, Entity selectedEntity)
+	{
+		packet.Skybox = m_Skybox;
+
+		{
+			ATLAS_PROFILE_SCOPE("Transforms");
+			UpdateWorldTransforms();
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("Lights Prep");
+			UpdateLights(packet.Lights);
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("Visibility");
+
+			if (isEditor)
+			{
+				// Editor panels and gizmos only ever edit the selected entity
+				if (selectedEntity)
 				{
-					continue;
+					MarkBoundsDirty(selectedEntity);
 				}
 
-				auto [transform, mesh] = view.get<TransformComponent, MeshComponent>(entityHandle);
+				UpdateSelection(selectedEntity);
+			}
+
+			UpdateVisibleEntities(frustum);
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("Draw Lists");
+			BuildDrawLists(packet, frustum, isEditor);
+		}
+	}
+
+	void Scene::BuildDrawLists(RenderPacket& packet, const Frustum& frustum, bool isEditor)
+	{
+		// Selected meshes are always drawn, along with their outline
+		auto selectedMeshes = m_Registry.view<SelectedComponent, MeshComponent>();
+		packet.SubmittedMeshCount = (uint32_t)std::distance(selectedMeshes.begin(), selectedMeshes.end());
+		packet.MeshCount          = (uint32_t)m_Registry.view<MeshComponent>().size();
+
+		// Back to front: inverted depth keys, the stable sort keeps submission order between equal depths
+		m_TransparentEntities.clear();
+		auto addTransparentEntity = [&](entt::entity entityHandle, const glm::mat4& transform)
+		{
+			m_TransparentEntities.push_back({ ~GetSortableFloatKey(frustum.GetDepth(glm::vec3(transform[3]))), entityHandle });
+		};
+
+		for (entt::entity entityHandle : m_VisibleEntities)
+		{
+			MeshComponent* mesh = m_Registry.try_get<MeshComponent>(entityHandle);
+			if (mesh == nullptr || IsTransparentMesh(m_Registry, entityHandle) || m_Registry.all_of<SelectedComponent>(entityHandle))
+			{
+				continue;
+			}
 
-				DrawComponent<MeshComponent>(entity, GetEntityTransform(entity), mesh);
+			// The tree holds enlarged boxes, the exact one may still be outside
+			const glm::mat4& entityTransform = GetEntityTransform({ entityHandle, this });
+			AABB bounds = mesh->Mesh->GetBounds().Transform(entityTransform);
+			if (!frustum.Intersects(bounds))
+			{
+				continue;
+			}
+
+			RenderPacket::MeshDraw& meshDraw = packet.OpaqueMeshes.emplace_back();
+			meshDraw.Transform = entityTransform;
+			meshDraw.Bounds    = bounds;
+			meshDraw.Mesh      = *mesh;
+			meshDraw.EntityID  = (int)entityHandle;
+			meshDraw.LOD       = SelectMeshLOD(entityHandle, *mesh, entityTransform);
+
+			if (MaterialComponent* material = m_Registry.try_get<MaterialComponent>(entityHandle))
+			{
+				meshDraw.Material    = *material;
+				meshDraw.HasMaterial = true;
 			}
 		}
 
+		uint32_t submittedSpriteCount = 0;
+
+		// Selected sprites are always drawn, along with their outline
+		auto selectedSprites = m_Registry.view<SelectedComponent, SpriteRendererComponent>();
+		for (auto entityHandle : selectedSprites)
 		{
-			ATLAS_PROFILE_SCOPE("Deferred Rendering: Selected Meshes");
-			//if (selectedEntity && !isSelectedEntityTransparent)
-			if (selectedEntity)
+			submittedSpriteCount++;
+
+			if (selectedSprites.get<SpriteRendererComponent>(entityHandle).Color.a < 1.0f)
+			{
+				RenderPacket::EntityDraw entityDraw = GetEntityDraw(entityHandle);
+				addTransparentEntity(entityHandle, entityDraw.Transform);
+				packet.TransparentSelection.push_back(entityDraw);
+			}
+		}
+
+		for (entt::entity entityHandle : m_VisibleEntities)
+		{
+			SpriteRendererComponent* sprite = m_Registry.try_get<SpriteRendererComponent>(entityHandle);
+			if (sprite == nullptr || m_Registry.all_of<SelectedComponent>(entityHandle))
+			{
+				continue;
+			}
+
+			// The tree holds enlarged boxes, the exact one may still be outside
+			const glm::mat4& entityTransform = GetEntityTransform({ entityHandle, this });
+			if (!frustum.Intersects(s_SpriteBounds.Transform(entityTransform)))
+			{
+				continue;
+			}
+
+			submittedSpriteCount++;
+
+			if (sprite->Color.a < 1.0f)
+			{
+				addTransparentEntity(entityHandle, entityTransform);
+			}
+			else
+			{
+				packet.Sprites.push_back({ entityTransform, *sprite, (int)entityHandle });
+			}
+		}
+
+		packet.CulledSpriteCount = (uint32_t)m_Registry.view<SpriteRendererComponent>().size() - submittedSpriteCount;
+
+		for (auto entityHandle : selectedMeshes)
+		{
+			if (IsTransparentMesh(m_Registry, entityHandle))
+			{
+				RenderPacket::EntityDraw entityDraw = GetEntityDraw(entityHandle);
+				addTransparentEntity(entityHandle, entityDraw.Transform);
+				packet.TransparentSelection.push_back(entityDraw);
+			}
+		}
+
+		for (entt::entity entityHandle : m_VisibleEntities)
+		{
+			if (!IsTransparentMesh(m_Registry, entityHandle) || m_Registry.all_of<SelectedComponent>(entityHandle))
+			{
+				continue;
+			}
+
+			// The tree holds enlarged boxes, the exact one may still be outside
+			const glm::mat4& entityTransform = GetEntityTransform({ entityHandle, this });
+			if (!frustum.Intersects(m_Registry.get<MeshComponent>(entityHandle).Mesh->GetBounds().Transform(entityTransform)))
+			{
+				continue;
+			}
+
+			addTransparentEntity(entityHandle, entityTransform);
+			packet.SubmittedMeshCount++;
+		}
+
+		if (isEditor)
+		{
+			auto view = m_Registry.view<TransformComponent, LightSourceComponent>(entt::exclude<SelectedComponent>);
+			for (auto entityHandle : view)
 			{
-				DrawSelectedEntity(selectedEntities);
+				const LightSourceComponent& light = view.get<LightSourceComponent>(entityHandle);
+				packet.LightGizmos.push_back({ GetEntityTransform({ entityHandle, this }), glm::vec4(light.Light->GetColor(), 1.0f), (int)entityHandle });
 			}
 		}
 
-		//if (transparentEntities.size())
-		//{
-		//	Renderer::NextBatch();
+		RadixSort(m_TransparentEntities, m_TransparentSortScratch, [](const TransparentEntity& transparentEntity) { return transparentEntity.DepthKey; });
 
-		//	for (std::map<float, entt::entity>::reverse_iterator it = transparentEntities.rbegin(); it != transparentEntities.rend(); ++it)
-		//	{
-		//		if (isSelectedEntityTransparent && it->second == *selectedEntity)
-		//		{
-		//			DrawSelectedEntityAndOutline(selectedEntity);
-		//		}
-		//		else
-		//		{
-		//			DrawEntity(GetEntity(it->second));
-		//		}
-		//	}
-		//}
+		// The selection is drawn as a whole from its own lists, its entries here only mark its depth
+		for (const TransparentEntity& transparentEntity : m_TransparentEntities)
+		{
+			if (m_Registry.all_of<SelectedComponent>(transparentEntity.Handle))
+			{
+				RenderPacket::EntityDraw& entityDraw = packet.TransparentEntities.emplace_back();
+				entityDraw.EntityID   = (int)transparentEntity.Handle;
+				entityDraw.IsSelected = true;
+			}
+			else
+			{
+				packet.TransparentEntities.push_back(GetEntityDraw(transparentEntity.Handle));
+			}
+		}
+
+		for (Entity entity : m_SelectedEntities)
+		{
+			RenderPacket::EntityDraw entityDraw = GetEntityDraw(entity.GetHandle());
+			if (!entityDraw.IsTransparentMesh)
+			{
+				packet.OpaqueSelection.push_back(entityDraw);
+			}
+
+			packet.Selection.push_back(entityDraw);
+		}
+
+		packet.IsSelectedEntityMesh = !m_SelectedEntities.empty() && m_SelectedEntities.front().HasComponent<MeshComponent>();
 	}
 
-	void Scene::DrawSceneForward(const glm::vec3& cameraPosition, bool isEditor, Entity* selectedEntity)
+	RenderPacket::EntityDraw Scene::GetEntityDraw(entt::entity entityHandle)
 	{
-		std::map<float, entt::entity> transparentEntities;
-		bool isSelectedEntityTransparent = false;
-
-		std::vector<Entity*> selectedEntities;
+		RenderPacket::EntityDraw entityDraw;
+		entityDraw.Transform  = GetEntityTransform({ entityHandle, this });
+		entityDraw.Scale      = m_Registry.get<TransformComponent>(entityHandle).Scale;
+		entityDraw.EntityID   = (int)entityHandle;
+		entityDraw.IsSelected = m_Registry.all_of<SelectedComponent>(entityHandle);
 
-		if (selectedEntity)
+		if (SpriteRendererComponent* sprite = m_Registry.try_get<SpriteRendererComponent>(entityHandle))
 		{
-			selectedEntities = selectedEntity->GetAllChildren();
-			selectedEntities.push_back(selectedEntity);
+			entityDraw.HasSprite = true;
+			entityDraw.Sprite    = *sprite;
 		}
 
+		if (MeshComponent* mesh = m_Registry.try_get<MeshComponent>(entityHandle))
 		{
-			ATLAS_PROFILE_SCOPE("Forward Rendering: Sprites");
-			auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-			for (auto entityHandle : group)
+			entityDraw.HasMesh           = true;
+			entityDraw.IsTransparentMesh = IsTransparentMesh(m_Registry, entityHandle);
+			entityDraw.Mesh              = *mesh;
+			entityDraw.LOD               = SelectMeshLOD(entityHandle, *mesh, entityDraw.Transform);
+
+			if (MaterialComponent* material = m_Registry.try_get<MaterialComponent>(entityHandle))
 			{
-				Entity* entity = GetEntity(entityHandle);
-				auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entityHandle);
+				entityDraw.HasMaterial = true;
+				entityDraw.Material    = *material;
+			}
+		}
 
-				if (sprite.Color.a < 1.0f)
-				{
-					transparentEntities[glm::length(cameraPosition - transform.Translation)] = entityHandle;
+		if (LightSourceComponent* light = m_Registry.try_get<LightSourceComponent>(entityHandle))
+		{
+			entityDraw.HasLight   = true;
+			entityDraw.LightColor = glm::vec4(light->Light->GetColor(), 1.0f);
+		}
 
-					if (selectedEntity != nullptr && std::find(selectedEntities.begin(), selectedEntities.end(), entity) != selectedEntities.end())
-					{
-						isSelectedEntityTransparent = true;
-					}
-				}
-				else
-				{
-					if (selectedEntity != nullptr && std::find(selectedEntities.begin(), selectedEntities.end(), entity) != selectedEntities.end())
-					{
-						continue;
-					}
+		return entityDraw;
+	}
 
-					DrawComponent<SpriteRendererComponent>(entity, GetEntityTransform(entity), sprite);
-				}
+	void Scene::DrawRenderPacket(const RenderPacket& packet)
+	{
+		if (!packet.HasView)
+		{
+			return;
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("GBuffer Pass");
+			if (packet.IsEditorView)
+			{
+				Renderer::BeginScene(packet.EditorView, packet.Lights);
 			}
+			else
+			{
+				Renderer::BeginScene(packet.Camera, packet.CameraTransform, packet.Lights);
+			}
+
+			uint32_t drawnMeshCount = DrawPacketDeferred(packet);
+			Renderer::RecordCulledMeshes(packet.MeshCount - packet.SubmittedMeshCount - drawnMeshCount);
+			Renderer::NextBatch();
 		}
 
-		if (isEditor)
 		{
-			ATLAS_PROFILE_SCOPE("Forward Rendering: Editor Elements");
-			auto view = m_Registry.view<TransformComponent, LightSourceComponent>();
-			for (auto entityHandle : view)
+			ATLAS_PROFILE_SCOPE("SSAO Pass");
+			Renderer::SSAOPass();
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("Deferred Rendering");
+			Renderer::DeferredRenderingPass(packet.Skybox);
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("Forward Rendering");
+			DrawPacketForward(packet);
+			Renderer::EndScene();
+
+			Renderer::DrawSkybox(packet.Skybox);
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("Post Processing");
+			Renderer::BeginPostProcessing();
+			Renderer::DrawPostProcessing(packet.HasPostProcessor ? &packet.PostProcessor : nullptr);
+			Renderer::EndPostProcessing();
+		}
+	}
+
+	uint32_t Scene::DrawPacketDeferred(const RenderPacket& packet)
+	{
+		uint32_t drawnMeshCount = 0;
+
+		{
+			ATLAS_PROFILE_SCOPE("Deferred Rendering: Meshes");
+
+			m_OccluderFlags.assign(packet.OpaqueMeshes.size(), 0);
+
+			bool isOcclusionCullingEnabled = Renderer::IsOcclusionCullingEnabled();
+			if (isOcclusionCullingEnabled)
 			{
-				Entity* entity = GetEntity(entityHandle);
+				SubmitOccluders(packet);
+			}
 
-				if (selectedEntity != nullptr && std::find(selectedEntities.begin(), selectedEntities.end(), entity) != selectedEntities.end())
+			uint32_t occludedMeshCount = 0;
+			for (uint32_t i = 0; i < (uint32_t)packet.OpaqueMeshes.size(); i++)
+			{
+				const RenderPacket::MeshDraw& meshDraw = packet.OpaqueMeshes[i];
+				if (isOcclusionCullingEnabled && !m_OccluderFlags[i] && Renderer::IsOccluded(meshDraw.Bounds))
 				{
+					occludedMeshCount++;
 					continue;
 				}
 
-				auto [transform, light] = view.get<TransformComponent, LightSourceComponent>(entityHandle);
-				DrawComponent<LightSourceComponent>(entity, GetEntityTransform(entity), light);
+				Renderer::SubmitMesh(meshDraw.Transform, meshDraw.Mesh, meshDraw.HasMaterial ? &meshDraw.Material : nullptr, meshDraw.EntityID, meshDraw.LOD);
+				drawnMeshCount++;
+			}
+
+			Renderer::ExecuteRenderQueue();
+
+			Renderer::RecordOccludedMeshes(occludedMeshCount);
+		}
+
+		{
+			ATLAS_PROFILE_SCOPE("Deferred Rendering: Selected Meshes");
+			if (!packet.Selection.empty())
+			{
+				// Selected transparent meshes are blended in the forward pass
+				DrawSelectedEntity(packet.OpaqueSelection);
+			}
+		}
+
+		return drawnMeshCount;
+	}
+
+	void Scene::DrawPacketForward(const RenderPacket& packet)
+	{
+		{
+			ATLAS_PROFILE_SCOPE("Forward Rendering: Sprites");
+
+			for (const RenderPacket::SpriteDraw& spriteDraw : packet.Sprites)
+			{
+				Renderer::SubmitSprite(spriteDraw.Transform, spriteDraw.Sprite, spriteDraw.EntityID);
 			}
+
+			Renderer::ExecuteRenderQueue();
+
+			Renderer::RecordCulledSprites(packet.CulledSpriteCount);
 		}
 
-		if (selectedEntity && !isSelectedEntityTransparent)
+		if (packet.IsEditorView)
+		{
+			ATLAS_PROFILE_SCOPE("Forward Rendering: Editor Elements");
+			for (const RenderPacket::LightGizmo& lightGizmo : packet.LightGizmos)
+			{
+				Renderer::DrawCircle(lightGizmo.Transform, lightGizmo.Color, 0.1f, 0.0f, lightGizmo.EntityID);
+			}
+		}
+
+		bool isSelectedEntityTransparent = !packet.TransparentSelection.empty();
+
+		if (!packet.Selection.empty() && !isSelectedEntityTransparent)
 		{
-			if (selectedEntity->TryGetComponent<MeshComponent>() == nullptr)
+			if (!packet.IsSelectedEntityMesh)
 			{
 				ATLAS_PROFILE_SCOPE("Forward Rendering: Selected Sprites & Editor Elements");
-				DrawSelectedEntity(selectedEntities);
+				DrawSelectedEntity(packet.Selection);
 			}
 
 			{
 				ATLAS_PROFILE_SCOPE("Forward Rendering: Selected Entities Outlines");
-				DrawSelectedEntityOutline(selectedEntities);
+				DrawSelectedEntityOutline(packet.Selection);
 			}
 		}
 
-		if (transparentEntities.size())
+		if (!packet.TransparentEntities.empty())
 		{
-			ATLAS_PROFILE_SCOPE("Forward Rendering: Transparent Sprites");
+			ATLAS_PROFILE_SCOPE("Forward Rendering: Transparent Entities");
 
 			Renderer::NextBatch();
 
-			for (std::map<float, entt::entity>::reverse_iterator it = transparentEntities.rbegin(); it != transparentEntities.rend(); ++it)
+			// The selection is drawn as a whole, at the depth of its farthest transparent entity
+			bool isSelectionDrawn = false;
+
+			// A batch draws its sprites before its meshes, so each run of sprites or meshes gets its own batch to keep
+			// the depth order between them
+			bool isBatchEmpty = true;
+			bool isMeshBatch = false;
+			for (const RenderPacket::EntityDraw& entityDraw : packet.TransparentEntities)
 			{
-				if (isSelectedEntityTransparent && it->second == *selectedEntity)
+				if (entityDraw.IsSelected)
 				{
-					if (selectedEntity->TryGetComponent<MeshComponent>() == nullptr)
+					if (isSelectionDrawn)
 					{
-						DrawSelectedEntity(selectedEntities);
+						continue;
 					}
 
-					DrawSelectedEntityOutline(selectedEntities);
+					// Flushes the entities before it and ends its own batch
+					DrawSelectedEntity(packet.IsSelectedEntityMesh ? packet.TransparentSelection : packet.Selection);
+					DrawSelectedEntityOutline(packet.Selection);
+					isSelectionDrawn = true;
+					isBatchEmpty = true;
 				}
 				else
 				{
-					DrawEntity(GetEntity(it->second));
+					bool isMesh = !entityDraw.HasSprite && entityDraw.HasMesh;
+					if (!isBatchEmpty && isMesh != isMeshBatch)
+					{
+						Renderer::NextBatch();
+					}
+
+					DrawEntity(entityDraw);
+					isBatchEmpty = false;
+					isMeshBatch = isMesh;
 				}
 			}
 		}
 	}
 
-	void Scene::DrawEntity(Entity* entity)
+	void Scene::SubmitOccluders(const RenderPacket& packet)
 	{
-		glm::mat4 transform = GetEntityTransform(entity);
+		ATLAS_PROFILE_FUNCTION();
 
-		if (entity->HasComponent<SpriteRendererComponent>())
-		{
-			DrawComponent<SpriteRendererComponent>(entity, transform, m_Registry.get<SpriteRendererComponent>(entity->GetHandle()));
-		}
-		else if (entity->HasComponent<MeshComponent>())
+		std::vector<std::pair<float, uint32_t>> candidates; // Screen size, opaque mesh index
+		for (uint32_t i = 0; i < (uint32_t)packet.OpaqueMeshes.size(); i++)
 		{
-			DrawComponent<MeshComponent>(entity, transform, m_Registry.get<MeshComponent>(entity->GetHandle()));
+			const RenderPacket::MeshDraw& meshDraw = packet.OpaqueMeshes[i];
+			if (meshDraw.Mesh.Mesh->GetIndices().size() / 3 > s_MaxOccluderTriangles)
+			{
+				continue;
+			}
+
+			float radius   = glm::length(meshDraw.Bounds.GetExtents());
+			float distance = glm::max(glm::length(meshDraw.Bounds.GetCenter() - packet.CameraPosition), 0.001f);
+			float screenSize = radius / distance;
+
+			if (screenSize >= s_MinOccluderScreenSize)
+			{
+				candidates.push_back({ screenSize, i });
+			}
 		}
-		else if (entity->HasComponent<LightSourceComponent>())
+
+		uint32_t occluderCount = std::min((uint32_t)candidates.size(), s_MaxOccluders);
+		std::partial_sort(candidates.begin(), candidates.begin() + occluderCount, candidates.end(), std::greater<>());
+
+		for (uint32_t i = 0; i < occluderCount; i++)
 		{
-			DrawComponent<LightSourceComponent>(entity, transform, m_Registry.get<LightSourceComponent>(entity->GetHandle()));
+			const RenderPacket::MeshDraw& occluder = packet.OpaqueMeshes[candidates[i].second];
+			m_OccluderFlags[candidates[i].second] = 1;
+			Renderer::SubmitOccluder(occluder.Transform, occluder.Mesh.Mesh);
 		}
+
+		Renderer::RasterizeOccluders();
 	}
 
-	void Scene::DrawSelectedEntity(std::vector<Entity*> entities)
+	void Scene::UpdateLODView(const glm::mat4& projection, const glm::vec3& cameraPosition)
 	{
-		Renderer::NextBatch();
+		m_LODView.Position        = cameraPosition;
+		m_LODView.ProjectionScale = projection[1][1];
+		m_LODView.IsOrthographic  = projection[3][3] == 1.0f;
+	}
 
-		for (Entity* entity : entities)
+	uint32_t Scene::SelectMeshLOD(entt::entity entityHandle, const MeshComponent& mesh, const glm::mat4& transform)
+	{
+		uint32_t lodCount = mesh.Mesh->GetLODCount();
+		if (lodCount == 1)
 		{
-			DrawEntity(entity);
+			return 0;
 		}
 
-		RenderCommand::SetStencilMask(0xFF);
-		Renderer::NextBatch();
-		RenderCommand::SetStencilMask(0x00);
+		// Bounding sphere diameter over viewport height
+		BoundingSphere sphere = mesh.Mesh->GetBoundingSphere().Transform(transform);
+		float screenSize = sphere.Radius * m_LODView.ProjectionScale;
+		if (!m_LODView.IsOrthographic)
+		{
+			screenSize /= glm::max(glm::length(sphere.Center - m_LODView.Position), 0.001f);
+		}
+
+		uint32_t& lod = m_Registry.get_or_emplace<MeshLODComponent>(entityHandle).LOD;
+		lod = glm::min(lod, lodCount - 1);
+
+		while (lod > 0 && screenSize > s_LODScreenSizes[lod - 1] * (1.0f + s_LODHysteresis))
+		{
+			lod--;
+		}
+
+		while (lod < lodCount - 1 && screenSize < s_LODScreenSizes[lod] * (1.0f - s_LODHysteresis))
+		{
+			lod++;
+		}
+
+		return lod;
 	}
 
-	void Scene::DrawSelectedEntityOutline(std::vector<Entity*> entities)
+	const glm::mat4& Scene::GetEntityTransform(Entity entity)
 	{
-		Renderer::NextBatch();
+		WorldTransformComponent& worldTransform = m_Registry.get<WorldTransformComponent>(entity.GetHandle());
+		if (worldTransform.IsDirty)
+		{
+			UpdateWorldTransform(entity);
+		}
 
-		for (Entity* entity : entities)
+		return worldTransform.Transform;
+	}
+
+	void Scene::MarkTransformDirty(Entity entity)
+	{
+		// A dirty entity's descendants are all dirty already
+		VisitSubtree(m_Registry, entity, [this](entt::entity entityHandle)
 		{
-			glm::mat4 transform = GetEntityTransform(entity);
-			glm::vec4 selectionColor = { 0.400f, 0.733f, 0.417f, 1.0f }; // TODO: Link to palette (selection green)
-		
-			if (entity->HasComponent<MeshComponent>())
+			WorldTransformComponent* worldTransform = m_Registry.try_get<WorldTransformComponent>(entityHandle);
+			if (worldTransform == nullptr || worldTransform->IsDirty)
 			{
-				Renderer::DrawMeshOutline(transform, m_Registry.get<MeshComponent>(entity->GetHandle()), selectionColor, (int)entity->GetHandle());
+				return false;
 			}
 
-			glm::vec3 scale = m_Registry.get<TransformComponent>(entity->GetHandle()).Scale;
-			float outlineSize = 0.1f;
-			transform = glm::scale(transform, glm::vec3(1.0f + outlineSize / scale.x, 1.0f + outlineSize / scale.y, 1.0f + outlineSize / scale.z));
+			worldTransform->IsDirty = true;
+			return true;
+		});
+
+		MarkBoundsDirty(entity);
+	}
+
+	void Scene::UpdateWorldTransforms()
+	{
+		ATLAS_PROFILE_FUNCTION();
 
-			if (entity->HasComponent<SpriteRendererComponent>())
+		// Local transforms are edited in place (panels, gizmos, serialization...), so changes are found by comparison
+		auto view = m_Registry.view<TransformComponent, WorldTransformComponent, RelationshipComponent>();
+		for (entt::entity entityHandle : view)
+		{
+			auto [transform, worldTransform] = view.get<TransformComponent, WorldTransformComponent>(entityHandle);
+			if (!worldTransform.IsDirty && !worldTransform.IsBuiltFrom(transform))
 			{
-				Renderer::DrawQuad(transform, selectionColor, (int)entity->GetHandle());
+				MarkTransformDirty({ entityHandle, this });
 			}
-			else if (entity->HasComponent<LightSourceComponent>())
+		}
+
+		// Dirty entities with a clean parent (or none) root the subtrees to rebuild
+		m_WorldTransformUpdates.clear();
+		for (entt::entity entityHandle : view)
+		{
+			auto [worldTransform, relationship] = view.get<WorldTransformComponent, RelationshipComponent>(entityHandle);
+			if (worldTransform.IsDirty && (relationship.Parent == entt::null || !m_Registry.get<WorldTransformComponent>(relationship.Parent).IsDirty))
 			{
-				Renderer::DrawCircle(transform, selectionColor, 0.1f, 0.0f, (int)entity->GetHandle());
+				VisitSubtree(m_Registry, entityHandle, [this](entt::entity entityHandle) { m_WorldTransformUpdates.push_back(entityHandle); return true; });
 			}
 		}
 
-		RenderCommand::SetStencilFunction(RendererAPI::TestFunction::NotEqual, 1, 0xFF);
-		Renderer::NextBatch();
-		RenderCommand::SetStencilFunction(RendererAPI::TestFunction::Always, 1, 0xFF);
+		RebuildWorldTransforms();
 	}
 
-	glm::mat4 Scene::GetEntityTransform(Entity* entity)
+	void Scene::UpdateWorldTransform(Entity entity)
 	{
-		glm::mat4 transform = m_Registry.get<TransformComponent>(entity->GetHandle()).GetTransform();
+		// Start from the topmost dirty ancestor, its parent (if any) is up to date
+		entt::entity root = entity;
+		entt::entity parent = m_Registry.get<RelationshipComponent>(root).Parent;
+		while (parent != entt::null && m_Registry.get<WorldTransformComponent>(parent).IsDirty)
+		{
+			root = parent;
+			parent = m_Registry.get<RelationshipComponent>(root).Parent;
+		}
+
+		m_WorldTransformUpdates.clear();
+		VisitSubtree(m_Registry, root, [this](entt::entity entityHandle) { m_WorldTransformUpdates.push_back(entityHandle); return true; });
+		RebuildWorldTransforms();
+	}
 
-		if (entity->GetParent() != nullptr)
+	void Scene::RebuildWorldTransforms()
+	{
+		// Local matrices in bulk first, then parent-first order makes every parent's world matrix ready for its children
+		m_LocalTransformBatch.Clear();
+		m_LocalTransformBatch.Reserve((uint32_t)m_WorldTransformUpdates.size());
+		for (entt::entity entityHandle : m_WorldTransformUpdates)
 		{
-			transform = GetEntityTransform(entity->GetParent()) * transform;
+			const TransformComponent& transform = m_Registry.get<TransformComponent>(entityHandle);
+			m_LocalTransformBatch.Add(transform.Translation, transform.Rotation, transform.Scale);
 		}
 
-		return transform;
+		m_LocalTransforms.resize(m_WorldTransformUpdates.size());
+		m_LocalTransformBatch.Compose(m_LocalTransforms.data());
+
+		for (size_t i = 0; i < m_WorldTransformUpdates.size(); i++)
+		{
+			entt::entity entityHandle = m_WorldTransformUpdates[i];
+			WorldTransformComponent& worldTransform = m_Registry.get<WorldTransformComponent>(entityHandle);
+			worldTransform.Local     = m_Registry.get<TransformComponent>(entityHandle);
+			worldTransform.Transform = m_LocalTransforms[i];
+			worldTransform.IsDirty   = false;
+
+			entt::entity parent = m_Registry.get<RelationshipComponent>(entityHandle).Parent;
+			if (parent != entt::null)
+			{
+				worldTransform.Transform = m_Registry.get<WorldTransformComponent>(parent).Transform * worldTransform.Transform;
+			}
+		}
 	}
 
 	////////////////////////////////////////////////////////////////////////////////////////
@@ -641,12 +1268,19 @@ namespace Atlas
 	////////////////////////////////////////////////////////////////////////////////////////
 
 	template<typename T>
-	void Scene::OnComponentAdded(Entity* entity, T& component)
+	void Scene::OnComponentAdded(Entity entity, T& component)
+	{
+	}
+
+	template<>
+	void Scene::OnComponentAdded<TransformComponent>(Entity entity, TransformComponent& component)
 	{
+		m_Registry.get_or_emplace<WorldTransformComponent>(entity.GetHandle());
+		MarkTransformDirty(entity);
 	}
 
 	template<>
-	void Scene::OnComponentAdded<CameraComponent>(Entity* entity, CameraComponent& component)
+	void Scene::OnComponentAdded<CameraComponent>(Entity entity, CameraComponent& component)
 	{
 		if (m_ViewportWidth > 0 && m_ViewportHeight > 0)
 		{
@@ -655,16 +1289,24 @@ namespace Atlas
 	}
 
 	template<>
-	void Scene::OnComponentAdded<MeshComponent>(Entity* entity, MeshComponent& component)
+	void Scene::OnComponentAdded<SpriteRendererComponent>(Entity entity, SpriteRendererComponent& component)
+	{
+		AddBoundsProxy(entity);
+	}
+
+	template<>
+	void Scene::OnComponentAdded<MeshComponent>(Entity entity, MeshComponent& component)
 	{
 		if (component.Mesh == nullptr)
 		{
 			component.Mesh = CreateRef<Mesh>();
 		}
+
+		AddBoundsProxy(entity);
 	}
 
 	template<>
-	void Scene::OnComponentAdded<MaterialComponent>(Entity* entity, MaterialComponent& component)
+	void Scene::OnComponentAdded<MaterialComponent>(Entity entity, MaterialComponent& component)
 	{
 		if (component.Material == nullptr)
 		{
@@ -673,7 +1315,7 @@ namespace Atlas
 	}
 
 	template<>
-	void Scene::OnComponentAdded<LightSourceComponent>(Entity* entity, LightSourceComponent& component)
+	void Scene::OnComponentAdded<LightSourceComponent>(Entity entity, LightSourceComponent& component)
 	{
 		if (component.Light == nullptr)
 		{
@@ -686,20 +1328,48 @@ namespace Atlas
 	////////////////////////////////////////////////////////////////////////////////////////
 
 	template<typename... Component>
-	void Scene::OnComponentRemoved(Entity* entity, ComponentGroup<Component...>)
+	void Scene::OnComponentRemoved(Entity entity, ComponentGroup<Component...>)
 	{
 		([&]()
 			{
-				if (entity->HasComponent<Component>())
+				if (entity.HasComponent<Component>())
 				{
-					OnComponentRemoved<Component>(entity, entity->GetComponent<Component>());
+					OnComponentRemoved<Component>(entity, entity.GetComponent<Component>());
 				}
 			}
 		(), ...);
 	}
 
 	template<typename T>
-	void Scene::OnComponentRemoved(Entity* entity, T& component)
+	void Scene::OnComponentRemoved(Entity entity, T& component)
 	{
 	}
+
+	template<>
+	void Scene::OnComponentRemoved<SpriteRendererComponent>(Entity entity, SpriteRendererComponent& component)
+	{
+		if (!entity.HasComponent<MeshComponent>())
+		{
+			RemoveBoundsProxy(entity);
+		}
+	}
+
+	template<>
+	void Scene::OnComponentRemoved<MeshComponent>(Entity entity, MeshComponent& component)
+	{
+		if (entity.HasComponent<MeshLODComponent>())
+		{
+			m_Registry.remove<MeshLODComponent>(entity.GetHandle());
+		}
+
+		if (!entity.HasComponent<SpriteRendererComponent>())
+		{
+			RemoveBoundsProxy(entity);
+		}
+		else
+		{
+			// Back to sprite bounds
+			MarkBoundsDirty(entity);
+		}
+	}
 }
\ No newline at end of file
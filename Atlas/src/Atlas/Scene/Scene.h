@@ -8,7 +8,12 @@
 #include "Atlas/Renderer/Light.h"
 #include "Atlas/Renderer/Cubemap.h"
 
+#include "Atlas/Math/Bounds.h"
+#include "Atlas/Math/DynamicAABBTree.h"
+#include "Atlas/Math/TransformBatch.h"
+
 #include "Atlas/Scene/Components.h"
+#include "Atlas/Scene/RenderPacket.h"
 
 #include "entt.hpp"
 
@@ -28,56 +33,119 @@ namespace Atlas
 		void OnRuntimeStart();
 		void OnRuntimeStop();
 
+		// Both build a render packet of the scene and draw it. With frame pipelining, the packet of the previous update is
+		// drawn instead, while this one is built on a worker: the picture is one frame late.
 		void OnUpdateRuntime(Timestep ts);
-		void OnUpdateEditor(Timestep ts, EditorCamera& camera, Entity* selectedEntity);
+		void OnUpdateEditor(Timestep ts, EditorCamera& camera, Entity selectedEntity);
 		void OnViewportResize(uint32_t width, uint32_t height);
-
-		Entity* CreateEntity(const std::string& name = std::string(), Entity* parent = nullptr);
-		Entity* CreateEntity(UUID uuid, const std::string& name = std::string(), Entity* parent = nullptr);
-		Entity* DuplicateEntity(Entity* entity, Entity* parent = nullptr);
-		void DestroyEntity(Entity* entity, bool isRoot = true);
+		// Drops the built packets, so the next update draws what it builds instead of an out of date frame. For when the
+		// scene was not updated for a while or switches between editor and runtime updates.
+		void InvalidateRenderPackets();
+
+		// Parents are taken as handles (entities convert to them) so they can default to none
+		Entity CreateEntity(const std::string& name = std::string(), entt::entity parent = entt::null);
+		Entity CreateEntity(UUID uuid, const std::string& name = std::string(), entt::entity parent = entt::null);
+		Entity DuplicateEntity(Entity entity, entt::entity parent = entt::null); // Defaults to the entity's parent
+		void DestroyEntity(Entity entity, bool isRoot = true);
 		void DestroyAllEntities();
-		Entity* GetEntity(UUID uuid);
-		Entity* GetEntity(entt::entity entityHandle);
-		glm::mat4 GetEntityTransform(Entity* entity);
+		Entity GetEntity(UUID uuid); // Null entity if there is none with this ID
+		Entity GetEntity(entt::entity entityHandle); // No lookup, only a validity check
+		uint32_t GetEntityCount() const { return (uint32_t)m_EntityUUIDMap.size(); }
+
+		// World transform, cached: rebuilt at the start of each scene update for the entities whose transform (or one
+		// of their ancestors') changed, or right away after MarkTransformDirty
+		const glm::mat4& GetEntityTransform(Entity entity);
+		// Flags the world transform of the entity and its children for a rebuild, and their bounds for a refit
+		void MarkTransformDirty(Entity entity);
+
+		// Queues the bounds of the entity and its children for a refit, needed after changing their transform or mesh.
+		// The selected entity is refreshed every editor update, so editor panels and gizmos don't have to.
+		void MarkBoundsDirty(Entity entity);
+
+		// Spatial queries on the bounds of meshes and sprites, in world space
+		std::vector<Entity> GetEntitiesInFrustum(const Frustum& frustum);
+		std::vector<Entity> GetEntitiesOverlapping(const AABB& box);
+		Entity Raycast(const Ray& ray, float maxDistance = FLT_MAX); // Closest entity whose bounds the ray hits
 
 		std::string const GetName() { return m_Name; }
-		Entity* GetPrimaryCamera();
-		void SetPrimaryCamera(Entity* entity);
-		std::vector<Entity*> GetCameras();
+		Entity GetPrimaryCamera();
+		void SetPrimaryCamera(Entity entity);
+		std::vector<Entity> GetCameras();
 
 	private:
-		void UpdateLights();
-		void DrawSceneDeferred(const glm::vec3& cameraPosition, bool isEditor, Entity* selectedEntity);
-		void DrawSceneForward(const glm::vec3& cameraPosition, bool isEditor, Entity* selectedEntity);
-		void DrawEntity(Entity* entity);
-		void DrawSelectedEntity(std::vector<Entity*> entities);
-		void DrawSelectedEntityOutline(std::vector<Entity*> entities);
-
-		template<typename T>
-		void DrawComponent(Entity* entity, const glm::mat4& transform, const T& component);
+		// Camera the mesh levels of detail are picked for
+		struct LODView
+		{
+			glm::vec3 Position = glm::vec3(0.0f);
+			float ProjectionScale = 1.0f; // Projection[1][1]: 1 / tan(fov / 2) in perspective, 2 / height in orthographic
+			bool IsOrthographic = false;
+		};
+
+		struct TransparentEntity
+		{
+			uint32_t DepthKey; // Inverted sortable view depth, the farthest entities come first
+			entt::entity Handle;
+		};
+
+		template<typename BuildFunction>
+		void BuildAndDrawRenderPacket(BuildFunction&& build);
+
+		// Building reads and updates the registry, drawing only reads the packet and calls the renderer
+		void BuildRenderPacket(RenderPacket& packet, const Frustum& frustum, bool isEditor, Entity selectedEntity);
+		void BuildDrawLists(RenderPacket& packet, const Frustum& frustum, bool isEditor);
+		RenderPacket::EntityDraw GetEntityDraw(entt::entity entityHandle);
+		void DrawRenderPacket(const RenderPacket& packet);
+		uint32_t DrawPacketDeferred(const RenderPacket& packet); // Returns the number of opaque meshes drawn
+		void DrawPacketForward(const RenderPacket& packet);
+		void SubmitOccluders(const RenderPacket& packet);
+
+		void UpdateWorldTransforms();
+		void UpdateWorldTransform(Entity entity); // Along with its dirty ancestors and their subtrees
+		void RebuildWorldTransforms();
+		void UpdateSelection(Entity selectedEntity);
+		void UpdateLights(std::vector<Renderer::LightData>& lights);
+		void UpdateVisibleEntities(const Frustum& frustum);
+		void UpdateBoundsTree();
+		void AddBoundsProxy(Entity entity);
+		void RemoveBoundsProxy(Entity entity);
+		AABB GetEntityBounds(Entity entity);
+		void UpdateLODView(const glm::mat4& projection, const glm::vec3& cameraPosition);
+		uint32_t SelectMeshLOD(entt::entity entityHandle, const MeshComponent& mesh, const glm::mat4& transform);
 
 		template<typename T>
-		void OnComponentAdded(Entity* entity, T& component);
+		void OnComponentAdded(Entity entity, T& component);
 
 		template<typename... Component>
-		void OnComponentRemoved(Entity* entity, ComponentGroup<Component...>);
+		void OnComponentRemoved(Entity entity, ComponentGroup<Component...>);
 
 		template<typename T>
-		void OnComponentRemoved(Entity* entity, T& component);
+		void OnComponentRemoved(Entity entity, T& component);
 
 		std::string m_Name;
 
 		entt::registry m_Registry;
-		std::unordered_map<UUID, Entity*> m_EntityUUIDMap;
-		std::unordered_map<entt::entity, Entity*> m_EntityHandleMap;
-		Entity* m_PrimaryCamera = nullptr;
+		std::unordered_map<UUID, entt::entity> m_EntityUUIDMap;
+		entt::entity m_PrimaryCamera = entt::null;
 
 		uint32_t m_ViewportWidth = 0;
 		uint32_t m_ViewportHeight = 0;
-		std::vector<Renderer::LightData> m_Lights;
 		Ref<Cubemap> m_Skybox;
 
+		DynamicAABBTree m_BoundsTree;                      // Meshes and sprites, user data is the entity handle
+		std::vector<entt::entity> m_DirtyBoundsEntities;
+		std::vector<entt::entity> m_WorldTransformUpdates; // Parents before their children
+		Math::TransformBatch m_LocalTransformBatch;
+		std::vector<glm::mat4> m_LocalTransforms;
+		std::vector<entt::entity> m_VisibleEntities;       // Frustum query result of the current update
+		std::vector<Entity> m_SelectedEntities;            // Tagged with SelectedComponent, parents before their children
+		LODView m_LODView;
+		std::vector<TransparentEntity> m_TransparentEntities;
+		std::vector<TransparentEntity> m_TransparentSortScratch;
+
+		RenderPacket m_RenderPackets[2];                   // Built and drawn in turns
+		uint32_t m_RenderPacketIndex = 0;                  // Next one to build
+		std::vector<uint8_t> m_OccluderFlags;              // Per opaque mesh of the packet being drawn
+
 		friend class Entity;
 		friend class SceneSerializer;
 		friend class SceneHierarchyPanel;
@@ -218,6 +218,7 @@ namespace Atlas
 			out << YAML::Key << "Color"     << YAML::Value << material->GetColor();
 			out << YAML::Key << "Metallic"  << YAML::Value << material->GetMetallic();
 			out << YAML::Key << "Roughness" << YAML::Value << material->GetRoughness();
+			out << YAML::Key << "Opacity"   << YAML::Value << material->GetOpacity();
 
 			auto& albedoTexture = material->GetAlbedoTexture();
 			if (albedoTexture)
@@ -343,13 +344,13 @@ namespace Atlas
 
 				ATLAS_CORE_TRACE("Deserialized entity with ID = {0}, name = {1}", uuid, name);
 
-				Entity* deserializedEntity = m_Scene->CreateEntity(uuid, name);
+				Entity deserializedEntity = m_Scene->CreateEntity(uuid, name);
 
 				auto transformComponent = entity["TransformComponent"];
 				if (transformComponent)
 				{
 					// Entities always have transforms
-					auto& tc = deserializedEntity->GetComponent<TransformComponent>();
+					auto& tc = deserializedEntity.GetComponent<TransformComponent>();
 
 					if (transformComponent["Translation"])
 					{
@@ -370,7 +371,7 @@ namespace Atlas
 				auto cameraComponent = entity["CameraComponent"];
 				if (cameraComponent)
 				{
-					auto& cc = deserializedEntity->AddComponent<CameraComponent>();
+					auto& cc = deserializedEntity.AddComponent<CameraComponent>();
 
 					auto& cameraProps = cameraComponent["Camera"];
 
@@ -418,7 +419,7 @@ namespace Atlas
 				auto spriteRendererComponent = entity["SpriteRendererComponent"];
 				if (spriteRendererComponent)
 				{
-					auto& src = deserializedEntity->AddComponent<SpriteRendererComponent>();
+					auto& src = deserializedEntity.AddComponent<SpriteRendererComponent>();
 					src.Type = (SpriteRendererComponent::RenderType)spriteRendererComponent["Type"].as<int>();
 					src.Color = spriteRendererComponent["Color"].as<glm::vec4>();
 					if (spriteRendererComponent["TexturePath"])
@@ -472,13 +473,13 @@ namespace Atlas
 				auto meshComponent = entity["MeshComponent"];
 				if (meshComponent)
 				{
-					auto& src = deserializedEntity->AddComponent<MeshComponent>();
+					auto& src = deserializedEntity.AddComponent<MeshComponent>();
 				}
 
 				auto materialComponent = entity["MaterialComponent"];
 				if (materialComponent)
 				{
-					auto& src = deserializedEntity->AddComponent<MaterialComponent>();
+					auto& src = deserializedEntity.AddComponent<MaterialComponent>();
 
 					if (materialComponent["Preset"])
 					{
@@ -500,6 +501,11 @@ namespace Atlas
 						src.Material->SetRoughness(materialComponent["Roughness"].as<float>());
 					}
 
+					if (materialComponent["Opacity"])
+					{
+						src.Material->SetOpacity(materialComponent["Opacity"].as<float>());
+					}
+
 					if (materialComponent["AlbedoTexturePath"])
 					{
 						std::string texturePath = materialComponent["AlbedoTexturePath"].as<std::string>();
@@ -546,7 +552,7 @@ namespace Atlas
 				auto lightSourceComponent = entity["LightSourceComponent"];
 				if (lightSourceComponent)
 				{
-					auto& src = deserializedEntity->AddComponent<LightSourceComponent>();
+					auto& src = deserializedEntity.AddComponent<LightSourceComponent>();
 
 					if (lightSourceComponent["CastType"])
 					{
@@ -1,8 +1,6 @@
 #include "atlaspch.h"
 #include "Platform/OpenGL/OpenGLBuffer.h"
 
-#include <glad/glad.h>
-
 namespace Atlas
 {
 	////////////////////////////////////////////////////////////////////////////////////////
@@ -54,19 +52,118 @@ namespace Atlas
 		glNamedBufferData(m_RendererID, size, data, data == nullptr ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
 	}
 
-	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
+	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
 	{
 		ATLAS_PROFILE_FUNCTION();
 
-		glNamedBufferSubData(m_RendererID, 0, size, data);
+		glNamedBufferSubData(m_RendererID, offset, size, data);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// StreamingBuffer /////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	OpenGLStreamingBuffer::OpenGLStreamingBuffer(uint32_t regionSize, uint32_t regionCount)
+		: m_RegionSize(regionSize), m_RegionFences(regionCount, nullptr)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		// Coherent: writes are visible to the GPU without flushing, fences only guard against overwriting pending data
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferStorage(m_RendererID, (GLsizeiptr)m_RegionSize * regionCount, nullptr, flags);
+		m_MappedData = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, (GLsizeiptr)m_RegionSize * regionCount, flags);
+
+		ATLAS_CORE_ASSERT(m_MappedData, "Could not map streaming buffer!");
+	}
+
+	OpenGLStreamingBuffer::~OpenGLStreamingBuffer()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		for (GLsync fence : m_RegionFences)
+		{
+			if (fence)
+			{
+				glDeleteSync(fence);
+			}
+		}
+
+		glUnmapNamedBuffer(m_RendererID);
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLStreamingBuffer::Bind() const
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+	}
+
+	void OpenGLStreamingBuffer::Unbind() const
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void OpenGLStreamingBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		ATLAS_CORE_ASSERT(offset + size <= m_RegionSize, "Data does not fit in a region!");
+		memcpy(m_MappedData + GetRegionOffset() + offset, data, size);
+	}
+
+	void* OpenGLStreamingBuffer::MapRegion()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		// A region nothing was drawn from can be filled again as is
+		if (m_RegionFences[m_Region])
+		{
+			m_Region = (m_Region + 1) % (uint32_t)m_RegionFences.size();
+		}
+
+		GLsync& fence = m_RegionFences[m_Region];
+		if (fence)
+		{
+			GLenum result = glClientWaitSync(fence, 0, 0);
+			while (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+			{
+				ATLAS_PROFILE_SCOPE("OpenGLStreamingBuffer::MapRegion - Wait for GPU");
+
+				ATLAS_CORE_ASSERT(result != GL_WAIT_FAILED, "Waiting on a streaming buffer fence failed!");
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+			}
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		return m_MappedData + GetRegionOffset();
+	}
+
+	void OpenGLStreamingBuffer::FenceRegion()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		GLsync& fence = m_RegionFences[m_Region];
+		if (fence)
+		{
+			glDeleteSync(fence);
+		}
+
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////////////
 	// IndexBuffer /////////////////////////////////////////////////////////////////////////
 	////////////////////////////////////////////////////////////////////////////////////////
 
-	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t size)
-		: m_MaxCount(size / sizeof(uint32_t))
+	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t size, IndexType type)
+		: m_MaxCount(size / IndexTypeSize(type)), m_IndexType(type)
 	{
 		ATLAS_PROFILE_FUNCTION();
 
@@ -74,8 +171,8 @@ namespace Atlas
 		Initialize(nullptr, size);
 	}
 
-	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t size)
-		: m_MaxCount(size / sizeof(uint32_t))
+	OpenGLIndexBuffer::OpenGLIndexBuffer(const void* indices, uint32_t size, IndexType type)
+		: m_MaxCount(size / IndexTypeSize(type)), m_IndexType(type)
 	{
 		ATLAS_PROFILE_FUNCTION();
 
@@ -112,10 +209,51 @@ namespace Atlas
 		glNamedBufferData(m_RendererID, size, data, data == nullptr ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
 	}
 
-	void OpenGLIndexBuffer::SetData(const void* data, uint32_t size)
+	void OpenGLIndexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glNamedBufferSubData(m_RendererID, offset, size, data);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// IndirectBuffer //////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	OpenGLIndirectBuffer::OpenGLIndirectBuffer(uint32_t size)
+		: m_MaxCount(size / sizeof(DrawIndexedIndirectCommand))
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	OpenGLIndirectBuffer::~OpenGLIndirectBuffer()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::Bind() const
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::Unbind() const
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	void OpenGLIndirectBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
 	{
 		ATLAS_PROFILE_FUNCTION();
 
-		glNamedBufferSubData(m_RendererID, 0, size, data);
+		glNamedBufferSubData(m_RendererID, offset, size, data);
 	}
 }
\ No newline at end of file
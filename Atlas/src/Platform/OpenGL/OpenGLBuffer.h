@@ -2,6 +2,8 @@
 
 #include "Atlas/Renderer/Buffer.h"
 
+#include <glad/glad.h>
+
 namespace Atlas
 {
 	class OpenGLVertexBuffer : public VertexBuffer
@@ -14,7 +16,7 @@ namespace Atlas
 		virtual void Bind() const override;
 		virtual void Unbind() const override;
 
-		virtual void SetData(const void* data, uint32_t size) override;
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
 
 		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
 
@@ -27,24 +29,75 @@ namespace Atlas
 		BufferLayout m_Layout;
 	};
 
+	class OpenGLStreamingBuffer : public StreamingBuffer
+	{
+	public:
+		OpenGLStreamingBuffer(uint32_t regionSize, uint32_t regionCount);
+		virtual ~OpenGLStreamingBuffer();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		// Copies into the current region
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+
+		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+
+		virtual void* MapRegion() override;
+		virtual void FenceRegion() override;
+
+		virtual uint32_t GetRegionOffset() const override { return m_Region * m_RegionSize; }
+		virtual uint32_t GetRegionSize() const override { return m_RegionSize; }
+
+	private:
+		uint32_t m_RendererID;
+		BufferLayout m_Layout;
+
+		uint32_t m_RegionSize;
+		uint32_t m_Region = 0;
+		uint8_t* m_MappedData = nullptr;
+		std::vector<GLsync> m_RegionFences; // nullptr while a region is not read by pending draws
+	};
+
 	class OpenGLIndexBuffer : public IndexBuffer
 	{
 	public:
-		OpenGLIndexBuffer(uint32_t size);
-		OpenGLIndexBuffer(uint32_t* indices, uint32_t size);
+		OpenGLIndexBuffer(uint32_t size, IndexType type);
+		OpenGLIndexBuffer(const void* indices, uint32_t size, IndexType type);
 		virtual ~OpenGLIndexBuffer();
 
 		virtual void Bind() const override;
 		virtual void Unbind() const override;
 
-		virtual void SetData(const void* data, uint32_t size) override;
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
 
 		virtual uint32_t GetMaxCount() const override { return m_MaxCount; }
+		virtual IndexType GetIndexType() const override { return m_IndexType; }
 
 	private:
 		void Initialize(const void* data, uint32_t size);
 
 		uint32_t m_RendererID;
 		uint32_t m_MaxCount;
+		IndexType m_IndexType;
+	};
+
+	class OpenGLIndirectBuffer : public IndirectBuffer
+	{
+	public:
+		OpenGLIndirectBuffer(uint32_t size);
+		virtual ~OpenGLIndirectBuffer();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+
+		virtual uint32_t GetMaxCount() const override { return m_MaxCount; }
+
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_MaxCount;
 	};
 }
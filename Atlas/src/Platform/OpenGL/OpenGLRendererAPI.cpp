@@ -7,6 +7,18 @@ namespace Atlas
 {
 	namespace Utils
 	{
+		static GLenum IndexTypeToGLenum(IndexType type)
+		{
+			switch (type)
+			{
+			case IndexType::UInt16: return GL_UNSIGNED_SHORT;
+			case IndexType::UInt32: return GL_UNSIGNED_INT;
+			}
+
+			ATLAS_CORE_ASSERT(false, "Unknown index type!");
+			return 0;
+		}
+
 		static GLenum PolygonModeToGLenum(const RendererAPI::PolygonMode& mode)
 		{
 			switch (mode)
@@ -118,6 +130,22 @@ namespace Atlas
 		glDisable(GL_DEPTH_TEST);
 	}
 
+	void OpenGLRendererAPI::SetDepthFunction(const TestFunction& function)
+	{
+		glDepthFunc(Utils::TestFunctionToGLenum(function));
+	}
+
+	void OpenGLRendererAPI::SetDepthMask(bool isWritable)
+	{
+		glDepthMask(isWritable ? GL_TRUE : GL_FALSE);
+	}
+
+	void OpenGLRendererAPI::SetColorMask(bool isWritable)
+	{
+		GLboolean mask = isWritable ? GL_TRUE : GL_FALSE;
+		glColorMask(mask, mask, mask, mask);
+	}
+
 	void OpenGLRendererAPI::SetStencilMask(const uint32_t& mask)
 	{
 		glStencilMask(mask);
@@ -168,16 +196,31 @@ namespace Atlas
 		glClear(GL_DEPTH_BUFFER_BIT);
 	}
 
-	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
+	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t baseVertex)
+	{
+		vertexArray->Bind();
+		const Ref<IndexBuffer>& indexBuffer = vertexArray->GetIndexBuffer();
+		glDrawElementsBaseVertex(GL_TRIANGLES, indexCount ? indexCount : indexBuffer->GetMaxCount(), Utils::IndexTypeToGLenum(indexBuffer->GetIndexType()), nullptr, baseVertex);
+	}
+
+	void OpenGLRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t instanceCount, uint32_t indexCount)
+	{
+		vertexArray->Bind();
+		const Ref<IndexBuffer>& indexBuffer = vertexArray->GetIndexBuffer();
+		glDrawElementsInstanced(GL_TRIANGLES, indexCount ? indexCount : indexBuffer->GetMaxCount(), Utils::IndexTypeToGLenum(indexBuffer->GetIndexType()), nullptr, instanceCount);
+	}
+
+	void OpenGLRendererAPI::MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t offset)
 	{
 		vertexArray->Bind();
-		glDrawElements(GL_TRIANGLES, indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetMaxCount(), GL_UNSIGNED_INT, nullptr);
+		indirectBuffer->Bind();
+		glMultiDrawElementsIndirect(GL_TRIANGLES, Utils::IndexTypeToGLenum(vertexArray->GetIndexBuffer()->GetIndexType()), (const void*)(uintptr_t)offset, drawCount, 0);
 	}
 
-	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex)
 	{
 		vertexArray->Bind();
-		glDrawArrays(GL_LINES, 0, vertexCount);
+		glDrawArrays(GL_LINES, firstVertex, vertexCount);
 	}
 
 	void OpenGLRendererAPI::BindTextureSlot(uint32_t slot, uint32_t rendererID)
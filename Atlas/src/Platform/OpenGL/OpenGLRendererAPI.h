@@ -12,6 +12,9 @@ namespace Atlas
 		
 		virtual void EnableDepthTest() override;
 		virtual void DisableDepthTest() override;
+		virtual void SetDepthFunction(const TestFunction& function) override;
+		virtual void SetDepthMask(bool isWritable) override;
+		virtual void SetColorMask(bool isWritable) override;
 		virtual void SetStencilMask(const uint32_t& mask) override;
 		virtual void SetStencilFunction(const TestFunction& function, const int& reference, const uint32_t& mask) override;
 
@@ -25,8 +28,10 @@ namespace Atlas
 		virtual void ClearColor() override;
 		virtual void ClearDepth() override;
 
-		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t baseVertex = 0) override;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t instanceCount, uint32_t indexCount = 0) override;
+		virtual void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer, uint32_t drawCount, uint32_t offset = 0) override;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0) override;
 
 		virtual void BindTextureSlot(uint32_t slot, uint32_t rendererID) override;
 
@@ -319,6 +319,11 @@ namespace Atlas
 			else
 			{
 				spirv_cross::CompilerGLSL glslCompiler(spirv);
+				// Instanced draws never use a base instance: map gl_InstanceIndex straight to gl_InstanceID
+				// instead of emitting a loose (non-block) SPIRV_Cross_BaseInstance uniform
+				spirv_cross::CompilerGLSL::Options glslOptions = glslCompiler.get_common_options();
+				glslOptions.vertex.support_nonzero_base_instance = false;
+				glslCompiler.set_common_options(glslOptions);
 				m_OpenGLSourceCode[stage] = glslCompiler.compile();
 				auto& source = m_OpenGLSourceCode[stage];
 
@@ -72,6 +72,25 @@ namespace Atlas
 			ATLAS_CORE_ASSERT(false);
 			return 0;
 		}
+
+		static void SetTextureParameters(uint32_t rendererID, const TextureSpecification& specification)
+		{
+			GLenum minFilter = AtlasResizeFilterToGLInt(specification.MinFilter);
+			if (specification.GenerateMips)
+			{
+				switch (minFilter)
+				{
+				case GL_LINEAR:  minFilter = GL_LINEAR_MIPMAP_LINEAR;  break;
+				case GL_NEAREST: minFilter = GL_NEAREST_MIPMAP_LINEAR; break;
+				}
+			}
+
+			glTextureParameteri(rendererID, GL_TEXTURE_MIN_FILTER, minFilter);
+			glTextureParameteri(rendererID, GL_TEXTURE_MAG_FILTER, AtlasResizeFilterToGLInt(specification.MagFilter));
+
+			glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, AtlasWrapToGLInt(specification.WrapS));
+			glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, AtlasWrapToGLInt(specification.WrapT));
+		}
 	}
 
 	OpenGLTexture2D::OpenGLTexture2D(const TextureSpecification& specification)
@@ -180,20 +199,74 @@ namespace Atlas
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
 		glTextureStorage2D(m_RendererID, 1, m_InternalFormat, m_Specification.Width, m_Specification.Height);
 
-		GLenum minFilter = Utils::AtlasResizeFilterToGLInt(m_Specification.MinFilter);
-		if (m_Specification.GenerateMips)
+		Utils::SetTextureParameters(m_RendererID, m_Specification);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// OpenGLTexture2DArray ////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////
+
+	OpenGLTexture2DArray::OpenGLTexture2DArray(const TextureSpecification& specification, uint32_t layerCount)
+		: m_Specification(specification), m_LayerCount(layerCount)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		m_InternalFormat = Utils::AtlasImageFormatToGLInternalFormat(m_Specification.Format);
+		m_DataFormat = Utils::AtlasImageFormatToGLDataFormat(m_Specification.Format);
+
+		// Same single level as OpenGLTexture2D, so layers can be copied from it as is
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_RendererID);
+		glTextureStorage3D(m_RendererID, 1, m_InternalFormat, m_Specification.Width, m_Specification.Height, m_LayerCount);
+
+		Utils::SetTextureParameters(m_RendererID, m_Specification);
+	}
+
+	OpenGLTexture2DArray::~OpenGLTexture2DArray()
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glDeleteTextures(1, &m_RendererID);
+	}
+
+	void OpenGLTexture2DArray::SetData(void* data, uint32_t size)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		glTextureSubImage3D(m_RendererID, 0, 0, 0, 0, m_Specification.Width, m_Specification.Height, m_LayerCount, m_DataFormat, GL_UNSIGNED_BYTE, data);
+	}
+
+	void OpenGLTexture2DArray::CopyLayer(const Ref<Texture2D>& texture, uint32_t layer)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		ATLAS_CORE_ASSERT(layer < m_LayerCount, "Layer out of range!");
+		ATLAS_CORE_ASSERT(texture->GetWidth() == m_Specification.Width && texture->GetHeight() == m_Specification.Height
+			&& texture->GetSpecification().Format == m_Specification.Format, "Texture does not match the array!");
+
+		glCopyImageSubData(texture->GetRendererID(), GL_TEXTURE_2D, 0, 0, 0, 0,
+			m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer,
+			m_Specification.Width, m_Specification.Height, 1);
+	}
+
+	void OpenGLTexture2DArray::CopyLayers(const Ref<Texture2DArray>& source)
+	{
+		ATLAS_PROFILE_FUNCTION();
+
+		uint32_t layerCount = std::min(m_LayerCount, source->GetLayerCount());
+		if (layerCount == 0)
 		{
-			switch (minFilter)
-			{
-			case GL_LINEAR:  minFilter = GL_LINEAR_MIPMAP_LINEAR;  break;
-			case GL_NEAREST: minFilter = GL_NEAREST_MIPMAP_LINEAR; break;
-			}
+			return;
 		}
 
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, minFilter);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, Utils::AtlasResizeFilterToGLInt(m_Specification.MagFilter));
+		glCopyImageSubData(source->GetRendererID(), GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			m_Specification.Width, m_Specification.Height, layerCount);
+	}
+
+	void OpenGLTexture2DArray::Bind(uint32_t slot) const
+	{
+		ATLAS_PROFILE_FUNCTION();
 
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, Utils::AtlasWrapToGLInt(m_Specification.WrapS));
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, Utils::AtlasWrapToGLInt(m_Specification.WrapT));
+		glBindTextureUnit(slot, m_RendererID);
 	}
 }
\ No newline at end of file
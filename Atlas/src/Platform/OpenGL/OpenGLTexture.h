@@ -41,4 +41,41 @@ namespace Atlas
 		uint32_t m_RendererID;
 		GLenum m_InternalFormat, m_DataFormat;
 	};
+
+	class OpenGLTexture2DArray : public Texture2DArray
+	{
+	public:
+		OpenGLTexture2DArray(const TextureSpecification& specification, uint32_t layerCount);
+		virtual ~OpenGLTexture2DArray();
+
+		virtual const TextureSpecification& GetSpecification() const override { return m_Specification; }
+
+		virtual uint32_t GetWidth() const override { return m_Specification.Width; }
+		virtual uint32_t GetHeight() const override { return m_Specification.Height; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+		virtual const std::filesystem::path& GetPath() const override { return m_Path; }
+		virtual uint32_t GetLayerCount() const override { return m_LayerCount; }
+
+		// Data must cover every layer
+		virtual void SetData(void* data, uint32_t size) override;
+		virtual void CopyLayer(const Ref<Texture2D>& texture, uint32_t layer) override;
+		virtual void CopyLayers(const Ref<Texture2DArray>& source) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual bool IsLoaded() const override { return true; }
+
+		virtual bool operator==(const Texture& other) const override
+		{
+			return m_RendererID == other.GetRendererID();
+		};
+
+	private:
+		TextureSpecification m_Specification;
+		uint32_t m_LayerCount;
+
+		std::filesystem::path m_Path; // Not loaded from disk
+		uint32_t m_RendererID;
+		GLenum m_InternalFormat, m_DataFormat;
+	};
 }
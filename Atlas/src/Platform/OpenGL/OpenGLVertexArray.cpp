@@ -21,6 +21,9 @@ namespace Atlas
 			case ShaderDataType::Int3:     return GL_INT;
 			case ShaderDataType::Int4:     return GL_INT;
 			case ShaderDataType::Bool:     return GL_BOOL;
+			case ShaderDataType::UShort4:  return GL_UNSIGNED_SHORT;
+			case ShaderDataType::Short2:   return GL_SHORT;
+			case ShaderDataType::Half2:    return GL_HALF_FLOAT;
 		}
 
 		ATLAS_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -55,7 +58,7 @@ namespace Atlas
 		glBindVertexArray(0);
 	}
 
-	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, bool instanced)
 	{
 		ATLAS_PROFILE_FUNCTION();
 
@@ -73,6 +76,9 @@ namespace Atlas
 			case ShaderDataType::Float2:
 			case ShaderDataType::Float3:
 			case ShaderDataType::Float4:
+			case ShaderDataType::UShort4:
+			case ShaderDataType::Short2:
+			case ShaderDataType::Half2:
 			{
 				glEnableVertexAttribArray(m_VertexBufferIndex);
 				glVertexAttribPointer(m_VertexBufferIndex,
@@ -81,6 +87,7 @@ namespace Atlas
 					element.Normalized ? GL_TRUE : GL_FALSE,
 					layout.GetStride(),
 					(const void*)element.Offset);
+				glVertexAttribDivisor(m_VertexBufferIndex, instanced ? 1 : 0);
 				m_VertexBufferIndex++;
 				break;
 			}
@@ -97,6 +104,7 @@ namespace Atlas
 					ShaderDataTypeToOpenGLBaseType(element.Type),
 					layout.GetStride(),
 					(const void*)element.Offset);
+				glVertexAttribDivisor(m_VertexBufferIndex, instanced ? 1 : 0);
 				m_VertexBufferIndex++;
 				break;
 			}